@@ -21,10 +21,37 @@ order_t get_order(const nlohmann::json& config, const std::string& field, const
     return default_order;
 }
 
+size_t get_quadrature_order(const nlohmann::json& config, const std::string& field, const std::string& path) {
+    if (!config.contains(field))
+        return 0;
+    if (const nlohmann::json& value = config[field]; value.is_number_unsigned())
+        if (const size_t order = value.get<size_t>(); is_valid_order(order))
+            return order;
+    throw std::domain_error{"The quadrature order \"" + path + field + "\" must be an integer from 1 to 5."};
+}
+
 }
 
 namespace nonlocal::config {
 
+quadrature_orders_data::quadrature_orders_data(const nlohmann::json& config, const std::string& path)
+    : local{get_quadrature_order(config, "local", path)}
+    , nonlocal_outer{get_quadrature_order(config, "nonlocal_outer", path)}
+    , nonlocal_inner{get_quadrature_order(config, "nonlocal_inner", path)} {
+    check_optional_fields(config, {"local", "nonlocal_outer", "nonlocal_inner"}, path);
+}
+
+quadrature_orders_data::operator nlohmann::json() const {
+    nlohmann::json result = nlohmann::json::object();
+    if (local)
+        result["local"] = local;
+    if (nonlocal_outer)
+        result["nonlocal_outer"] = nonlocal_outer;
+    if (nonlocal_inner)
+        result["nonlocal_inner"] = nonlocal_inner;
+    return result;
+}
+
 mesh_data<1u>::mesh_data(const nlohmann::json& config, const std::string& path)
     : element_order{get_order(config, "element_order")}
     , quadrature_order{get_order(config, "quadrature_order", element_order)} {
@@ -3,6 +3,8 @@
 
 #include "config_utils.hpp"
 
+#include <unordered_map>
+
 namespace nonlocal::config {
 
 enum class order_t : uint8_t {
@@ -23,18 +25,51 @@ NLOHMANN_JSON_SERIALIZE_ENUM(order_t, {
     {order_t::QUINTIC, "quintic"}
 })
 
+// The orders of the quadratures of the element type. For the quadrilaterals the order is the number of the Gauss nodes
+// in each direction, for the triangles it is the degree of the Dunavant quadrature. Zero order means the default quadrature.
+struct quadrature_orders_data final {
+    size_t local = 0;
+    size_t nonlocal_outer = 0;
+    size_t nonlocal_inner = 0;
+
+    explicit constexpr quadrature_orders_data() noexcept = default;
+    explicit quadrature_orders_data(const nlohmann::json& config, const std::string& path = {});
+
+    operator nlohmann::json() const;
+};
+
 template<size_t Dimension>
 struct mesh_data final {
     std::filesystem::path path; // required
+    std::unordered_map<std::string, quadrature_orders_data> quadratures; // element type name -> orders
+    bool physical_gradients = false; // Precompute the physical gradients and the weighted Jacobians in addition to the derivatives
+    bool reduced_precision = false;  // Store the precomputed tables and the quadrature neighbours in float
+    bool validate_precision = false; // Compare the matrices assembled with the full and reduced precision tables
 
     explicit mesh_data() = default;
     explicit mesh_data(const nlohmann::json& config, const std::string& config_path = {}) {
-        check_required_fields(config, { "path" }, append_access_sign(config_path));
+        const std::string path_with_access = append_access_sign(config_path);
+        check_required_fields(config, { "path" }, path_with_access);
+        check_optional_fields(config, { "quadratures", "physical_gradients", "reduced_precision", "validate_precision" }, path_with_access);
         path = config["path"].get<std::string>();
+        physical_gradients = config.value("physical_gradients", false);
+        reduced_precision = config.value("reduced_precision", false);
+        validate_precision = config.value("validate_precision", false);
+        if (config.contains("quadratures"))
+            for(const auto& [name, orders] : config["quadratures"].items())
+                quadratures.emplace(name, quadrature_orders_data{orders, append_access_sign(path_with_access + "quadratures." + name)});
     }
 
     operator nlohmann::json() const {
-        return { {"path", path.string()} };
+        nlohmann::json result = {
+            {"path", path.string()},
+            {"physical_gradients", physical_gradients},
+            {"reduced_precision", reduced_precision},
+            {"validate_precision", validate_precision}
+        };
+        for(const auto& [name, orders] : quadratures)
+            result["quadratures"][name] = nlohmann::json(orders);
+        return result;
     }
 };
 
@@ -5,10 +5,25 @@
 
 #include <type_traits>
 #include <array>
+#include <cmath>
 #include <ranges>
 
 namespace nonlocal::config {
 
+enum class influence_t : uint8_t {
+    UNKNOWN,
+    CONSTANT,
+    POLYNOMIAL,
+    NORMAL_DISTRIBUTION
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(influence_t, {
+    {influence_t::UNKNOWN, nullptr},
+    {influence_t::CONSTANT, "constant"},
+    {influence_t::POLYNOMIAL, "polynomial"},
+    {influence_t::NORMAL_DISTRIBUTION, "normal_distribution"}
+})
+
 template<std::floating_point T, size_t Dimension>
 class model_data final {
     using radius_t = std::conditional_t<Dimension == 1, T, std::array<T, Dimension>>;
@@ -33,25 +48,55 @@ public:
     T local_weight = T{1};             // required
     radius_t nonlocal_radius = {T{0}}; // required
     radius_t search_radius = {T{0}};   // if skipped sets equal nonlocal_radius
+    influence_t influence = influence_t::POLYNOMIAL;
+    T quadrature_tolerance = T{0};     // relative influence variation, which allows reduced nonlocal quadratures
+    T truncation_tolerance = T{0};     // tail mass of the normal distribution, which is truncated and dropped
 
     explicit constexpr model_data() noexcept = default;
     explicit model_data(const nlohmann::json& config, const std::string& path = {}) {
         const std::string path_with_access = append_access_sign(path);
         check_required_fields(config, { "local_weight", "nonlocal_radius" }, path_with_access);
-        check_optional_fields(config, {"search_radius"}, path_with_access);
+        check_optional_fields(config, {"search_radius", "influence", "quadrature_tolerance", "truncation_tolerance"}, path_with_access);
         local_weight = config["local_weight"].get<T>();
         nonlocal_radius = read_radius(config["nonlocal_radius"], "nonlocal_radius");
-        search_radius = !config.contains("search_radius") ? nonlocal_radius :
-                        read_radius(config["search_radius"], "search_radius");
+        influence = config.value("influence", influence_t::POLYNOMIAL);
+        if (influence == influence_t::UNKNOWN)
+            throw std::domain_error{"Unknown influence function type in the field \"" + path_with_access + "influence\""};
+        quadrature_tolerance = config.value("quadrature_tolerance", T{0});
+        if (quadrature_tolerance < T{0})
+            throw std::domain_error{"Field \"" + path_with_access + "quadrature_tolerance\" must be non-negative"};
+        truncation_tolerance = config.value("truncation_tolerance", T{0});
+        if (truncation_tolerance < T{0} || truncation_tolerance >= T{1})
+            throw std::domain_error{"Field \"" + path_with_access + "truncation_tolerance\" must be in the range [0, 1)"};
+        search_radius = config.contains("search_radius") ? read_radius(config["search_radius"], "search_radius") :
+                        influence == influence_t::NORMAL_DISTRIBUTION && truncation_tolerance > T{0} ? truncation_radius() :
+                        nonlocal_radius;
     }
 
     operator nlohmann::json() const {
         return {
             {"local_weight", local_weight},
             {"nonlocal_radius", nonlocal_radius},
-            {"search_radius", search_radius}
+            {"search_radius", search_radius},
+            {"influence", influence},
+            {"quadrature_tolerance", quadrature_tolerance},
+            {"truncation_tolerance", truncation_tolerance}
         };
     }
+
+    // The tail mass of the normal distribution beyond the ellipse with the semi-axes rho * nonlocal_radius
+    // is equal to exp(-rho^2 / 2), so the minimal search radius is derived from the truncation tolerance
+    radius_t truncation_radius() const {
+        const T factor = std::sqrt(-2 * std::log(truncation_tolerance));
+        if constexpr (std::is_same_v<radius_t, T>)
+            return factor * nonlocal_radius;
+        else {
+            radius_t result = nonlocal_radius;
+            for(T& radius : result)
+                radius *= factor;
+            return result;
+        }
+    }
 };
 
 }
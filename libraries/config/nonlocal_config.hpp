@@ -5,6 +5,7 @@
 #include "save_data.hpp"
 #include "mesh_data.hpp"
 #include "time_data.hpp"
+#include "solver_data.hpp"
 #include "thermal_auxiliary_data.hpp"
 #include "boundaries_conditions_data.hpp"
 #include "thermal_boundary_condition_data.hpp"
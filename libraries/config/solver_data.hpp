@@ -0,0 +1,128 @@
+#ifndef NONLOCAL_CONFIG_SOLVER_DATA_HPP
+#define NONLOCAL_CONFIG_SOLVER_DATA_HPP
+
+#include "config_utils.hpp"
+
+#include <filesystem>
+#include <optional>
+
+namespace nonlocal::config {
+
+template<std::floating_point T>
+struct hierarchical_data final {
+    T tolerance = T{1e-6};     // Relative accuracy of the far-field blocks approximation
+    T admissibility = T{2};    // Blocks with min(diam) <= admissibility * distance are approximated
+    uint64_t leaf_size = 32;   // Maximum number of elements in the cluster tree leaves
+
+    explicit constexpr hierarchical_data() noexcept = default;
+    explicit hierarchical_data(const nlohmann::json& config, const std::string& path = {}) {
+        check_optional_fields(config, {"tolerance", "admissibility", "leaf_size"}, append_access_sign(path));
+        tolerance = config.value("tolerance", T{1e-6});
+        admissibility = config.value("admissibility", T{2});
+        leaf_size = config.value("leaf_size", uint64_t{32});
+    }
+
+    operator nlohmann::json() const {
+        return {
+            {"tolerance", tolerance},
+            {"admissibility", admissibility},
+            {"leaf_size", leaf_size}
+        };
+    }
+};
+
+// The costs are specified in nanoseconds, the calibrated costs of the problem are used if they are missing
+template<std::floating_point T>
+struct dry_run_data final {
+    std::optional<T> evaluation_cost; // Per the pair of the quadrature nodes of the neighbour elements
+    std::optional<T> nonzero_cost;    // Per the non-zero element of the matrix
+
+    explicit constexpr dry_run_data() noexcept = default;
+    explicit dry_run_data(const nlohmann::json& config, const std::string& path = {}) {
+        check_optional_fields(config, {"evaluation_cost", "nonzero_cost"}, append_access_sign(path));
+        if (config.contains("evaluation_cost"))
+            evaluation_cost = config["evaluation_cost"].get<T>();
+        if (config.contains("nonzero_cost"))
+            nonzero_cost = config["nonzero_cost"].get<T>();
+    }
+
+    operator nlohmann::json() const {
+        nlohmann::json result = nlohmann::json::object();
+        if (evaluation_cost)
+            result["evaluation_cost"] = *evaluation_cost;
+        if (nonzero_cost)
+            result["nonzero_cost"] = *nonzero_cost;
+        return result;
+    }
+};
+
+// The stiffness matrix is written to the file after the assembly and is streamed from it by the blocks of rows during the solution
+struct out_of_core_data final {
+    std::filesystem::path path; // required
+    uint64_t block_size = 64;   // In megabytes
+
+    explicit out_of_core_data() = default;
+    explicit out_of_core_data(const nlohmann::json& config, const std::string& config_path = {}) {
+        const std::string path_with_access = append_access_sign(config_path);
+        check_required_fields(config, {"path"}, path_with_access);
+        check_optional_fields(config, {"block_size"}, path_with_access);
+        path = config["path"].get<std::string>();
+        block_size = config.value("block_size", uint64_t{64});
+    }
+
+    operator nlohmann::json() const {
+        return {
+            {"path", path.string()},
+            {"block_size", block_size}
+        };
+    }
+};
+
+template<std::floating_point T>
+struct solver_data final {
+    std::optional<hierarchical_data<T>> hierarchical; // Matrix-free nonlocal operator if specified
+    bool quadrature_neighbours = false;               // Precompute influence in interacting quadrature nodes
+    std::optional<dry_run_data<T>> dry_run;           // Only the assembly is planned if specified
+    bool bind_threads = false;                        // Bind the threads to the processors before the mesh is read
+    bool block_sparse = false;                        // Store the stiffness matrix by the blocks 2x2 for the solution
+    std::optional<T> sliced_ellpack_padding;          // Use SELL-C-sigma in the conjugate gradient if its padding is not greater
+    bool compressed_indices = false;                  // Decode the columns from the deltas in the conjugate gradient
+    std::optional<out_of_core_data> out_of_core;      // Solve with the stiffness matrix stored in the file if specified
+
+    explicit constexpr solver_data() noexcept = default;
+    explicit solver_data(const nlohmann::json& config, const std::string& path = {}) {
+        const std::string path_with_access = append_access_sign(path);
+        check_optional_fields(config, {"hierarchical", "quadrature_neighbours", "dry_run", "bind_threads", "block_sparse", "sliced_ellpack_padding", "compressed_indices",
+                                       "out_of_core"}, path_with_access);
+        if (config.contains("hierarchical"))
+            hierarchical = hierarchical_data<T>{config["hierarchical"], path_with_access + "hierarchical"};
+        quadrature_neighbours = config.value("quadrature_neighbours", false);
+        if (config.contains("dry_run"))
+            dry_run = dry_run_data<T>{config["dry_run"], path_with_access + "dry_run"};
+        bind_threads = config.value("bind_threads", false);
+        block_sparse = config.value("block_sparse", false);
+        if (config.contains("sliced_ellpack_padding"))
+            sliced_ellpack_padding = config["sliced_ellpack_padding"].get<T>();
+        compressed_indices = config.value("compressed_indices", false);
+        if (config.contains("out_of_core"))
+            out_of_core = out_of_core_data{config["out_of_core"], path_with_access + "out_of_core"};
+    }
+
+    operator nlohmann::json() const {
+        nlohmann::json result = {{"quadrature_neighbours", quadrature_neighbours}, {"bind_threads", bind_threads},
+                                 {"block_sparse", block_sparse}, {"compressed_indices", compressed_indices}};
+        if (hierarchical)
+            result["hierarchical"] = *hierarchical;
+        if (dry_run)
+            result["dry_run"] = *dry_run;
+        if (sliced_ellpack_padding)
+            result["sliced_ellpack_padding"] = *sliced_ellpack_padding;
+        if (out_of_core)
+            result["out_of_core"] = *out_of_core;
+        return result;
+    }
+};
+
+}
+
+#endif
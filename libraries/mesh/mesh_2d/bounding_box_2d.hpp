@@ -0,0 +1,81 @@
+#ifndef NONLOCAL_BOUNDING_BOX_2D_HPP
+#define NONLOCAL_BOUNDING_BOX_2D_HPP
+
+#include "nonlocal_constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <ranges>
+
+namespace nonlocal::mesh {
+
+template<class T>
+struct bounding_box_2d final {
+    std::array<T, 2> min = {std::numeric_limits<T>::max(), std::numeric_limits<T>::max()};
+    std::array<T, 2> max = {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest()};
+
+    void extend(const std::array<T, 2>& point) noexcept {
+        for(const size_t i : std::ranges::iota_view{0u, 2u}) {
+            min[i] = std::min(min[i], point[i]);
+            max[i] = std::max(max[i], point[i]);
+        }
+    }
+
+    void extend(const bounding_box_2d& other) noexcept {
+        extend(other.min);
+        extend(other.max);
+    }
+
+    std::array<T, 2> center() const noexcept {
+        return {T{0.5} * (min[X] + max[X]), T{0.5} * (min[Y] + max[Y])};
+    }
+
+    T diameter() const noexcept {
+        return std::hypot(max[X] - min[X], max[Y] - min[Y]);
+    }
+
+    // Per-axis gap between boxes, zero if the boxes overlap along the axis
+    std::array<T, 2> min_distance(const bounding_box_2d& other) const noexcept {
+        return {std::max({T{0}, other.min[X] - max[X], min[X] - other.max[X]}),
+                std::max({T{0}, other.min[Y] - max[Y], min[Y] - other.max[Y]})};
+    }
+
+    std::array<T, 2> max_distance(const bounding_box_2d& other) const noexcept {
+        return {std::max(other.max[X] - min[X], max[X] - other.min[X]),
+                std::max(other.max[Y] - min[Y], max[Y] - other.min[Y])};
+    }
+
+    T distance(const bounding_box_2d& other) const noexcept {
+        const std::array<T, 2> gap = min_distance(other);
+        return std::hypot(gap[X], gap[Y]);
+    }
+};
+
+enum class support_t : uint8_t { OUTSIDE, PARTIAL, INSIDE };
+
+// Superellipse |dx / rx|^n + |dy / ry|^n < 1, which is the support of compactly supported influence functions
+template<class T>
+struct support_2d final {
+    std::array<T, 2> radius = {};
+    T exponent = T{2};
+
+    T norm(const std::array<T, 2>& distance) const {
+        return std::pow(std::abs(distance[X]) / radius[X], exponent) +
+               std::pow(std::abs(distance[Y]) / radius[Y], exponent);
+    }
+
+    // Classifies all pairs of points from the boxes at once
+    support_t classify(const bounding_box_2d<T>& lhs, const bounding_box_2d<T>& rhs) const {
+        if (norm(lhs.min_distance(rhs)) >= T{1})
+            return support_t::OUTSIDE;
+        if (norm(lhs.max_distance(rhs)) < T{1})
+            return support_t::INSIDE;
+        return support_t::PARTIAL;
+    }
+};
+
+}
+
+#endif
\ No newline at end of file
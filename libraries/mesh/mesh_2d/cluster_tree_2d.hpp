@@ -0,0 +1,126 @@
+#ifndef NONLOCAL_CLUSTER_TREE_2D_HPP
+#define NONLOCAL_CLUSTER_TREE_2D_HPP
+
+#include "mesh_2d.hpp"
+
+#include <numeric>
+#include <span>
+
+namespace nonlocal::mesh {
+
+// Binary tree of elements built by geometric bisection of the quadrature nodes bounding boxes.
+// Elements of each cluster occupy a contiguous range of the permutation.
+template<class T, class I>
+class cluster_tree_2d final {
+public:
+    struct cluster final {
+        bounding_box_2d<T> box = {};
+        size_t begin = 0;
+        size_t end = 0;
+        size_t level = 0;
+        std::array<size_t, 2> children = {}; // zeros for leaves, the root cannot be a child
+    };
+
+private:
+    std::vector<I> _permutation;
+    std::vector<cluster> _clusters;
+    std::vector<bounding_box_2d<T>> _elements_boxes;
+    size_t _levels = 0;
+
+    static std::vector<bounding_box_2d<T>> elements_boxes(const mesh_2d<T, I>& mesh);
+
+    void split(const size_t index, const size_t leaf_size);
+
+public:
+    explicit cluster_tree_2d(const mesh_2d<T, I>& mesh, const std::ranges::iota_view<size_t, size_t> elements, const size_t leaf_size = 32);
+
+    size_t levels() const noexcept;
+    const cluster& root() const noexcept;
+    const cluster& at(const size_t index) const noexcept;
+    bool is_leaf(const cluster& cl) const noexcept;
+    std::span<const I> elements(const cluster& cl) const noexcept;
+    const bounding_box_2d<T>& element_box(const size_t e) const noexcept;
+};
+
+template<class T, class I>
+cluster_tree_2d<T, I>::cluster_tree_2d(const mesh_2d<T, I>& mesh, const std::ranges::iota_view<size_t, size_t> elements, const size_t leaf_size)
+    : _permutation(elements.begin(), elements.end())
+    , _elements_boxes{elements_boxes(mesh)} {
+    if (leaf_size == 0)
+        throw std::logic_error{"Cluster leaf size must be greater than 0."};
+    if (_permutation.empty())
+        throw std::logic_error{"It is impossible to build a cluster tree for an empty set of elements."};
+    _clusters.push_back({.begin = 0, .end = _permutation.size()});
+    split(0, leaf_size);
+}
+
+template<class T, class I>
+std::vector<bounding_box_2d<T>> cluster_tree_2d<T, I>::elements_boxes(const mesh_2d<T, I>& mesh) {
+    std::vector<bounding_box_2d<T>> boxes(mesh.container().elements_2d_count());
+#pragma omp parallel for default(none) shared(boxes, mesh)
+    for(size_t e = 0; e < boxes.size(); ++e)
+        boxes[e] = mesh.quad_bounding_box(e);
+    return boxes;
+}
+
+template<class T, class I>
+void cluster_tree_2d<T, I>::split(const size_t index, const size_t leaf_size) {
+    bounding_box_2d<T> box;
+    for(const I e : std::span<const I>{_permutation.data() + _clusters[index].begin, _permutation.data() + _clusters[index].end})
+        box.extend(_elements_boxes[e]);
+    _clusters[index].box = box;
+    _levels = std::max(_levels, _clusters[index].level + 1);
+    if (_clusters[index].end - _clusters[index].begin <= leaf_size)
+        return;
+
+    const size_t axis = box.max[X] - box.min[X] >= box.max[Y] - box.min[Y] ? X : Y;
+    const auto first = std::next(_permutation.begin(), _clusters[index].begin);
+    const auto last = std::next(_permutation.begin(), _clusters[index].end);
+    const auto middle = std::next(first, std::distance(first, last) / 2);
+    std::nth_element(first, middle, last, [this, axis](const I lhs, const I rhs) {
+        return _elements_boxes[lhs].center()[axis] < _elements_boxes[rhs].center()[axis];
+    });
+
+    const size_t middle_index = std::distance(_permutation.begin(), middle);
+    const size_t level = _clusters[index].level + 1;
+    _clusters[index].children = {_clusters.size(), _clusters.size() + 1};
+    _clusters.push_back({.begin = _clusters[index].begin, .end = middle_index, .level = level});
+    _clusters.push_back({.begin = middle_index, .end = _clusters[index].end, .level = level});
+    const auto children = _clusters[index].children;
+    split(children.front(), leaf_size);
+    split(children.back(), leaf_size);
+}
+
+template<class T, class I>
+size_t cluster_tree_2d<T, I>::levels() const noexcept {
+    return _levels;
+}
+
+template<class T, class I>
+const typename cluster_tree_2d<T, I>::cluster& cluster_tree_2d<T, I>::root() const noexcept {
+    return _clusters.front();
+}
+
+template<class T, class I>
+const typename cluster_tree_2d<T, I>::cluster& cluster_tree_2d<T, I>::at(const size_t index) const noexcept {
+    return _clusters[index];
+}
+
+template<class T, class I>
+bool cluster_tree_2d<T, I>::is_leaf(const cluster& cl) const noexcept {
+    return cl.children.front() == 0;
+}
+
+template<class T, class I>
+std::span<const I> cluster_tree_2d<T, I>::elements(const cluster& cl) const noexcept {
+    return {_permutation.data() + cl.begin, _permutation.data() + cl.end};
+}
+
+template<class T, class I>
+const bounding_box_2d<T>& cluster_tree_2d<T, I>::element_box(const size_t e) const noexcept {
+    return _elements_boxes[e];
+}
+
+}
+
+#endif
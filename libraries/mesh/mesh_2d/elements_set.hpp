@@ -3,6 +3,9 @@
 
 #include "metamath.hpp"
 
+#include <string_view>
+#include <unordered_map>
+
 namespace nonlocal::mesh {
 
 template<class T>
@@ -28,11 +31,138 @@ enum class element_2d_t : uint8_t {
     QUADRATIC_LAGRANGE
 };
 
+inline constexpr std::array<std::string_view, 5> element_2d_names = {
+    "triangle", "quadratic_triangle", "bilinear", "quadratic_serendipity", "quadratic_lagrange"
+};
+
+// The linear triangles are the affine images of the reference triangle,
+// so their Jacobi matrices and the gradients of the shape functions are constant
+constexpr bool is_affine(const element_2d_t type) noexcept {
+    return type == element_2d_t::TRIANGLE;
+}
+
+// Quadratures of the elements for the different kinds of integrals.
+// The nonlocal integrals are double, the outer quadrature is taken on the element eL and the inner one on the neighbour element eNL.
+enum class quadrature_set_t : uint8_t {
+    LOCAL,
+    NONLOCAL_OUTER,
+    NONLOCAL_INNER
+};
+
+inline constexpr size_t quadrature_sets_count = 3;
+
+// Quadrature orders of the element type in the order of quadrature_set_t, where 0 is the default quadrature of the element.
+// The order of the quadrilaterals is the number of the Gauss nodes in each direction,
+// the order of the triangles is the degree of the Dunavant rule.
+using quadrature_orders_2d = std::array<size_t, quadrature_sets_count>;
+using quadratures_2d = std::unordered_map<element_2d_t, quadrature_orders_2d>;
+
+// Default elements are tabulated at compile time, see vtk_elements_set
+template<class T, element_2d_t Type>
+struct default_element_2d_tables;
+template<class T>
+struct default_element_2d_tables<T, element_2d_t::TRIANGLE> {
+    using type = metamath::finite_element::element_2d_tables<T, metamath::finite_element::dunavant<T, metamath::finite_element::dunavant_stiffness_degree<1>>, metamath::finite_element::triangle, 1>;
+};
+template<class T>
+struct default_element_2d_tables<T, element_2d_t::QUADRATIC_TRIANGLE> {
+    using type = metamath::finite_element::element_2d_tables<T, metamath::finite_element::dunavant<T, metamath::finite_element::dunavant_stiffness_degree<2>>, metamath::finite_element::triangle, 2>;
+};
+template<class T>
+struct default_element_2d_tables<T, element_2d_t::BILINEAR> {
+    using type = metamath::finite_element::element_2d_tables<T, metamath::finite_element::gauss<T, 2>, metamath::finite_element::serendipity, 1>;
+};
+template<class T>
+struct default_element_2d_tables<T, element_2d_t::QUADRATIC_SERENDIPITY> {
+    using type = metamath::finite_element::element_2d_tables<T, metamath::finite_element::gauss<T, 3>, metamath::finite_element::serendipity, 2>;
+};
+template<class T>
+struct default_element_2d_tables<T, element_2d_t::QUADRATIC_LAGRANGE> {
+    using type = metamath::finite_element::element_2d_tables<T, metamath::finite_element::gauss<T, 3>, metamath::finite_element::lagrangian_element_2d, 2, 2>;
+};
+
+template<class T, element_2d_t Type>
+using default_element_2d_tables_t = typename default_element_2d_tables<T, Type>::type;
+
+// Compile-time sizes and tables of the element, which allow the integration kernels to unroll their loops.
+// The dynamic shape takes them from the element at runtime.
+template<class Tables = void>
+struct element_2d_shape final {
+    static constexpr size_t nodes = Tables::nodes_count;
+    static constexpr size_t qnodes = Tables::qnodes_count;
+    static constexpr bool is_static = true;
+
+    template<class T>
+    static bool is_matched(const element_integrate_2d<T>& element) noexcept {
+        if (element.nodes_count() != nodes || element.qnodes_count() != qnodes)
+            return false;
+        for(const size_t q : element.qnodes())
+            if (element.weight(q) != Tables::weights[q])
+                return false;
+        return true;
+    }
+
+    template<class T>
+    static constexpr size_t nodes_count(const element_integrate_2d<T>&) noexcept { return nodes; }
+    template<class T>
+    static constexpr size_t qnodes_count(const element_integrate_2d<T>&) noexcept { return qnodes; }
+    template<class T>
+    static constexpr T weight(const element_integrate_2d<T>&, const size_t q) noexcept { return Tables::weights[q]; }
+};
+
+template<>
+struct element_2d_shape<void> final {
+    static constexpr size_t nodes = 0;
+    static constexpr size_t qnodes = 0;
+    static constexpr bool is_static = false;
+
+    template<class T>
+    static size_t nodes_count(const element_integrate_2d<T>& element) noexcept { return element.nodes_count(); }
+    template<class T>
+    static size_t qnodes_count(const element_integrate_2d<T>& element) noexcept { return element.qnodes_count(); }
+    template<class T>
+    static T weight(const element_integrate_2d<T>& element, const size_t q) { return element.weight(q); }
+};
+
+using dynamic_element_2d_shape = element_2d_shape<>;
+
+// Calls the callback with the compile-time shape of the element if the element matches the default tables of its type
+// and with the dynamic shape otherwise, for example if the element has a non-default quadrature.
+template<class T, class Callback>
+void visit_element_2d_shape(const element_2d_t type, const element_integrate_2d<T>& element, Callback&& callback) {
+    const auto visit = [&element, &callback]<element_2d_t Type>() {
+        using shape_t = element_2d_shape<default_element_2d_tables_t<T, Type>>;
+        if (shape_t::is_matched(element))
+            callback(shape_t{});
+        else
+            callback(dynamic_element_2d_shape{});
+    };
+    switch (type) {
+    case element_2d_t::TRIANGLE:
+        visit.template operator()<element_2d_t::TRIANGLE>();
+        break;
+    case element_2d_t::QUADRATIC_TRIANGLE:
+        visit.template operator()<element_2d_t::QUADRATIC_TRIANGLE>();
+        break;
+    case element_2d_t::BILINEAR:
+        visit.template operator()<element_2d_t::BILINEAR>();
+        break;
+    case element_2d_t::QUADRATIC_SERENDIPITY:
+        visit.template operator()<element_2d_t::QUADRATIC_SERENDIPITY>();
+        break;
+    case element_2d_t::QUADRATIC_LAGRANGE:
+        visit.template operator()<element_2d_t::QUADRATIC_LAGRANGE>();
+        break;
+    default:
+        callback(dynamic_element_2d_shape{});
+    }
+}
+
 template<class T>
 class elements_set {
 protected:
     std::vector<finite_element_1d_sptr<T>> _elements_1d;
-    std::vector<finite_element_2d_sptr<T>> _elements_2d;
+    std::array<std::vector<finite_element_2d_sptr<T>>, quadrature_sets_count> _elements_2d; // the sets share the equal elements
     const std::unordered_map<size_t, element_1d_t> _model_to_local_1d;
     const std::unordered_map<size_t, element_2d_t> _model_to_local_2d;
     const std::vector<size_t> _local_to_model_1d;
@@ -51,15 +181,29 @@ protected:
                           std::unordered_map<size_t, element_1d_t>&& model_to_local_1d,
                           std::unordered_map<size_t, element_2d_t>&& model_to_local_2d)
         : _elements_1d{std::move(elements_1d)}
-        , _elements_2d{std::move(elements_2d)}
+        , _elements_2d{elements_2d, elements_2d, std::move(elements_2d)}
         , _model_to_local_1d{std::move(model_to_local_1d)}
         , _model_to_local_2d{std::move(model_to_local_2d)}
         , _local_to_model_1d{local_to_model(_model_to_local_1d)}
         , _local_to_model_2d{local_to_model(_model_to_local_2d)} {}
 
+    virtual finite_element_2d_sptr<T> make_element_2d(const element_2d_t local, const size_t quadrature_order) const = 0;
+
 public:
     virtual ~elements_set() noexcept = default;
 
+    // The sets with the equal orders share the element, so the geometry of the mesh is computed once for them
+    void set_quadratures(const quadratures_2d& quadratures) {
+        for(const auto& [local, orders] : quadratures)
+            for(const size_t set : std::ranges::iota_view{0u, quadrature_sets_count}) {
+                if (!orders[set])
+                    continue;
+                const auto equal = std::find(orders.begin(), std::next(orders.begin(), set), orders[set]);
+                _elements_2d[set][size_t(local)] = equal == std::next(orders.begin(), set) ?
+                    make_element_2d(local, orders[set]) : _elements_2d[std::distance(orders.begin(), equal)][size_t(local)];
+            }
+    }
+
     element_integrate_1d<T>& element_1d(const element_1d_t local) {
         return *_elements_1d[size_t(local)];
     }
@@ -68,12 +212,16 @@ public:
         return *_elements_1d[size_t(local)];
     }
 
-    element_integrate_2d<T>& element_2d(const element_2d_t local) {
-        return *_elements_2d[size_t(local)];
+    element_integrate_2d<T>& element_2d(const element_2d_t local, const quadrature_set_t set = quadrature_set_t::LOCAL) {
+        return *_elements_2d[size_t(set)][size_t(local)];
+    }
+
+    const element_integrate_2d<T>& element_2d(const element_2d_t local, const quadrature_set_t set = quadrature_set_t::LOCAL) const {
+        return *_elements_2d[size_t(set)][size_t(local)];
     }
 
-    const element_integrate_2d<T>& element_2d(const element_2d_t local) const {
-        return *_elements_2d[size_t(local)];
+    bool is_same_quadratures(const quadrature_set_t lhs, const quadrature_set_t rhs) const {
+        return _elements_2d[size_t(lhs)] == _elements_2d[size_t(rhs)];
     }
 
     element_1d_t model_to_local_1d(const size_t model) const {
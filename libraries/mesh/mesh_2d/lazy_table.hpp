@@ -0,0 +1,37 @@
+#ifndef NONLOCAL_LAZY_TABLE_HPP
+#define NONLOCAL_LAZY_TABLE_HPP
+
+#include <memory>
+#include <mutex>
+
+namespace nonlocal::mesh {
+
+// The table is built on the first access, which may happen from several threads at once.
+// The flag is stored by the pointer, so the owner stays movable.
+template<class Table>
+class lazy_table final {
+    mutable std::unique_ptr<std::once_flag> _flag = std::make_unique<std::once_flag>();
+    mutable Table _table;
+
+public:
+    template<class Builder>
+    const Table& get(const Builder& builder) const;
+    void clear();
+};
+
+template<class Table>
+template<class Builder>
+const Table& lazy_table<Table>::get(const Builder& builder) const {
+    std::call_once(*_flag, [this, &builder] { _table = builder(); });
+    return _table;
+}
+
+template<class Table>
+void lazy_table<Table>::clear() {
+    _flag = std::make_unique<std::once_flag>();
+    _table = {};
+}
+
+}
+
+#endif
\ No newline at end of file
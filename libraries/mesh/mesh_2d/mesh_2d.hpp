@@ -2,6 +2,10 @@
 #define NONLOCAL_MESH_2D_HPP
 
 #include "mesh_container_2d_utils.hpp"
+#include "bounding_box_2d.hpp"
+#include "quadrature_neighbours_2d.hpp"
+#include "reduced_precision.hpp"
+#include "lazy_table.hpp"
 
 #include "MPI_utils.hpp"
 
@@ -21,71 +25,286 @@ constexpr T jacobian(const metamath::types::square_matrix<T, 2>& J) noexcept {
 
 template<class T, class I>
 class mesh_2d final {
+    // Quadrature nodes, Jacobi matrices and the shape functions derivatives of the quadrature set
+    struct quadrature_geometry final {
+        std::vector<I> quad_shifts;
+        std::vector<std::array<T, 2>> quad_coords;
+        std::vector<metamath::types::square_matrix<T, 2>> jacobi_matrices;
+
+        std::vector<I> quad_node_shift;
+        std::vector<std::array<T, 2>> derivatives;
+
+        // Optional tables in the structure of arrays layout: the physical gradients are laid out as the derivatives
+        // and the quadrature weights multiplied by the Jacobians are laid out as the quadrature nodes
+        std::array<std::vector<T>, 2> gradients;
+        std::vector<T> weighted_jacobians;
+        std::array<std::vector<reduced_t>, 2> reduced_gradients;
+        std::vector<reduced_t> reduced_weighted_jacobians;
+
+        // The reduced precision tables replace the original ones
+        std::vector<std::array<reduced_t, 2>> reduced_quad_coords;
+        std::vector<metamath::types::square_matrix<reduced_t, 2>> reduced_jacobi_matrices;
+        std::vector<std::array<reduced_t, 2>> reduced_derivatives;
+
+        // The shifts are the serial prefix sums, so the shifts of different sets are computed concurrently,
+        // and the nodes tables are computed by the parallel loops over the elements
+        void compute_shifts(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set);
+        void compute_nodes_tables(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set);
+        void compute_physical_gradients(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set);
+        void reduce_precision();
+
+        template<class U>
+        const std::array<std::vector<U>, 2>& gradients_table() const noexcept;
+        template<class U>
+        const std::vector<U>& weighted_jacobians_table() const noexcept;
+    };
+
     mesh_container_2d<T, I> _mesh;
 
     std::vector<std::vector<I>> _node_elements;
-    std::vector<std::unordered_map<I, uint8_t>> _global_to_local;
+    // Rarely used tables are built on the first access
+    lazy_table<std::vector<std::unordered_map<I, uint8_t>>> _global_to_local;
+    lazy_table<std::vector<std::array<T, 2>>> _centres;
+    lazy_table<std::vector<T>> _areas;
 
-    std::vector<I> _quad_shifts;
-    std::vector<std::array<T, 2>> _quad_coords;
-    std::vector<metamath::types::square_matrix<T, 2>> _jacobi_matrices;
+    std::array<uint8_t, quadrature_sets_count> _geometry_index; // the sets with the same quadratures share the geometry
+    std::vector<quadrature_geometry> _geometries;
+    bool _is_reduced_precision = false;
 
-    std::vector<I> _quad_node_shift;
-    std::vector<std::array<T, 2>> _derivatives;
+    std::vector<I> _nodes_shifts;
+    std::vector<std::array<T, 2>> _gradient_integrals;
 
     parallel_utils::MPI_ranges _MPI_ranges;
 
     std::vector<std::vector<I>> _elements_neighbors;
-
+    std::vector<std::vector<support_t>> _neighbours_types;
+    quadrature_neighbours_2d<T, I> _quadrature_neighbours;
+
+    static std::array<uint8_t, quadrature_sets_count> geometry_index(const mesh_container_2d<T, I>& mesh);
+    // The first set of each geometry
+    static std::vector<quadrature_set_t> geometry_sets(const std::array<uint8_t, quadrature_sets_count>& geometry_index);
+    const quadrature_geometry& geometry(const quadrature_set_t set) const;
+
+    const std::vector<std::unordered_map<I, uint8_t>>& global_to_local() const;
+    const std::vector<std::array<T, 2>>& centres() const;
+    const std::vector<T>& areas() const;
+    std::vector<T> compute_areas() const;
+    T element_area(const size_t e) const;
     T area(const std::ranges::iota_view<size_t, size_t> elements) const;
 
 public:
-    explicit mesh_2d(const std::filesystem::path& path_to_mesh);
+    // The geometry is computed only for the distinct quadratures of the sets.
+    // The independent tables are computed concurrently
+    explicit mesh_2d(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures = {});
+    explicit mesh_2d(mesh_container_2d<T, I>&& mesh);
 
     const mesh_container_2d<T, I>& container() const;
     
     const std::vector<I>& elements(const size_t node) const;
     size_t global_to_local(const size_t e, const size_t node) const;
 
-    size_t quad_shift(const size_t e) const;
-    std::ranges::iota_view<size_t, size_t> quad_shifts_count(const size_t e) const;
-    const std::array<T, 2>& quad_coord(const size_t qshift) const;
-    const std::array<T, 2>& quad_coord(const size_t e, const size_t q) const;
-    const metamath::types::square_matrix<T, 2>& jacobi_matrix(const size_t qshift) const;
-    const metamath::types::square_matrix<T, 2>& jacobi_matrix(const size_t e, const size_t q) const;
-
-    size_t quad_node_shift(const size_t e, const size_t i) const;
-    const std::array<T, 2>& derivatives(const size_t qshift) const;
-    const std::array<T, 2>& derivatives(const size_t qnode_shift, const size_t q) const;
-    const std::array<T, 2>& derivatives(const size_t e, const size_t i, const size_t q) const;
+    bool is_same_quadratures(const quadrature_set_t lhs, const quadrature_set_t rhs) const noexcept;
+    // The nonlocal integrals use the local quadratures
+    bool is_single_quadrature() const noexcept;
+
+    size_t quad_shift(const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::ranges::iota_view<size_t, size_t> quad_shifts_count(const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::array<T, 2> quad_coord(const size_t qshift, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::array<T, 2> quad_coord(const size_t e, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    // Unit stride view of the quadrature nodes of the element. The reduced precision nodes are converted to the buffer,
+    // which size must be at least the quadrature nodes count of the element
+    std::span<const std::array<T, 2>> quad_coords(const size_t e, const std::span<std::array<T, 2>> buffer,
+                                                  const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    metamath::types::square_matrix<T, 2> jacobi_matrix(const size_t qshift, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    metamath::types::square_matrix<T, 2> jacobi_matrix(const size_t e, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+
+    // The derivatives of the affine elements are constant, so they are stored only once per node
+    // and the flat accessors must be called with q = 0 for them
+    bool is_affine(const size_t e) const;
+    size_t derivatives_count(const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    size_t quad_node_shift(const size_t e, const size_t i, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::array<T, 2> derivatives(const size_t qshift, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::array<T, 2> derivatives(const size_t qnode_shift, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    std::array<T, 2> derivatives(const size_t e, const size_t i, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+
+    // The physical gradients and the weighted Jacobians are precomputed on demand,
+    // the accessors below compute them on the fly if the tables are missing
+    void compute_physical_gradients();
+    bool has_physical_gradients() const noexcept;
+    std::array<T, 2> gradient(const size_t e, const size_t i, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    T weighted_jacobian(const size_t e, const size_t q, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    // Unit stride views of the precomputed tables over the quadrature nodes of the element,
+    // the gradients of the affine elements have a single entry. U is the stored type, see visit_precision
+    template<class U = T>
+    std::span<const U> gradients(const size_t e, const size_t i, const size_t component, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    template<class U = T>
+    std::span<const U> weighted_jacobians(const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+
+    // All quadrature tables and the quadrature neighbours values are stored as reduced_t instead of T,
+    // the accessors above convert the values back to T
+    void reduce_tables_precision();
+    bool is_reduced_precision() const noexcept;
+    template<class Callback>
+    void visit_precision(Callback&& callback) const;
+
+    // Integral of the shape function gradient over the element
+    const std::array<T, 2>& gradient_integral(const size_t e, const size_t i) const;
 
     const parallel_utils::MPI_ranges& MPI_ranges() const noexcept;
     std::ranges::iota_view<size_t, size_t> process_nodes(const size_t process = parallel_utils::MPI_rank()) const;
     std::unordered_set<I> process_elements(const size_t process = parallel_utils::MPI_rank()) const;
 
     const std::vector<I>& neighbours(const size_t e) const;
+    const std::vector<support_t>& neighbours_types(const size_t e) const;
+    size_t neighbour_index(const size_t eL, const size_t eNL) const;
+    support_t neighbour_type(const size_t eL, const size_t eNL) const;
+    const quadrature_neighbours_2d<T, I>& quadrature_neighbours() const noexcept;
 
+    bounding_box_2d<T> quad_bounding_box(const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
+    // The box of the quadrature nodes of both nonlocal sets
+    bounding_box_2d<T> nonlocal_bounding_box(const size_t e) const;
+
+    const std::array<T, 2>& centre(const size_t e) const;
     T area(const size_t e) const;
     T area(const std::string& element_group) const;
     T area() const;
 
-    void find_neighbours(const std::unordered_map<std::string, T>& radii, const balancing_t balancing = balancing_t::MEMORY, const bool add_diam = true);
+    // If the influence function support of the group is known, the pairs of elements
+    // whose quadrature nodes are entirely outside the support are not included in the neighbours
+    void find_neighbours(const std::unordered_map<std::string, T>& radii,
+                         const std::unordered_map<std::string, support_2d<T>>& supports = {});
+    // Must be called after find_neighbours, the influence functions are specified for the nonlocal groups
+    template<class Influence>
+    void find_quadrature_neighbours(const std::unordered_map<std::string, Influence>& influences);
 
     void clear();
 };
 
 template<class T, class I>
-mesh_2d<T, I>::mesh_2d(const std::filesystem::path& path_to_mesh)
-    : _mesh{path_to_mesh}
-    , _node_elements{utils::node_elements_2d(container())}
-    , _global_to_local{utils::global_to_local(container())}
-    , _quad_shifts{utils::elements_quadrature_shifts_2d(container())}
-    , _quad_coords{utils::approx_all_quad_nodes(container(), _quad_shifts)}
-    , _jacobi_matrices{utils::approx_all_jacobi_matrices(container(), _quad_shifts)}
-    , _quad_node_shift{utils::element_node_shits_quadrature_shifts_2d(container())}
-    , _derivatives{utils::derivatives_in_quad(container(), _quad_shifts, _quad_node_shift, _jacobi_matrices)}
+void mesh_2d<T, I>::quadrature_geometry::compute_shifts(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set) {
+    quad_shifts = utils::elements_quadrature_shifts_2d(mesh, set);
+    quad_node_shift = utils::element_node_shits_quadrature_shifts_2d(mesh, set);
+}
+
+template<class T, class I>
+void mesh_2d<T, I>::quadrature_geometry::compute_nodes_tables(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set) {
+    quad_coords = utils::approx_all_quad_nodes(mesh, quad_shifts, set);
+    jacobi_matrices = utils::approx_all_jacobi_matrices(mesh, quad_shifts, set);
+    derivatives = utils::derivatives_in_quad(mesh, quad_shifts, quad_node_shift, jacobi_matrices, set);
+}
+
+template<class T, class I>
+void mesh_2d<T, I>::quadrature_geometry::compute_physical_gradients(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set) {
+    gradients[X].resize(derivatives.size());
+    gradients[Y].resize(derivatives.size());
+    weighted_jacobians.resize(jacobi_matrices.size());
+#pragma omp parallel for default(none) shared(mesh, set)
+    for(size_t e = 0; e < mesh.elements_2d_count(); ++e) {
+        const auto& el = mesh.element_2d(e, set);
+        const size_t derivatives_count = utils::derivatives_count_2d(mesh, e, set);
+        for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()})
+            weighted_jacobians[quad_shifts[e] + q] = el.weight(q) * jacobian(jacobi_matrices[quad_shifts[e] + q]);
+        for(const size_t q : std::ranges::iota_view{0u, derivatives_count}) {
+            const T jac = jacobian(jacobi_matrices[quad_shifts[e] + q]);
+            for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()}) {
+                const size_t index = quad_node_shift[e] + i * derivatives_count + q;
+                gradients[X][index] = derivatives[index][X] / jac;
+                gradients[Y][index] = derivatives[index][Y] / jac;
+            }
+        }
+    }
+}
+
+template<class T, class I>
+void mesh_2d<T, I>::quadrature_geometry::reduce_precision() {
+    reduced_quad_coords = mesh::reduce_precision(quad_coords);
+    reduced_jacobi_matrices = mesh::reduce_precision(jacobi_matrices);
+    reduced_derivatives = mesh::reduce_precision(derivatives);
+    if (weighted_jacobians.empty())
+        return;
+    reduced_gradients[X] = mesh::reduce_precision(gradients[X]);
+    reduced_gradients[Y] = mesh::reduce_precision(gradients[Y]);
+    reduced_weighted_jacobians = mesh::reduce_precision(weighted_jacobians);
+}
+
+template<class T, class I>
+template<class U>
+auto mesh_2d<T, I>::quadrature_geometry::gradients_table() const noexcept -> const std::array<std::vector<U>, 2>& {
+    if constexpr (std::is_same_v<U, T>)
+        return gradients;
+    else
+        return reduced_gradients;
+}
+
+template<class T, class I>
+template<class U>
+const std::vector<U>& mesh_2d<T, I>::quadrature_geometry::weighted_jacobians_table() const noexcept {
+    if constexpr (std::is_same_v<U, T>)
+        return weighted_jacobians;
+    else
+        return reduced_weighted_jacobians;
+}
+
+template<class T, class I>
+mesh_2d<T, I>::mesh_2d(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures)
+    : mesh_2d{mesh_container_2d<T, I>{path_to_mesh, quadratures}} {}
+
+template<class T, class I>
+mesh_2d<T, I>::mesh_2d(mesh_container_2d<T, I>&& mesh)
+    : _mesh{std::move(mesh)}
+    , _geometry_index{geometry_index(container())}
+    , _geometries(*std::ranges::max_element(_geometry_index) + 1)
     , _MPI_ranges{container().nodes_count()}
-    , _elements_neighbors(container().elements_2d_count()) {}
+    , _elements_neighbors(container().elements_2d_count())
+    , _neighbours_types(container().elements_2d_count()) {
+    const std::vector<quadrature_set_t> sets = geometry_sets(_geometry_index);
+#pragma omp parallel default(none) shared(sets)
+#pragma omp single
+    {
+#pragma omp task default(none)
+        _node_elements = utils::node_elements_2d(container());
+#pragma omp task default(none)
+        _nodes_shifts = utils::elements_nodes_shifts_2d(container());
+        for(const size_t g : std::ranges::iota_view{0u, sets.size()}) {
+#pragma omp task default(none) shared(sets) firstprivate(g)
+            _geometries[g].compute_shifts(container(), sets[g]);
+        }
+    }
+    for(const size_t g : std::ranges::iota_view{0u, sets.size()})
+        _geometries[g].compute_nodes_tables(container(), sets[g]);
+    _gradient_integrals = utils::gradient_integrals_2d(container(), _nodes_shifts, geometry(quadrature_set_t::LOCAL).quad_node_shift,
+                                                       geometry(quadrature_set_t::LOCAL).derivatives);
+}
+
+template<class T, class I>
+std::array<uint8_t, quadrature_sets_count> mesh_2d<T, I>::geometry_index(const mesh_container_2d<T, I>& mesh) {
+    std::array<uint8_t, quadrature_sets_count> index = {};
+    uint8_t geometries_count = 0;
+    for(const size_t set : std::ranges::iota_view{0u, quadrature_sets_count}) {
+        index[set] = geometries_count;
+        for(const size_t prev : std::ranges::iota_view{0u, set})
+            if (mesh.get_elements_set().is_same_quadratures(quadrature_set_t(prev), quadrature_set_t(set))) {
+                index[set] = index[prev];
+                break;
+            }
+        geometries_count += index[set] == geometries_count;
+    }
+    return index;
+}
+
+template<class T, class I>
+std::vector<quadrature_set_t> mesh_2d<T, I>::geometry_sets(const std::array<uint8_t, quadrature_sets_count>& geometry_index) {
+    std::vector<quadrature_set_t> sets;
+    for(const size_t set : std::ranges::iota_view{0u, quadrature_sets_count})
+        if (geometry_index[set] == sets.size())
+            sets.push_back(quadrature_set_t(set));
+    return sets;
+}
+
+template<class T, class I>
+auto mesh_2d<T, I>::geometry(const quadrature_set_t set) const -> const quadrature_geometry& {
+    return _geometries[_geometry_index[size_t(set)]];
+}
 
 template<class T, class I>
 const mesh_container_2d<T, I>& mesh_2d<T, I>::container() const {
@@ -99,57 +318,163 @@ const std::vector<I>& mesh_2d<T, I>::elements(const size_t node) const {
 
 template<class T, class I>
 size_t mesh_2d<T, I>::global_to_local(const size_t e, const size_t node) const {
-    return _global_to_local[e].at(node);
+    return global_to_local()[e].at(node);
+}
+
+template<class T, class I>
+bool mesh_2d<T, I>::is_same_quadratures(const quadrature_set_t lhs, const quadrature_set_t rhs) const noexcept {
+    return _geometry_index[size_t(lhs)] == _geometry_index[size_t(rhs)];
+}
+
+template<class T, class I>
+bool mesh_2d<T, I>::is_single_quadrature() const noexcept {
+    return _geometries.size() == 1;
+}
+
+template<class T, class I>
+size_t mesh_2d<T, I>::quad_shift(const size_t e, const quadrature_set_t set) const {
+    return geometry(set).quad_shifts[e];
+}
+
+template<class T, class I>
+std::ranges::iota_view<size_t, size_t> mesh_2d<T, I>::quad_shifts_count(const size_t e, const quadrature_set_t set) const {
+    return {quad_shift(e, set), quad_shift(e + 1, set)};
+}
+
+template<class T, class I>
+std::array<T, 2> mesh_2d<T, I>::quad_coord(const size_t qshift, const quadrature_set_t set) const {
+    return is_reduced_precision() ? precision_cast<T>(geometry(set).reduced_quad_coords[qshift]) : geometry(set).quad_coords[qshift];
+}
+
+template<class T, class I>
+std::array<T, 2> mesh_2d<T, I>::quad_coord(const size_t e, const size_t q, const quadrature_set_t set) const {
+    return quad_coord(quad_shift(e, set) + q, set);
+}
+
+template<class T, class I>
+std::span<const std::array<T, 2>> mesh_2d<T, I>::quad_coords(const size_t e, const std::span<std::array<T, 2>> buffer,
+                                                             const quadrature_set_t set) const {
+    const std::ranges::iota_view<size_t, size_t> qshifts = quad_shifts_count(e, set);
+    if (!is_reduced_precision())
+        return {&geometry(set).quad_coords[qshifts.front()], qshifts.size()};
+    for(const size_t qshift : qshifts)
+        buffer[qshift - qshifts.front()] = quad_coord(qshift, set);
+    return buffer.first(qshifts.size());
+}
+
+template<class T, class I>
+metamath::types::square_matrix<T, 2> mesh_2d<T, I>::jacobi_matrix(const size_t qshift, const quadrature_set_t set) const {
+    return is_reduced_precision() ? precision_cast<T>(geometry(set).reduced_jacobi_matrices[qshift]) : geometry(set).jacobi_matrices[qshift];
 }
 
 template<class T, class I>
-size_t mesh_2d<T, I>::quad_shift(const size_t e) const {
-    return _quad_shifts[e];
+metamath::types::square_matrix<T, 2> mesh_2d<T, I>::jacobi_matrix(const size_t e, const size_t q, const quadrature_set_t set) const {
+    return jacobi_matrix(quad_shift(e, set) + q, set);
 }
 
 template<class T, class I>
-std::ranges::iota_view<size_t, size_t> mesh_2d<T, I>::quad_shifts_count(const size_t e) const {
-    return {quad_shift(e), quad_shift(e + 1)};
+bool mesh_2d<T, I>::is_affine(const size_t e) const {
+    return mesh::is_affine(container().element_type_2d(e));
 }
 
 template<class T, class I>
-const std::array<T, 2>& mesh_2d<T, I>::quad_coord(const size_t qshift) const {
-    return _quad_coords[qshift];
+size_t mesh_2d<T, I>::derivatives_count(const size_t e, const quadrature_set_t set) const {
+    return utils::derivatives_count_2d(container(), e, set);
 }
 
 template<class T, class I>
-const std::array<T, 2>& mesh_2d<T, I>::quad_coord(const size_t e, const size_t q) const {
-    return quad_coord(quad_shift(e) + q);
+size_t mesh_2d<T, I>::quad_node_shift(const size_t e, const size_t i, const quadrature_set_t set) const {
+    return geometry(set).quad_node_shift[e] + i * derivatives_count(e, set);
 }
 
 template<class T, class I>
-const metamath::types::square_matrix<T, 2>& mesh_2d<T, I>::jacobi_matrix(const size_t qshift) const {
-    return _jacobi_matrices[qshift];
+std::array<T, 2> mesh_2d<T, I>::derivatives(const size_t qshift, const quadrature_set_t set) const {
+    return is_reduced_precision() ? precision_cast<T>(geometry(set).reduced_derivatives[qshift]) : geometry(set).derivatives[qshift];
 }
 
 template<class T, class I>
-const metamath::types::square_matrix<T, 2>& mesh_2d<T, I>::jacobi_matrix(const size_t e, const size_t q) const {
-    return jacobi_matrix(quad_shift(e) + q);
+std::array<T, 2> mesh_2d<T, I>::derivatives(const size_t qnode_shift, const size_t q, const quadrature_set_t set) const {
+    return derivatives(qnode_shift + q, set);
 }
 
 template<class T, class I>
-size_t mesh_2d<T, I>::quad_node_shift(const size_t e, const size_t i) const {
-    return _quad_node_shift[e] + i * container().element_2d(e).qnodes_count();
+std::array<T, 2> mesh_2d<T, I>::derivatives(const size_t e, const size_t i, const size_t q, const quadrature_set_t set) const {
+    return derivatives(quad_node_shift(e, i, set), is_affine(e) ? 0 : q, set);
 }
 
 template<class T, class I>
-const std::array<T, 2>& mesh_2d<T, I>::derivatives(const size_t qshift) const {
-    return _derivatives[qshift];
+void mesh_2d<T, I>::compute_physical_gradients() {
+    if (is_reduced_precision())
+        throw std::logic_error{"The physical gradients cannot be computed after the reduction of the tables precision."};
+    for(const size_t set : std::ranges::iota_view{0u, quadrature_sets_count})
+        if (quadrature_geometry& geometry = _geometries[_geometry_index[set]]; geometry.weighted_jacobians.empty())
+            geometry.compute_physical_gradients(container(), quadrature_set_t(set));
 }
 
 template<class T, class I>
-const std::array<T, 2>& mesh_2d<T, I>::derivatives(const size_t qnode_shift, const size_t q) const {
-    return derivatives(qnode_shift + q);
+bool mesh_2d<T, I>::has_physical_gradients() const noexcept {
+    return !_geometries.empty() && (!_geometries.front().weighted_jacobians.empty() || !_geometries.front().reduced_weighted_jacobians.empty());
+}
+
+template<class T, class I>
+std::array<T, 2> mesh_2d<T, I>::gradient(const size_t e, const size_t i, const size_t q, const quadrature_set_t set) const {
+    const size_t index = quad_node_shift(e, i, set) + (is_affine(e) ? 0 : q);
+    if (has_physical_gradients()) {
+        const quadrature_geometry& tables = geometry(set);
+        return is_reduced_precision() ? std::array<T, 2>{tables.reduced_gradients[X][index], tables.reduced_gradients[Y][index]} :
+                                        std::array<T, 2>{tables.gradients[X][index], tables.gradients[Y][index]};
+    }
+    const T jac = jacobian(jacobi_matrix(e, q, set));
+    return {derivatives(index, set)[X] / jac, derivatives(index, set)[Y] / jac};
+}
+
+template<class T, class I>
+T mesh_2d<T, I>::weighted_jacobian(const size_t e, const size_t q, const quadrature_set_t set) const {
+    if (has_physical_gradients()) {
+        const size_t qshift = quad_shift(e, set) + q;
+        return is_reduced_precision() ? T(geometry(set).reduced_weighted_jacobians[qshift]) : geometry(set).weighted_jacobians[qshift];
+    }
+    return container().element_2d(e, set).weight(q) * jacobian(jacobi_matrix(e, q, set));
 }
 
 template<class T, class I>
-const std::array<T, 2>& mesh_2d<T, I>::derivatives(const size_t e, const size_t i, const size_t q) const {
-    return derivatives(quad_node_shift(e, i), q);
+template<class U>
+std::span<const U> mesh_2d<T, I>::gradients(const size_t e, const size_t i, const size_t component, const quadrature_set_t set) const {
+    return {&geometry(set).template gradients_table<U>()[component][quad_node_shift(e, i, set)], derivatives_count(e, set)};
+}
+
+template<class T, class I>
+template<class U>
+std::span<const U> mesh_2d<T, I>::weighted_jacobians(const size_t e, const quadrature_set_t set) const {
+    return {&geometry(set).template weighted_jacobians_table<U>()[quad_shift(e, set)], container().element_2d(e, set).qnodes_count()};
+}
+
+template<class T, class I>
+void mesh_2d<T, I>::reduce_tables_precision() {
+    if constexpr (!std::is_same_v<T, reduced_t>) {
+        if (is_reduced_precision())
+            return;
+        for(quadrature_geometry& geometry : _geometries)
+            geometry.reduce_precision();
+        _quadrature_neighbours.reduce_precision();
+        _is_reduced_precision = true;
+    }
+}
+
+template<class T, class I>
+bool mesh_2d<T, I>::is_reduced_precision() const noexcept {
+    return _is_reduced_precision;
+}
+
+template<class T, class I>
+template<class Callback>
+void mesh_2d<T, I>::visit_precision(Callback&& callback) const {
+    mesh::visit_precision<T>(is_reduced_precision(), std::forward<Callback>(callback));
+}
+
+template<class T, class I>
+const std::array<T, 2>& mesh_2d<T, I>::gradient_integral(const size_t e, const size_t i) const {
+    return _gradient_integrals[_nodes_shifts[e] + i];
 }
 
 template<class T, class I>
@@ -176,12 +501,88 @@ const std::vector<I>& mesh_2d<T, I>::neighbours(const size_t e) const {
     return _elements_neighbors[e];
 }
 
+template<class T, class I>
+const std::vector<support_t>& mesh_2d<T, I>::neighbours_types(const size_t e) const {
+    return _neighbours_types[e];
+}
+
+// Neighbours are sorted in ascending order, so the pair is found by the binary search.
+// If eNL is not a neighbour of eL, the neighbours count is returned.
+template<class T, class I>
+size_t mesh_2d<T, I>::neighbour_index(const size_t eL, const size_t eNL) const {
+    const std::vector<I>& neighbours = _elements_neighbors[eL];
+    const auto it = std::lower_bound(neighbours.begin(), neighbours.end(), I(eNL));
+    return it != neighbours.end() && size_t(*it) == eNL ? std::distance(neighbours.begin(), it) : neighbours.size();
+}
+
+template<class T, class I>
+support_t mesh_2d<T, I>::neighbour_type(const size_t eL, const size_t eNL) const {
+    const size_t index = neighbour_index(eL, eNL);
+    return index < _neighbours_types[eL].size() ? _neighbours_types[eL][index] : support_t::OUTSIDE;
+}
+
+template<class T, class I>
+const quadrature_neighbours_2d<T, I>& mesh_2d<T, I>::quadrature_neighbours() const noexcept {
+    return _quadrature_neighbours;
+}
+
+template<class T, class I>
+bounding_box_2d<T> mesh_2d<T, I>::quad_bounding_box(const size_t e, const quadrature_set_t set) const {
+    bounding_box_2d<T> box;
+    for(const size_t qshift : quad_shifts_count(e, set))
+        box.extend(quad_coord(qshift, set));
+    return box;
+}
+
+template<class T, class I>
+bounding_box_2d<T> mesh_2d<T, I>::nonlocal_bounding_box(const size_t e) const {
+    bounding_box_2d<T> box = quad_bounding_box(e, quadrature_set_t::NONLOCAL_OUTER);
+    if (!is_same_quadratures(quadrature_set_t::NONLOCAL_OUTER, quadrature_set_t::NONLOCAL_INNER))
+        for(const size_t qshift : quad_shifts_count(e, quadrature_set_t::NONLOCAL_INNER))
+            box.extend(quad_coord(qshift, quadrature_set_t::NONLOCAL_INNER));
+    return box;
+}
+
+template<class T, class I>
+auto mesh_2d<T, I>::global_to_local() const -> const std::vector<std::unordered_map<I, uint8_t>>& {
+    return _global_to_local.get([this] { return utils::global_to_local(container()); });
+}
+
+template<class T, class I>
+const std::vector<std::array<T, 2>>& mesh_2d<T, I>::centres() const {
+    return _centres.get([this] { return utils::approx_centers_of_elements(container()); });
+}
+
+template<class T, class I>
+const std::vector<T>& mesh_2d<T, I>::areas() const {
+    return _areas.get([this] { return compute_areas(); });
+}
+
+template<class T, class I>
+std::vector<T> mesh_2d<T, I>::compute_areas() const {
+    std::vector<T> areas(container().elements_2d_count());
+#pragma omp parallel for default(none) shared(areas)
+    for(size_t e = 0; e < areas.size(); ++e)
+        areas[e] = element_area(e);
+    return areas;
+}
+
+template<class T, class I>
+const std::array<T, 2>& mesh_2d<T, I>::centre(const size_t e) const {
+    return centres()[e];
+}
+
 template<class T, class I>
 T mesh_2d<T, I>::area(const size_t e) const {
+    return areas()[e];
+}
+
+template<class T, class I>
+T mesh_2d<T, I>::element_area(const size_t e) const {
     T area = T{0};
     const auto& el = container().element_2d(e);
     for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
-        const T factor = el.weight(q) * jacobian(jacobi_matrix(e, q));
+        const T factor = weighted_jacobian(e, q);
         for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()})
             area += factor * el.qN(i, q);
     }
@@ -196,7 +597,7 @@ T mesh_2d<T, I>::area(const std::ranges::iota_view<size_t, size_t> elements) con
 
 template<class T, class I>
 T mesh_2d<T, I>::area(const std::string& element_group) const {
-    if (!container().groups_names_2d().contains(element_group))
+    if (!container().groups_2d().contains(element_group))
         throw std::domain_error{
             "It is not possible to calculate the area of the elements group, "
             "since the elements group " + element_group + " is missing"
@@ -210,45 +611,76 @@ T mesh_2d<T, I>::area() const {
 }
 
 template<class T, class I>
-void mesh_2d<T, I>::find_neighbours(const std::unordered_map<std::string, T>& radii, const balancing_t balancing, const bool add_diam) {
+void mesh_2d<T, I>::find_neighbours(const std::unordered_map<std::string, T>& radii,
+                                    const std::unordered_map<std::string, support_2d<T>>& supports) {
+    _quadrature_neighbours.clear();
     if (radii.empty())
         return;
     _elements_neighbors.resize(container().elements_2d_count());
-    const std::vector<std::array<T, 2>> centers = utils::approx_centers_of_elements(container());
+    _neighbours_types.resize(container().elements_2d_count());
+    const std::vector<std::array<T, 2>>& centres = this->centres();
+    std::vector<bounding_box_2d<T>> boxes;
+    if (!supports.empty()) {
+        boxes.resize(container().elements_2d_count());
+#pragma omp parallel for default(none) shared(boxes)
+        for(size_t e = 0; e < boxes.size(); ++e)
+            boxes[e] = nonlocal_bounding_box(e);
+    }
     for(const auto& [group, radius] : radii) {
         if (radius == T{0})
             continue;
         const auto elements_range = container().elements(group);
-        for(const size_t eL : elements_range) {
-            _elements_neighbors[eL].reserve(elements_range.size());
+        const auto it = supports.find(group);
+        const support_2d<T>* const support = it == supports.end() ? nullptr : &it->second;
+#pragma omp parallel for default(none) shared(elements_range, centres, boxes, support, radius) schedule(dynamic)
+        for(size_t eL = elements_range.front(); eL < *elements_range.end(); ++eL) {
+            auto& neighbours = _elements_neighbors[eL];
+            auto& types = _neighbours_types[eL];
+            neighbours.reserve(elements_range.size());
+            types.reserve(elements_range.size());
             for(const size_t eNL : elements_range)
-                if (metamath::functions::distance(centers[eL], centers[eNL]) <= radius)
-                    _elements_neighbors[eL].push_back(eNL);
-            _elements_neighbors[eL].shrink_to_fit();
+                if (metamath::functions::distance(centres[eL], centres[eNL]) <= radius)
+                    if (const support_t type = support ? support->classify(boxes[eL], boxes[eNL]) : support_t::PARTIAL;
+                        type != support_t::OUTSIDE) {
+                        neighbours.push_back(eNL);
+                        types.push_back(type);
+                    }
+            neighbours.shrink_to_fit();
+            types.shrink_to_fit();
         }
     }
 }
 
+template<class T, class I>
+template<class Influence>
+void mesh_2d<T, I>::find_quadrature_neighbours(const std::unordered_map<std::string, Influence>& influences) {
+    _quadrature_neighbours.compute(*this, influences);
+    if (is_reduced_precision())
+        _quadrature_neighbours.reduce_precision();
+}
+
 template<class T, class I>
 void mesh_2d<T, I>::clear() {
     _mesh.clear();
     _node_elements.clear();
     _node_elements.shrink_to_fit();
-    _global_to_local.claer();
-    _global_to_local.shrink_to_fit();
-    _quad_shifts.clear();
-    _quad_shifts.shrink_to_fit();
-    _quad_coords.clear();
-    _quad_coords.shrink_to_fit();
-    _jacobi_matrices.clear();
-    _jacobi_matrices.shrink_to_fit();
-    _quad_node_shift.clear();
-    _quad_node_shift.shrink_to_fit();
-    _derivatives.clear();
-    _derivatives.shrink_to_fit();
+    _global_to_local.clear();
+    _centres.clear();
+    _areas.clear();
+    _geometry_index = {};
+    _geometries.clear();
+    _geometries.shrink_to_fit();
+    _is_reduced_precision = false;
+    _nodes_shifts.clear();
+    _nodes_shifts.shrink_to_fit();
+    _gradient_integrals.clear();
+    _gradient_integrals.shrink_to_fit();
     _MPI_ranges = parallel_utils::MPI_ranges{0};
     _elements_neighbors.clear();
     _elements_neighbors.shrink_to_fit();
+    _neighbours_types.clear();
+    _neighbours_types.shrink_to_fit();
+    _quadrature_neighbours.clear();
 }
 
 }
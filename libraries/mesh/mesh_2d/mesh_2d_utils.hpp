@@ -29,9 +29,39 @@ std::array<std::vector<T>, 2> gradient_in_qnodes(const mesh_2d<T, I>& mesh, cons
         std::vector<T>(quadratures_count, T{0}),
         std::vector<T>(quadratures_count, T{0})
     };
-#pragma parallel for default(none) shared(gradient, mesh, x)
+#pragma omp parallel default(none) shared(gradient, mesh, x)
+{
+    std::vector<T> dxi, deta; // the buffers of the thread
+#pragma omp for
     for(size_t e = 0; e < mesh.container().elements_2d_count(); ++e) {
         const auto& el = mesh.container().element_2d(e);
+        if (const auto& tensor_product = el.tensor_product()) {
+            dxi.resize(el.qnodes_count());
+            deta.resize(el.qnodes_count());
+            tensor_product->interpolate([&mesh, &x, e](const size_t i) { return T(x[mesh.container().node_number(e, i)]); }, {}, dxi, deta);
+            for(size_t q = 0, qshift = mesh.quad_shift(e); q < el.qnodes_count(); ++q, ++qshift) {
+                const metamath::types::square_matrix<T, 2> J = mesh.jacobi_matrix(qshift);
+                const T jac = jacobian(J);
+                gradient[X][qshift] = ( dxi[q] * J[1][1] - deta[q] * J[1][0]) / jac;
+                gradient[Y][qshift] = (-dxi[q] * J[0][1] + deta[q] * J[0][0]) / jac;
+            }
+            continue;
+        }
+        if (mesh.has_physical_gradients()) {
+            mesh.visit_precision([&mesh, &el, &x, &gradient, e]<class U>(const std::type_identity<U>) {
+                const size_t qshift = mesh.quad_shift(e);
+                const size_t step = mesh.is_affine(e) ? 0 : 1;
+                for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()}) {
+                    const T& val = x[mesh.container().node_number(e, i)];
+                    const std::span<const U> dNx = mesh.template gradients<U>(e, i, X), dNy = mesh.template gradients<U>(e, i, Y);
+                    for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
+                        gradient[X][qshift + q] += val * dNx[q * step];
+                        gradient[Y][qshift + q] += val * dNy[q * step];
+                    }
+                }
+            });
+            continue;
+        }
         for(size_t q = 0, qshift = mesh.quad_shift(e); q < el.qnodes_count(); ++q, ++qshift) {
             for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()}) {
                 const std::array<T, 2>& derivatives = mesh.derivatives(e, i, q);
@@ -44,6 +74,7 @@ std::array<std::vector<T>, 2> gradient_in_qnodes(const mesh_2d<T, I>& mesh, cons
             gradient[Y][qshift] /= jac;
         }
     }
+}
     return gradient;
 }
 
@@ -53,9 +84,14 @@ std::vector<T> nodes_to_qnodes(const mesh_2d<T, I>& mesh, const Vector& x) {
         throw std::logic_error{"The gradient cannot be found because the vector size does not match the number of nodes."};
     const size_t quadratures_count = mesh.quad_shift(mesh.container().elements_2d_count());
     std::vector<T> values(quadratures_count, T{0});
-#pragma parallel for default(none) shared(gradient, mesh, x, values)
+#pragma omp parallel for default(none) shared(mesh, x, values)
     for(size_t e = 0; e < mesh.container().elements_2d_count(); ++e) {
         const auto& el = mesh.container().element_2d(e);
+        if (const auto& tensor_product = el.tensor_product()) {
+            tensor_product->interpolate([&mesh, &x, e](const size_t i) { return T(x[mesh.container().node_number(e, i)]); },
+                                        std::span<T>{&values[mesh.quad_shift(e)], el.qnodes_count()}, {}, {});
+            continue;
+        }
         for(size_t q = 0, qshift = mesh.quad_shift(e); q < el.qnodes_count(); ++q, ++qshift) {
             for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()}) 
                 values[qshift] += x[mesh.container().node_number(e, i)] * el.qN(i, q);
@@ -69,7 +105,7 @@ std::vector<T> qnodes_to_nodes(const mesh_2d<T, I>& mesh, const Vector& x) {
     if (mesh.quad_shift(mesh.container().elements_2d_count()) != size_t(x.size()))
         throw std::logic_error{"Cannot approximate node values because vector size does not match number of quadrature nodes"};
     std::vector<T> approximation(mesh.container().nodes_count(), T{0});
-#pragma parallel for default(none) shared(approximation, mesh, x)
+#pragma omp parallel for default(none) shared(approximation, mesh, x)
     for(size_t node = 0; node < mesh.container().nodes_count(); ++node) {
         T node_area = T{0};
         for(const I e : mesh.elements(node)) {
@@ -50,7 +50,7 @@ public:
         metamath::types::square_matrix<T, 2> jacobi_matrix(const size_t q) const;
     };
 
-    explicit mesh_container_2d(const std::filesystem::path& path_to_mesh);
+    explicit mesh_container_2d(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures = {});
 
     const std::string& group(const size_t element) const;
 
@@ -64,6 +64,8 @@ public:
     size_t elements_2d_count() const;
 
     std::ranges::iota_view<size_t, size_t> elements(const std::string& group_name) const;
+    // The 2D elements of the group are sorted by their types, so the group is split into the homogeneous batches
+    std::vector<std::ranges::iota_view<size_t, size_t>> elements_batches(const std::string& group_name) const;
     std::ranges::iota_view<size_t, size_t> elements_1d() const noexcept;
     std::ranges::iota_view<size_t, size_t> elements_2d() const noexcept;
 
@@ -81,13 +83,13 @@ public:
     element_2d_t element_type_2d(const size_t element) const;
 
     const element_integrate_1d<T>& element_1d(const size_t element) const;
-    const element_integrate_2d<T>& element_2d(const size_t element) const;
+    const element_integrate_2d<T>& element_2d(const size_t element, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
 
     element_data_1d element_1d_data(const size_t element) const;
-    element_data_2d element_2d_data(const size_t element) const;
+    element_data_2d element_2d_data(const size_t element, const quadrature_set_t set = quadrature_set_t::LOCAL) const;
 
     void clear();
-    void read_from_file(const std::filesystem::path& path_to_mesh);
+    void read_from_file(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures = {});
     void renumbering(const std::vector<size_t>& permutation);
 };
 
@@ -154,8 +156,8 @@ metamath::types::square_matrix<T, 2> mesh_container_2d<T, I>::element_data_2d::j
 }
 
 template<class T, class I>
-mesh_container_2d<T, I>::mesh_container_2d(const std::filesystem::path& path_to_mesh) {
-    read_from_file(path_to_mesh);
+mesh_container_2d<T, I>::mesh_container_2d(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures) {
+    read_from_file(path_to_mesh, quadratures);
 }
 
 template<class T, class I>
@@ -208,6 +210,18 @@ std::ranges::iota_view<size_t, size_t> mesh_container_2d<T, I>::elements(const s
     return _elements_groups.at(group_name);
 }
 
+template<class T, class I>
+std::vector<std::ranges::iota_view<size_t, size_t>> mesh_container_2d<T, I>::elements_batches(const std::string& group_name) const {
+    const auto elements = this->elements(group_name);
+    std::vector<std::ranges::iota_view<size_t, size_t>> batches;
+    for(size_t begin = elements.front(), end = begin; begin < *elements.end(); begin = end) {
+        while (end < *elements.end() && _elements_types[end] == _elements_types[begin])
+            ++end;
+        batches.emplace_back(begin, end);
+    }
+    return batches;
+}
+
 template<class T, class I>
 std::ranges::iota_view<size_t, size_t> mesh_container_2d<T, I>::elements_1d() const noexcept {
     return {elements_2d_count(), _elements.size()};
@@ -269,8 +283,8 @@ const element_integrate_1d<T>& mesh_container_2d<T, I>::element_1d(const size_t
 }
 
 template<class T, class I>
-const element_integrate_2d<T>& mesh_container_2d<T, I>::element_2d(const size_t element) const {
-    return get_elements_set().element_2d(element_type_2d(element));
+const element_integrate_2d<T>& mesh_container_2d<T, I>::element_2d(const size_t element, const quadrature_set_t set) const {
+    return get_elements_set().element_2d(element_type_2d(element), set);
 }
 
 template<class T, class I>
@@ -279,8 +293,8 @@ mesh_container_2d<T, I>::element_data_1d mesh_container_2d<T, I>::element_1d_dat
 }
 
 template<class T, class I>
-mesh_container_2d<T, I>::element_data_2d mesh_container_2d<T, I>::element_2d_data(const size_t element) const {
-    return {.mesh = *this, .nodes = nodes(element), .element = element_2d(element)};
+mesh_container_2d<T, I>::element_data_2d mesh_container_2d<T, I>::element_2d_data(const size_t element, const quadrature_set_t set) const {
+    return {.mesh = *this, .nodes = nodes(element), .element = element_2d(element, set)};
 }
 
 template<class T, class I>
@@ -299,13 +313,14 @@ void mesh_container_2d<T, I>::clear() {
 }
 
 template<class T, class I>
-void mesh_container_2d<T, I>::read_from_file(const std::filesystem::path& path_to_mesh) {
+void mesh_container_2d<T, I>::read_from_file(const std::filesystem::path& path_to_mesh, const quadratures_2d& quadratures) {
     const std::string extension = path_to_mesh.extension().string();
     if (extension == ".su2") {
         clear();
         std::ifstream mesh_file{path_to_mesh};
         mesh_parser<T, I, mesh_format::SU2> parser{*this};
         parser.parse(mesh_file);
+        _elements_set->set_quadratures(quadratures);
         return;
     }
     throw std::domain_error{"Unable to read mesh with extension " + extension};
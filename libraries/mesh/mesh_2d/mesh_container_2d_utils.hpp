@@ -5,6 +5,8 @@
 
 #include "nonlocal_constants.hpp"
 
+#include <algorithm>
+
 namespace nonlocal::mesh::utils {
 
 template<class T, class I>
@@ -35,31 +37,62 @@ template<class T, class I, class Shift>
 std::vector<I> quadrature_shifts_2d(const mesh_container_2d<T, I>& mesh, const Shift& shift) {
     std::vector<I> quad_shifts(mesh.elements_2d_count() + 1);
     quad_shifts[0] = 0;
-    for(const size_t e : mesh.elements_2d())
+    for(const size_t e : mesh.elements_2d()) {
+        if (size_t(quad_shifts[e]) + shift(e) > size_t(std::numeric_limits<I>::max()))
+            throw std::overflow_error{"The number of quadrature nodes exceeds the range of the mesh index type."};
         quad_shifts[e + 1] = quad_shifts[e] + shift(e);
+    }
     return quad_shifts;
 }
 
 template<class T, class I>
-std::vector<I> elements_quadrature_shifts_2d(const mesh_container_2d<T, I>& mesh) {
-    return quadrature_shifts_2d(mesh, [&mesh](const size_t e) { return mesh.element_2d(e).qnodes_count(); });
+std::vector<I> elements_quadrature_shifts_2d(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set = quadrature_set_t::LOCAL) {
+    return quadrature_shifts_2d(mesh, [&mesh, set](const size_t e) { return mesh.element_2d(e, set).qnodes_count(); });
 }
 
+// The derivatives of the shape functions of the affine elements are stored once per node
 template<class T, class I>
-std::vector<I> element_node_shits_quadrature_shifts_2d(const mesh_container_2d<T, I>& mesh) {
-    return quadrature_shifts_2d(mesh, [&mesh](const size_t e) { 
-        const auto& el = mesh.element_2d(e);
-        return el.nodes_count() * el.qnodes_count();
+size_t derivatives_count_2d(const mesh_container_2d<T, I>& mesh, const size_t e, const quadrature_set_t set = quadrature_set_t::LOCAL) {
+    return is_affine(mesh.element_type_2d(e)) ? 1 : mesh.element_2d(e, set).qnodes_count();
+}
+
+template<class T, class I>
+std::vector<I> element_node_shits_quadrature_shifts_2d(const mesh_container_2d<T, I>& mesh, const quadrature_set_t set = quadrature_set_t::LOCAL) {
+    return quadrature_shifts_2d(mesh, [&mesh, set](const size_t e) { 
+        return mesh.element_2d(e, set).nodes_count() * derivatives_count_2d(mesh, e, set);
     });
 }
 
+template<class T, class I>
+std::vector<I> elements_nodes_shifts_2d(const mesh_container_2d<T, I>& mesh) {
+    return quadrature_shifts_2d(mesh, [&mesh](const size_t e) { return mesh.element_2d(e).nodes_count(); });
+}
+
+// The largest of the sums above over all quadrature sets, which must fit into the index type of the mesh
+template<class T, class I>
+size_t quadrature_tables_size_2d(const mesh_container_2d<T, I>& mesh) {
+    size_t size = 0;
+    for(const size_t set : std::ranges::iota_view{0u, quadrature_sets_count}) {
+        size_t qnodes = 0, qnodes_nodes = 0;
+        for(const size_t e : mesh.elements_2d()) {
+            const auto& el = mesh.element_2d(e, quadrature_set_t(set));
+            qnodes += el.qnodes_count();
+            qnodes_nodes += el.nodes_count() * derivatives_count_2d(mesh, e, quadrature_set_t(set));
+        }
+        size = std::max({size, qnodes, qnodes_nodes});
+    }
+    return size;
+}
+
 template<template<class, size_t> class Output, class T, class I, class Functor>
-std::vector<Output<T, 2>> approx_in_all_quad_nodes(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts, const Functor& functor) {
+std::vector<Output<T, 2>> approx_in_all_quad_nodes(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts,
+                                                   const Functor& functor, const quadrature_set_t set = quadrature_set_t::LOCAL) {
     if(mesh.elements_2d_count() + 1 != qshifts.size())
         throw std::logic_error{"The number of quadrature shifts and elements does not match."};
     std::vector<Output<T, 2>> data(qshifts.back());
-    for(const size_t e : mesh.elements_2d()) {
-        const auto element_data = mesh.element_2d_data(e);
+#pragma omp parallel for default(none) shared(mesh, qshifts, functor, set, data)
+    for(size_t e = 0; e < mesh.elements_2d_count(); ++e) {
+        const auto element_data = mesh.element_2d_data(e, set);
         for(const size_t q : std::ranges::iota_view{0u, element_data.element.qnodes_count()})
             data[qshifts[e] + q] = functor(element_data, q);
     }
@@ -67,34 +100,38 @@ std::vector<Output<T, 2>> approx_in_all_quad_nodes(const mesh_container_2d<T, I>
 }
 
 template<class T, class I>
-std::vector<std::array<T, 2>> approx_all_quad_nodes(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts) {
+std::vector<std::array<T, 2>> approx_all_quad_nodes(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts,
+                                                    const quadrature_set_t set = quadrature_set_t::LOCAL) {
     return approx_in_all_quad_nodes<std::array>(mesh, qshifts, 
-        [](const auto& element_data, const size_t q) { return element_data.quad_coord(q); });
+        [](const auto& element_data, const size_t q) { return element_data.quad_coord(q); }, set);
 }
 
 template<class T, class I>
-std::vector<metamath::types::square_matrix<T, 2>> approx_all_jacobi_matrices(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts) {
+std::vector<metamath::types::square_matrix<T, 2>> approx_all_jacobi_matrices(const mesh_container_2d<T, I>& mesh, const std::vector<I>& qshifts,
+                                                                              const quadrature_set_t set = quadrature_set_t::LOCAL) {
     return approx_in_all_quad_nodes<metamath::types::square_matrix>(mesh, qshifts, 
-        [](const auto& element_data, const size_t q) { return element_data.jacobi_matrix(q); });
+        [](const auto& element_data, const size_t q) { return element_data.jacobi_matrix(q); }, set);
 }
 
 template<class T, class I>
 std::vector<std::array<T, 2>> derivatives_in_quad(const mesh_container_2d<T, I>& mesh,
                                                   const std::vector<I>& quad_element_shifts,
                                                   const std::vector<I>& quad_nodes_shifts,
-                                                  const std::vector<metamath::types::square_matrix<T, 2>>& jacobi_matrices) {
+                                                  const std::vector<metamath::types::square_matrix<T, 2>>& jacobi_matrices,
+                                                  const quadrature_set_t set = quadrature_set_t::LOCAL) {
     if (mesh.elements_2d_count() + 1 != quad_element_shifts.size() || mesh.elements_2d_count() + 1 != quad_nodes_shifts.size())
         throw std::logic_error{"The number of quadrature shifts and elements does not match."};
     if (quad_element_shifts.back() != jacobi_matrices.size())
         throw std::logic_error{"The size of Jacobi matrices vector does not match with the quadratures nodes count."};
     std::vector<std::array<T, 2>> derivatives(quad_nodes_shifts.back());
-#pragma omp parallel for default(none) shared(mesh, quad_element_shifts, quad_nodes_shifts, jacobi_matrices, derivatives)
+#pragma omp parallel for default(none) shared(mesh, quad_element_shifts, quad_nodes_shifts, jacobi_matrices, derivatives, set)
     for(size_t e = 0; e < mesh.elements_2d_count(); ++e) {
-        const auto& el = mesh.element_2d(e);
+        const auto& el = mesh.element_2d(e, set);
+        const size_t derivatives_count = derivatives_count_2d(mesh, e, set);
         for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()})
-            for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
+            for(const size_t q : std::ranges::iota_view{0u, derivatives_count}) {
                 const metamath::types::square_matrix<T, 2>& J = jacobi_matrices[quad_element_shifts[e] + q];
-                derivatives[quad_nodes_shifts[e] + i * el.qnodes_count() + q] = {
+                derivatives[quad_nodes_shifts[e] + i * derivatives_count + q] = {
                      el.qNxi(i, q) * J[1][1] - el.qNeta(i, q) * J[1][0],
                     -el.qNxi(i, q) * J[0][1] + el.qNeta(i, q) * J[0][0]
                 };
@@ -103,6 +140,27 @@ std::vector<std::array<T, 2>> derivatives_in_quad(const mesh_container_2d<T, I>&
     return derivatives;
 }
 
+// Integrals of the shape functions gradients over elements
+template<class T, class I>
+std::vector<std::array<T, 2>> gradient_integrals_2d(const mesh_container_2d<T, I>& mesh,
+                                                   const std::vector<I>& nodes_shifts,
+                                                   const std::vector<I>& quad_nodes_shifts,
+                                                   const std::vector<std::array<T, 2>>& derivatives) {
+    std::vector<std::array<T, 2>> integrals(nodes_shifts.back(), std::array<T, 2>{});
+#pragma omp parallel for default(none) shared(mesh, nodes_shifts, quad_nodes_shifts, derivatives, integrals)
+    for(size_t e = 0; e < mesh.elements_2d_count(); ++e) {
+        const auto& el = mesh.element_2d(e);
+        const size_t derivatives_count = derivatives_count_2d(mesh, e);
+        for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()})
+            for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
+                const std::array<T, 2>& derivative = derivatives[quad_nodes_shifts[e] + i * derivatives_count + (derivatives_count == 1 ? 0 : q)];
+                integrals[nodes_shifts[e] + i][X] += el.weight(q) * derivative[X];
+                integrals[nodes_shifts[e] + i][Y] += el.weight(q) * derivative[Y];
+            }
+    }
+    return integrals;
+}
+
 template<class T, class I>
 std::vector<std::array<T, 2>> approx_centers_of_elements(const mesh_container_2d<T, I>& mesh) {
     std::vector<std::array<T, 2>> centers(mesh.elements_2d_count(), std::array<T, 2>{});
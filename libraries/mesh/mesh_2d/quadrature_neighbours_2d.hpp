@@ -0,0 +1,208 @@
+#ifndef NONLOCAL_QUADRATURE_NEIGHBOURS_2D_HPP
+#define NONLOCAL_QUADRATURE_NEIGHBOURS_2D_HPP
+
+#include "elements_set.hpp"
+#include "reduced_precision.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nonlocal::mesh {
+
+// Compressed rows of the inner quadrature nodes interacting with each outer quadrature node.
+// The rows are numbered by the quadrature shifts of the NONLOCAL_OUTER set and the indices are the shifts of the NONLOCAL_INNER set.
+// The row of the quadrature node qL of the element eL is split into blocks in the same order as mesh_2d::neighbours(eL),
+// the block contains the quadrature shifts of the neighbour nodes with the nonzero influence
+// and the products weight(qNL) * influence(qL, qNL), where weight(qNL) is the weight of the reference element.
+// Pairs of the neighbour elements serve as the spatial index, so only their quadrature nodes are checked.
+// The values can be reduced to reduced_t, then they are accessed as values<reduced_t>.
+template<class T, class I>
+class quadrature_neighbours_2d final {
+    std::vector<size_t> _rows;   // quadrature shift -> first block
+    std::vector<size_t> _blocks; // block -> first entry
+    std::vector<I> _indices;
+    std::vector<T> _values;
+    std::vector<reduced_t> _reduced_values;
+
+    template<class U>
+    const std::vector<U>& table() const noexcept;
+
+public:
+    // Influence functions are specified for the nonlocal groups of elements, other groups get empty rows
+    template<class Mesh, class Influence>
+    void compute(const Mesh& mesh, const std::unordered_map<std::string, Influence>& influences);
+    void clear();
+    void reduce_precision();
+
+    bool empty() const noexcept;
+    bool is_reduced() const noexcept;
+    bool contains(const size_t qshiftL) const noexcept;
+    size_t memory() const noexcept;
+
+    std::span<const I> indices(const size_t qshiftL) const;
+    template<class U = T>
+    std::span<const U> values(const size_t qshiftL) const;
+    std::span<const I> indices(const size_t qshiftL, const size_t neighbour) const;
+    template<class U = T>
+    std::span<const U> values(const size_t qshiftL, const size_t neighbour) const;
+};
+
+template<class T, class I>
+template<class Mesh, class Influence>
+void quadrature_neighbours_2d<T, I>::compute(const Mesh& mesh, const std::unordered_map<std::string, Influence>& influences) {
+    clear();
+    const size_t elements_count = mesh.container().elements_2d_count();
+    using enum quadrature_set_t;
+    const size_t quad_count = mesh.quad_shift(elements_count, NONLOCAL_OUTER);
+    std::vector<std::vector<size_t>> elements_blocks(elements_count); // sizes of the element blocks
+    std::vector<std::vector<I>> elements_indices(elements_count);
+    std::vector<std::vector<T>> elements_values(elements_count);
+    for(const auto& [group, influence] : influences) {
+        const auto elements = mesh.container().elements(group);
+#pragma omp parallel for default(none) shared(mesh, influence, elements, elements_blocks, elements_indices, elements_values) schedule(dynamic)
+        for(size_t eL = elements.front(); eL < *elements.end(); ++eL) {
+            const auto& neighbours = mesh.neighbours(eL);
+            auto& blocks = elements_blocks[eL];
+            auto& indices = elements_indices[eL];
+            auto& values = elements_values[eL];
+            std::vector<T> influences;
+            std::vector<std::array<T, 2>> qcoords_buffer;
+            blocks.reserve(mesh.container().element_2d(eL, NONLOCAL_OUTER).qnodes_count() * neighbours.size());
+            for(const size_t qshiftL : mesh.quad_shifts_count(eL, NONLOCAL_OUTER)) {
+                const std::array<T, 2> qcoordL = mesh.quad_coord(qshiftL, NONLOCAL_OUTER);
+                for(const I eNL : neighbours) {
+                    const auto& elNL = mesh.container().element_2d(eNL, NONLOCAL_INNER);
+                    const size_t size_before = indices.size();
+                    qcoords_buffer.resize(elNL.qnodes_count());
+                    const std::span<const std::array<T, 2>> qcoordsNL = mesh.quad_coords(eNL, qcoords_buffer, NONLOCAL_INNER);
+                    influences.resize(qcoordsNL.size());
+                    if constexpr (requires { influence(qcoordL, qcoordsNL, std::span<T>{influences}); })
+                        influence(qcoordL, qcoordsNL, std::span<T>{influences});
+                    else
+                        for(const size_t qNL : elNL.qnodes())
+                            influences[qNL] = influence(qcoordL, qcoordsNL[qNL]);
+                    for(const size_t qNL : elNL.qnodes())
+                        if (const T value = influences[qNL]; value != T{0}) {
+                            indices.push_back(mesh.quad_shift(eNL, NONLOCAL_INNER) + qNL);
+                            values.push_back(elNL.weight(qNL) * value);
+                        }
+                    blocks.push_back(indices.size() - size_before);
+                }
+            }
+        }
+    }
+
+    _rows.resize(quad_count + 1, 0);
+    std::vector<size_t> blocks_shifts(elements_count + 1, 0), entries_shifts(elements_count + 1, 0);
+    for(const size_t e : std::ranges::iota_view{0u, elements_count}) {
+        const size_t blocks_per_qnode = elements_blocks[e].empty() ? 0 : mesh.neighbours(e).size();
+        for(const size_t qshift : mesh.quad_shifts_count(e, NONLOCAL_OUTER))
+            _rows[qshift + 1] = _rows[qshift] + blocks_per_qnode;
+        blocks_shifts[e + 1] = blocks_shifts[e] + elements_blocks[e].size();
+        entries_shifts[e + 1] = entries_shifts[e] + elements_indices[e].size();
+    }
+    _blocks.resize(blocks_shifts.back() + 1);
+    _indices.resize(entries_shifts.back());
+    _values.resize(entries_shifts.back());
+#pragma omp parallel for default(none) shared(elements_count, blocks_shifts, entries_shifts, elements_blocks, elements_indices, elements_values)
+    for(size_t e = 0; e < elements_count; ++e) {
+        size_t entry = entries_shifts[e];
+        for(const size_t b : std::ranges::iota_view{0u, elements_blocks[e].size()}) {
+            _blocks[blocks_shifts[e] + b] = entry;
+            entry += elements_blocks[e][b];
+        }
+        std::copy(elements_indices[e].begin(), elements_indices[e].end(), std::next(_indices.begin(), entries_shifts[e]));
+        std::copy(elements_values[e].begin(), elements_values[e].end(), std::next(_values.begin(), entries_shifts[e]));
+        elements_blocks[e] = {};
+        elements_indices[e] = {};
+        elements_values[e] = {};
+    }
+    _blocks.back() = entries_shifts.back();
+}
+
+template<class T, class I>
+void quadrature_neighbours_2d<T, I>::clear() {
+    _rows.clear();
+    _rows.shrink_to_fit();
+    _blocks.clear();
+    _blocks.shrink_to_fit();
+    _indices.clear();
+    _indices.shrink_to_fit();
+    _values.clear();
+    _values.shrink_to_fit();
+    _reduced_values.clear();
+    _reduced_values.shrink_to_fit();
+}
+
+template<class T, class I>
+void quadrature_neighbours_2d<T, I>::reduce_precision() {
+    if constexpr (!std::is_same_v<T, reduced_t>)
+        if (!is_reduced())
+            _reduced_values = mesh::reduce_precision(_values);
+}
+
+template<class T, class I>
+template<class U>
+const std::vector<U>& quadrature_neighbours_2d<T, I>::table() const noexcept {
+    if constexpr (std::is_same_v<U, T>)
+        return _values;
+    else
+        return _reduced_values;
+}
+
+template<class T, class I>
+bool quadrature_neighbours_2d<T, I>::empty() const noexcept {
+    return _rows.empty();
+}
+
+template<class T, class I>
+bool quadrature_neighbours_2d<T, I>::is_reduced() const noexcept {
+    return !_reduced_values.empty();
+}
+
+template<class T, class I>
+bool quadrature_neighbours_2d<T, I>::contains(const size_t qshiftL) const noexcept {
+    return qshiftL + 1 < _rows.size() && _rows[qshiftL] != _rows[qshiftL + 1];
+}
+
+template<class T, class I>
+size_t quadrature_neighbours_2d<T, I>::memory() const noexcept {
+    return (_rows.size() + _blocks.size()) * sizeof(size_t) + _indices.size() * sizeof(I) +
+           _values.size() * sizeof(T) + _reduced_values.size() * sizeof(reduced_t);
+}
+
+template<class T, class I>
+std::span<const I> quadrature_neighbours_2d<T, I>::indices(const size_t qshiftL) const {
+    return {_indices.data() + _blocks[_rows[qshiftL]], _indices.data() + _blocks[_rows[qshiftL + 1]]};
+}
+
+template<class T, class I>
+template<class U>
+std::span<const U> quadrature_neighbours_2d<T, I>::values(const size_t qshiftL) const {
+    const std::vector<U>& values = table<U>();
+    return {values.data() + _blocks[_rows[qshiftL]], values.data() + _blocks[_rows[qshiftL + 1]]};
+}
+
+template<class T, class I>
+std::span<const I> quadrature_neighbours_2d<T, I>::indices(const size_t qshiftL, const size_t neighbour) const {
+    const size_t block = _rows[qshiftL] + neighbour;
+    return {_indices.data() + _blocks[block], _indices.data() + _blocks[block + 1]};
+}
+
+template<class T, class I>
+template<class U>
+std::span<const U> quadrature_neighbours_2d<T, I>::values(const size_t qshiftL, const size_t neighbour) const {
+    const std::vector<U>& values = table<U>();
+    const size_t block = _rows[qshiftL] + neighbour;
+    return {values.data() + _blocks[block], values.data() + _blocks[block + 1]};
+}
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef NONLOCAL_REDUCED_PRECISION_HPP
+#define NONLOCAL_REDUCED_PRECISION_HPP
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace nonlocal::mesh {
+
+// The type of the tables stored with the reduced precision, the integrals are accumulated in T anyway
+using reduced_t = float;
+
+// The scalars and the fixed size arrays of them, such as the coordinates and the Jacobi matrices, with the scalar type U
+template<class U, class T>
+struct with_precision final {
+    using type = U;
+};
+
+template<class U, class T, size_t N>
+struct with_precision<U, std::array<T, N>> final {
+    using type = std::array<typename with_precision<U, T>::type, N>;
+};
+
+template<class U, class T>
+using with_precision_t = typename with_precision<U, T>::type;
+
+template<class U, class T>
+constexpr with_precision_t<U, T> precision_cast(const T& value) {
+    if constexpr (std::is_arithmetic_v<T>)
+        return U(value);
+    else {
+        with_precision_t<U, T> result;
+        std::ranges::transform(value, result.begin(), [](const auto& component) { return precision_cast<U>(component); });
+        return result;
+    }
+}
+
+// Converts the table to the reduced precision and releases the original one
+template<class T>
+std::vector<with_precision_t<reduced_t, T>> reduce_precision(std::vector<T>& values) {
+    std::vector<with_precision_t<reduced_t, T>> reduced(values.size());
+    std::ranges::transform(values, reduced.begin(), [](const T& value) { return precision_cast<reduced_t>(value); });
+    values = {};
+    return reduced;
+}
+
+// The callback gets std::type_identity of the stored type, so the hot loops are instantiated for both precisions
+// and the precision is checked once per element instead of once per value
+template<class T, class Callback>
+void visit_precision(const bool is_reduced, Callback&& callback) {
+    if (is_reduced)
+        callback(std::type_identity<reduced_t>{});
+    else
+        callback(std::type_identity<T>{});
+}
+
+}
+
+#endif
\ No newline at end of file
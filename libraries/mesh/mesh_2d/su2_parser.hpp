@@ -20,6 +20,7 @@ class mesh_parser<T, I, mesh_format::SU2> final {
     auto read_nodes(Stream& mesh_file);
     template<class Stream>
     auto read_elements_groups(Stream& mesh_file);
+    void sort_by_types(const std::ranges::iota_view<size_t, size_t> elements);
 
 public:
     explicit mesh_parser(mesh_container_2d<T, I>& mesh) noexcept;
@@ -131,6 +132,26 @@ auto mesh_parser<T, I, mesh_format::SU2>::read_elements_groups(Stream& mesh_file
     return std::make_tuple(std::move(groups_names), std::move(elements_in_groups), std::move(types_in_groups));
 }
 
+template<class T, class I>
+void mesh_parser<T, I, mesh_format::SU2>::sort_by_types(const std::ranges::iota_view<size_t, size_t> elements) {
+    const auto types_begin = std::next(_mesh._elements_types.begin(), elements.front());
+    const auto types_end = std::next(_mesh._elements_types.begin(), *elements.end());
+    if (std::is_sorted(types_begin, types_end))
+        return;
+    std::vector<size_t> permutation(elements.begin(), elements.end());
+    std::stable_sort(permutation.begin(), permutation.end(), [this](const size_t lhs, const size_t rhs) {
+        return _mesh._elements_types[lhs] < _mesh._elements_types[rhs];
+    });
+    std::vector<std::vector<I>> sorted_elements(permutation.size());
+    std::vector<uint8_t> sorted_types(permutation.size());
+    for(const size_t e : std::ranges::iota_view{0u, permutation.size()}) {
+        sorted_elements[e] = std::move(_mesh._elements[permutation[e]]);
+        sorted_types[e] = _mesh._elements_types[permutation[e]];
+    }
+    std::move(sorted_elements.begin(), sorted_elements.end(), std::next(_mesh._elements.begin(), elements.front()));
+    std::copy(sorted_types.begin(), sorted_types.end(), types_begin);
+}
+
 template<class T, class I>
 template<class Stream>
 void mesh_parser<T, I, mesh_format::SU2>::parse(Stream& mesh_file) {
@@ -197,6 +218,9 @@ void mesh_parser<T, I, mesh_format::SU2>::parse(Stream& mesh_file) {
                 }
             }
     }
+
+    for(const std::string& group : _mesh._groups_2d)
+        sort_by_types(_mesh._elements_groups[group]);
 }
 
 }
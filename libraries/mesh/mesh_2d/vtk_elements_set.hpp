@@ -24,6 +24,8 @@ class vtk_elements_set final : public elements_set<T> {
     using quadrature = metamath::finite_element::quadrature_1d<U, Quadrature_Type, Args...>;
     template<class U, size_t N>
     using gauss = metamath::finite_element::gauss<U, N>;
+    template<class U, size_t Degree>
+    using dunavant = metamath::finite_element::dunavant<U, Degree>;
 
     template<class U, template<class, auto...> class Element_Type, auto... Args>
     using element_1d_integrate = metamath::finite_element::element_1d_integrate<U, Element_Type, Args...>;
@@ -45,11 +47,42 @@ class vtk_elements_set final : public elements_set<T> {
     }
 
     static std::vector<finite_element_2d_sptr<T>> make_default_2d_elements() {
-        return { std::make_shared<element_2d_integrate<T, triangle, 1>>(quadrature<T, gauss, 1>{}),
-                 std::make_shared<element_2d_integrate<T, triangle, 2>>(quadrature<T, gauss, 2>{}),
-                 std::make_shared<element_2d_integrate<T, serendipity, 1>>(quadrature<T, gauss, 2>{}),
-                 std::make_shared<element_2d_integrate<T, serendipity, 2>>(quadrature<T, gauss, 3>{}),
-                 std::make_shared<element_2d_integrate<T, lagrangian_element_2d, 2, 2>>(quadrature<T, gauss, 3>{}) };
+        using enum element_2d_t;
+        return { std::make_shared<element_2d_integrate<T, triangle, 1>>(default_element_2d_tables_t<T, TRIANGLE>{}),
+                 std::make_shared<element_2d_integrate<T, triangle, 2>>(default_element_2d_tables_t<T, QUADRATIC_TRIANGLE>{}),
+                 std::make_shared<element_2d_integrate<T, serendipity, 1>>(default_element_2d_tables_t<T, BILINEAR>{}),
+                 std::make_shared<element_2d_integrate<T, serendipity, 2>>(default_element_2d_tables_t<T, QUADRATIC_SERENDIPITY>{}),
+                 std::make_shared<element_2d_integrate<T, lagrangian_element_2d, 2, 2>>(default_element_2d_tables_t<T, QUADRATIC_LAGRANGE>{}) };
+    }
+
+    template<template<class, auto...> class Element_Type, auto... Args>
+    static finite_element_2d_sptr<T> make_quadrilateral(const size_t order) {
+        using element_t = element_2d_integrate<T, Element_Type, Args...>;
+        using metamath::finite_element::quadrature_1d;
+        switch (order) {
+        case 1: return std::make_shared<element_t>(quadrature_1d<T, gauss, 1>{});
+        case 2: return std::make_shared<element_t>(quadrature_1d<T, gauss, 2>{});
+        case 3: return std::make_shared<element_t>(quadrature_1d<T, gauss, 3>{});
+        case 4: return std::make_shared<element_t>(quadrature_1d<T, gauss, 4>{});
+        case 5: return std::make_shared<element_t>(quadrature_1d<T, gauss, 5>{});
+        default:
+            throw std::domain_error{"Unsupported quadrature order of the quadrilateral: " + std::to_string(order)};
+        }
+    }
+
+    template<template<class, auto...> class Element_Type, auto... Args>
+    static finite_element_2d_sptr<T> make_triangle(const size_t order) {
+        using element_t = element_2d_integrate<T, Element_Type, Args...>;
+        using metamath::finite_element::quadrature_2d;
+        switch (order) {
+        case 1: return std::make_shared<element_t>(quadrature_2d<T, dunavant, 1>{});
+        case 2: return std::make_shared<element_t>(quadrature_2d<T, dunavant, 2>{});
+        case 3: return std::make_shared<element_t>(quadrature_2d<T, dunavant, 3>{});
+        case 4: return std::make_shared<element_t>(quadrature_2d<T, dunavant, 4>{});
+        case 5: return std::make_shared<element_t>(quadrature_2d<T, dunavant, 5>{});
+        default:
+            throw std::domain_error{"Unsupported quadrature order of the triangle: " + std::to_string(order)};
+        }
     }
 
     static std::unordered_map<size_t, element_1d_t> vtk_to_local_1d() {
@@ -69,6 +102,24 @@ class vtk_elements_set final : public elements_set<T> {
         };
     }
 
+protected:
+    finite_element_2d_sptr<T> make_element_2d(const element_2d_t local, const size_t quadrature_order) const override {
+        switch (local) {
+        case element_2d_t::TRIANGLE:
+            return make_triangle<triangle, 1>(quadrature_order);
+        case element_2d_t::QUADRATIC_TRIANGLE:
+            return make_triangle<triangle, 2>(quadrature_order);
+        case element_2d_t::BILINEAR:
+            return make_quadrilateral<serendipity, 1>(quadrature_order);
+        case element_2d_t::QUADRATIC_SERENDIPITY:
+            return make_quadrilateral<serendipity, 2>(quadrature_order);
+        case element_2d_t::QUADRATIC_LAGRANGE:
+            return make_quadrilateral<lagrangian_element_2d, 2, 2>(quadrature_order);
+        default:
+            throw std::domain_error{"Unknown element type: " + std::to_string(size_t(local))};
+        }
+    }
+
 public:
     explicit vtk_elements_set()
         : elements_set<T>{make_default_1d_elements(), 
@@ -115,7 +115,9 @@ protected:
         -(_1-y*y) * (_1-x) * ((_9*p-_5)          + (_9*p+_3)*x  ) / _16
     );
 
-    explicit serendipity() : _base{T{2} / T{9}} {}
+    static inline constexpr T default_parameter = T{2} / T{9};
+
+    explicit serendipity() : _base{default_parameter} {}
     ~serendipity() override = default;
 };
 
@@ -177,7 +179,9 @@ protected:
         -(_1-x  ) * (_1-y*y) * (_54*y        + (_18*p+_9)*x          + _18*p - _9) / _64
     );
 
-    explicit serendipity() : _base{T{1} / T{8}} {}
+    static inline constexpr T default_parameter = T{1} / T{8};
+
+    explicit serendipity() : _base{default_parameter} {}
     ~serendipity() override = default;
 };
 
@@ -3,6 +3,7 @@
 
 #include "element_2d_integrate_base.hpp"
 #include "element_2d_serendipity.hpp"
+#include "element_2d_tables.hpp"
 
 namespace metamath::finite_element {
 
@@ -17,6 +18,7 @@ protected:
     using element_integrate_2d_t::_qN;
     using element_integrate_2d_t::_qNxi;
     using element_integrate_2d_t::_qNeta;
+    using element_integrate_2d_t::_tensor_product;
 
 public:
     using element_integrate_2d_t::qnodes_count;
@@ -35,6 +37,25 @@ public:
         set_quadrature(quadrature_x, quadrature_y);
     }
 
+    explicit element_2d_integrate(const quadrature_2d_base<T>& quadrature) {
+        set_quadrature(quadrature);
+    }
+
+    // The default quadratures are set from the tables computed at compile time
+    template<class Quadrature>
+    explicit element_2d_integrate(const element_2d_tables<T, Quadrature, Element_Type, Args...>) {
+        using tables_t = element_2d_tables<T, Quadrature, Element_Type, Args...>;
+        _weights.assign(tables_t::weights.begin(), tables_t::weights.end());
+        _qN.assign(tables_t::qN.begin(), tables_t::qN.end());
+        _qNxi.assign(tables_t::qNxi.begin(), tables_t::qNxi.end());
+        _qNeta.assign(tables_t::qNeta.begin(), tables_t::qNeta.end());
+        _nearest_qnode.assign(tables_t::nearest_qnode.begin(), tables_t::nearest_qnode.end());
+        if constexpr (tables_t::is_product)
+            _tensor_product = tensor_product_2d<T>::factorize(static_cast<const element_integrate_2d_t&>(*this), tables_t::quadrature_nodes_count, tables_t::quadrature_nodes_count);
+        else
+            _tensor_product.reset();
+    }
+
     ~element_2d_integrate() override = default;
 
     void set_quadrature(const quadrature_1d_base<T>& quadrature_x, const quadrature_1d_base<T>& quadrature_y) override {
@@ -42,7 +63,7 @@ public:
                        (quadrature_x.boundary(side_1d::RIGHT   ) - quadrature_x.boundary(side_1d::LEFT   ));
         std::vector<T> jacobian_y(quadrature_x.nodes_count());
         std::vector<T> x(quadrature_x.nodes_count());
-        std::vector<T> y(quadrature_y.nodes_count());
+        std::vector<T> y(quadrature_x.nodes_count() * quadrature_y.nodes_count());
 
         _weights.resize(quadrature_x.nodes_count() * quadrature_y.nodes_count());
         for(size_t i = 0; i < quadrature_x.nodes_count(); ++i) {
@@ -50,7 +71,7 @@ public:
             jacobian_y[i] = (             boundary(side_2d::UP,  x[i]) -              boundary(side_2d::DOWN, x[i])) /
                             (quadrature_y.boundary(side_1d::RIGHT    ) - quadrature_y.boundary(side_1d::LEFT      ));
             for(size_t j = 0; j < quadrature_y.nodes_count(); ++j) {
-                y[j] = boundary(side_2d::DOWN, x[i]) + (quadrature_y.node(j)-quadrature_y.boundary(side_1d::LEFT)) * jacobian_y[i];
+                y[i*quadrature_y.nodes_count() + j] = boundary(side_2d::DOWN, x[i]) + (quadrature_y.node(j)-quadrature_y.boundary(side_1d::LEFT)) * jacobian_y[i];
                 _weights[i*quadrature_y.nodes_count() + j] = quadrature_x.weight(i) * jacobian_x * quadrature_y.weight(j) * jacobian_y[i];
             }
         }
@@ -64,16 +85,46 @@ public:
             T length = std::numeric_limits<T>::max();
             for(size_t j = 0; j < quadrature_x.nodes_count(); ++j)
                 for(size_t k = 0; k < quadrature_y.nodes_count(); ++k) {
-                    _qN   [i*qnodes_count() + j*quadrature_y.nodes_count() + k] = N   (i, {x[j], y[k]});
-                    _qNxi [i*qnodes_count() + j*quadrature_y.nodes_count() + k] = Nxi (i, {x[j], y[k]});
-                    _qNeta[i*qnodes_count() + j*quadrature_y.nodes_count() + k] = Neta(i, {x[j], y[k]});
-                    if (const T curr_length = functions::distance(node(i), {x[j], y[k]}); length > curr_length) {
+                    const std::array<T, 2> qnode = {x[j], y[j*quadrature_y.nodes_count() + k]};
+                    _qN   [i*qnodes_count() + j*quadrature_y.nodes_count() + k] = N   (i, qnode);
+                    _qNxi [i*qnodes_count() + j*quadrature_y.nodes_count() + k] = Nxi (i, qnode);
+                    _qNeta[i*qnodes_count() + j*quadrature_y.nodes_count() + k] = Neta(i, qnode);
+                    if (const T curr_length = functions::distance(node(i), qnode); length > curr_length) {
                         length = curr_length;
                         nearest_quadrature = j*quadrature_y.nodes_count() + k;
                     }
                 }
             _nearest_qnode[i] = nearest_quadrature;
         }
+        _tensor_product = tensor_product_2d<T>::factorize(static_cast<const element_integrate_2d_t&>(*this), quadrature_x.nodes_count(), quadrature_y.nodes_count());
+    }
+
+    // The nodes of the quadrature are taken as is, so they must be given in the reference element coordinates
+    void set_quadrature(const quadrature_2d_base<T>& quadrature) override {
+        _weights.resize(quadrature.nodes_count());
+        for(size_t q = 0; q < quadrature.nodes_count(); ++q)
+            _weights[q] = quadrature.weight(q);
+
+        _nearest_qnode.resize(element_2d_t::nodes_count());
+        _qN.resize(element_2d_t::nodes_count() * qnodes_count());
+        _qNxi.resize(element_2d_t::nodes_count() * qnodes_count());
+        _qNeta.resize(element_2d_t::nodes_count() * qnodes_count());
+        for(size_t i = 0; i < nodes_count(); ++i) {
+            size_t nearest_quadrature = 0;
+            T length = std::numeric_limits<T>::max();
+            for(size_t q = 0; q < qnodes_count(); ++q) {
+                const std::array<T, 2>& qnode = quadrature.node(q);
+                _qN   [i*qnodes_count() + q] = N   (i, qnode);
+                _qNxi [i*qnodes_count() + q] = Nxi (i, qnode);
+                _qNeta[i*qnodes_count() + q] = Neta(i, qnode);
+                if (const T curr_length = functions::distance(node(i), qnode); length > curr_length) {
+                    length = curr_length;
+                    nearest_quadrature = q;
+                }
+            }
+            _nearest_qnode[i] = nearest_quadrature;
+        }
+        _tensor_product.reset();
     }
 };
 
@@ -4,6 +4,8 @@
 #include "finite_element_integrate_base.hpp"
 #include "element_2d_base.hpp"
 #include "quadrature_1d_base.hpp"
+#include "quadrature_2d_base.hpp"
+#include "tensor_product_2d.hpp"
 
 namespace metamath::finite_element {
 
@@ -12,6 +14,7 @@ class element_2d_integrate_base : public element_integrate_base<T>,
                                   public virtual element_2d_base<T> {
 protected:
     std::vector<T> _qNxi, _qNeta;
+    std::optional<tensor_product_2d<T>> _tensor_product;
 
 public:
     using element_integrate_base<T>::nodes_count;
@@ -27,9 +30,13 @@ public:
     ~element_2d_integrate_base() override = default;
 
     virtual void set_quadrature(const quadrature_1d_base<T>& quadrature_x, const quadrature_1d_base<T>& quadrature_y) = 0;
+    virtual void set_quadrature(const quadrature_2d_base<T>& quadrature) = 0;
 
     T qNxi (const size_t i, const size_t q) const noexcept { return _qNxi [i*qnodes_count() + q]; }
     T qNeta(const size_t i, const size_t q) const noexcept { return _qNeta[i*qnodes_count() + q]; }
+
+    // Exists for the tensor product elements with the product quadratures
+    const std::optional<tensor_product_2d<T>>& tensor_product() const noexcept { return _tensor_product; }
 };
 
 }
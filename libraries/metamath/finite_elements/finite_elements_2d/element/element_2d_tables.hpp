@@ -0,0 +1,169 @@
+#ifndef FINITE_ELEMENT_2D_TABLES_HPP
+#define FINITE_ELEMENT_2D_TABLES_HPP
+
+#include "derivative.hpp"
+#include "simplify.hpp"
+#include "gaussian_quadrature.hpp"
+#include "dunavant_quadrature.hpp"
+
+#include <array>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace metamath::finite_element {
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+class element_2d_tabulation final {
+    struct element_t : Element_Type<T, Args...> {
+        using Element_Type<T, Args...>::x;
+        using Element_Type<T, Args...>::y;
+        using Element_Type<T, Args...>::basis;
+        using Element_Type<T, Args...>::nodes;
+        static constexpr const auto& boundaries = Element_Type<T, Args...>::shape_t::boundary;
+
+        // The parametric elements get their default parameters as the additional argument
+        static constexpr auto arguments(const std::array<T, 2>& xi) {
+            if constexpr (requires { Element_Type<T, Args...>::default_parameter; })
+                return std::array{xi[0], xi[1], Element_Type<T, Args...>::default_parameter};
+            else
+                return xi;
+        }
+    };
+
+    // The 1D quadratures are applied in the both directions, the 2D quadratures already have the nodes in the reference element
+    struct quadrature_t : Quadrature {
+        using Quadrature::nodes;
+        using Quadrature::weights;
+        static constexpr bool is_product = std::is_same_v<std::remove_cvref_t<decltype(Quadrature::nodes[0])>, T>;
+        static constexpr T boundaries(const size_t i) requires is_product { return Quadrature::shape_t::boundary[i]; }
+    };
+
+    template<class Basis, size_t... I>
+    static constexpr auto tabulate(const Basis& basis, const std::index_sequence<I...>);
+
+    static constexpr T boundary(const side_2d bound, const T x);
+    static constexpr T jacobian_x();
+    static constexpr T jacobian_y(const T x);
+    static constexpr std::array<T, 2> qnode(const size_t q);
+
+public:
+    static constexpr bool is_product = quadrature_t::is_product;
+    static constexpr size_t quadrature_nodes_count = quadrature_t::nodes.size();
+    static constexpr size_t nodes_count = element_t::nodes.size();
+    static constexpr size_t qnodes_count = quadrature_t::is_product ? quadrature_nodes_count * quadrature_nodes_count : quadrature_nodes_count;
+
+    static constexpr std::array<T, qnodes_count> weights();
+    static constexpr std::array<T, nodes_count * qnodes_count> qN();
+    static constexpr std::array<T, nodes_count * qnodes_count> qNxi();
+    static constexpr std::array<T, nodes_count * qnodes_count> qNeta();
+    static constexpr std::array<size_t, nodes_count> nearest_qnode();
+};
+
+// Basis functions and their derivatives tabulated at compile time in the nodes of the quadrature.
+// The 1D quadratures such as gauss<T, N> are taken in the product, the 2D quadratures such as dunavant<T, Degree> are taken as is.
+// The nodes, weights and tables are the same as element_2d_integrate::set_quadrature computes for the corresponding quadrature_1d or quadrature_2d.
+// The parametric elements are tabulated with their default parameters.
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+struct element_2d_tables final {
+    using tabulation_t = element_2d_tabulation<T, Quadrature, Element_Type, Args...>;
+
+    static constexpr bool is_product = tabulation_t::is_product;
+    static constexpr size_t quadrature_nodes_count = tabulation_t::quadrature_nodes_count; // in each direction for the product quadratures
+    static constexpr size_t nodes_count = tabulation_t::nodes_count;
+    static constexpr size_t qnodes_count = tabulation_t::qnodes_count;
+    static constexpr std::array<T, qnodes_count> weights = tabulation_t::weights();
+    static constexpr std::array<T, nodes_count * qnodes_count> qN = tabulation_t::qN();
+    static constexpr std::array<T, nodes_count * qnodes_count> qNxi = tabulation_t::qNxi();
+    static constexpr std::array<T, nodes_count * qnodes_count> qNeta = tabulation_t::qNeta();
+    static constexpr std::array<size_t, nodes_count> nearest_qnode = tabulation_t::nearest_qnode();
+};
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr T element_2d_tabulation<T, Quadrature, Element_Type, Args...>::boundary(const side_2d bound, const T x) {
+    return element_t::boundaries[size_t(bound)](x);
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr T element_2d_tabulation<T, Quadrature, Element_Type, Args...>::jacobian_x() {
+    return (boundary(side_2d::RIGHT, 0) - boundary(side_2d::LEFT, 0)) / (quadrature_t::boundaries(1) - quadrature_t::boundaries(0));
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr T element_2d_tabulation<T, Quadrature, Element_Type, Args...>::jacobian_y(const T x) {
+    return (boundary(side_2d::UP, x) - boundary(side_2d::DOWN, x)) / (quadrature_t::boundaries(1) - quadrature_t::boundaries(0));
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr std::array<T, 2> element_2d_tabulation<T, Quadrature, Element_Type, Args...>::qnode(const size_t q) {
+    if constexpr (quadrature_t::is_product) {
+        const T x = boundary(side_2d::LEFT, 0) + (quadrature_t::nodes[q / quadrature_nodes_count] - quadrature_t::boundaries(0)) * jacobian_x();
+        const T y = boundary(side_2d::DOWN, x) + (quadrature_t::nodes[q % quadrature_nodes_count] - quadrature_t::boundaries(0)) * jacobian_y(x);
+        return {x, y};
+    } else
+        return quadrature_t::nodes[q];
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+template<class Basis, size_t... I>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::tabulate(
+    const Basis& basis, const std::index_sequence<I...>) {
+    std::array<T, sizeof...(I) * qnodes_count> table = {};
+    for(size_t q = 0; q < qnodes_count; ++q) {
+        const auto arguments = element_t::arguments(qnode(q));
+        ((table[I * qnodes_count + q] = T(std::get<I>(basis)(arguments))), ...);
+    }
+    return table;
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::weights() -> std::array<T, qnodes_count> {
+    if constexpr (quadrature_t::is_product) {
+        std::array<T, qnodes_count> weights = {};
+        for(size_t i = 0; i < quadrature_nodes_count; ++i) {
+            const T x = boundary(side_2d::LEFT, 0) + (quadrature_t::nodes[i] - quadrature_t::boundaries(0)) * jacobian_x();
+            for(size_t j = 0; j < quadrature_nodes_count; ++j)
+                weights[i * quadrature_nodes_count + j] = quadrature_t::weights[i] * jacobian_x() * quadrature_t::weights[j] * jacobian_y(x);
+        }
+        return weights;
+    } else
+        return quadrature_t::weights;
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::qN() -> std::array<T, nodes_count * qnodes_count> {
+    return tabulate(symbolic::simplify(element_t::basis), std::make_index_sequence<nodes_count>{});
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::qNxi() -> std::array<T, nodes_count * qnodes_count> {
+    return tabulate(symbolic::simplify(symbolic::derivative<element_t::x>(element_t::basis)), std::make_index_sequence<nodes_count>{});
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::qNeta() -> std::array<T, nodes_count * qnodes_count> {
+    return tabulate(symbolic::simplify(symbolic::derivative<element_t::y>(element_t::basis)), std::make_index_sequence<nodes_count>{});
+}
+
+template<class T, class Quadrature, template<class, auto...> class Element_Type, auto... Args>
+constexpr auto element_2d_tabulation<T, Quadrature, Element_Type, Args...>::nearest_qnode() -> std::array<size_t, nodes_count> {
+    std::array<size_t, nodes_count> nearest_qnode = {};
+    for(size_t i = 0; i < nodes_count; ++i) {
+        T length = std::numeric_limits<T>::max();
+        for(size_t q = 0; q < qnodes_count; ++q) {
+            const std::array<T, 2> point = qnode(q);
+            const T dx = point[0] - element_t::nodes[i][0];
+            const T dy = point[1] - element_t::nodes[i][1];
+            if (const T curr_length = dx * dx + dy * dy; length > curr_length) {
+                length = curr_length;
+                nearest_qnode[i] = q;
+            }
+        }
+    }
+    return nearest_qnode;
+}
+
+}
+
+#endif
\ No newline at end of file
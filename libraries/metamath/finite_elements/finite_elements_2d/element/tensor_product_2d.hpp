@@ -0,0 +1,315 @@
+#ifndef FINITE_ELEMENT_TENSOR_PRODUCT_2D_HPP
+#define FINITE_ELEMENT_TENSOR_PRODUCT_2D_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace metamath::finite_element {
+
+// Factorization of the basis of the tensor product element in the nodes of the product quadrature
+// N_i(xi_qx, eta_qy) = X_a(xi_qx) * Y_b(eta_qy), where i = node(a, b) and q = qx * qnodes_y + qy.
+// The interpolation of the nodal values into all quadrature nodes is sum factorized,
+// so it takes (nodes_x + qnodes_y) * nodes_y * qnodes_x operations instead of nodes_x * nodes_y * qnodes_x * qnodes_y.
+// The element matrices are sum factorized in the same way, the contraction in the direction y is done first
+// and each entry takes O(qnodes_x) operations instead of O(qnodes_x * qnodes_y).
+template<class T>
+class tensor_product_2d final {
+    size_t _nodes_x = 0;
+    size_t _nodes_y = 0;
+    size_t _qnodes_x = 0;
+    size_t _qnodes_y = 0;
+    std::vector<size_t> _nodes; // a * nodes_y + b
+    std::vector<T> _X, _dX;     // a * qnodes_x + qx
+    std::vector<T> _Y, _dY;     // b * qnodes_y + qy
+
+    static std::vector<T> grid(std::vector<T> coordinates);
+    static std::optional<size_t> find(const std::vector<T>& grid, const T coordinate);
+    static bool is_equal(const T lhs, const T rhs);
+
+    explicit tensor_product_2d() noexcept = default;
+
+public:
+    // The nodes must form the full grid and the tables must be the products of the one-dimensional factors.
+    // The factors are recovered from the tables by the partition of unity and then checked in all nodes and quadrature nodes.
+    template<class Element>
+    static std::optional<tensor_product_2d> factorize(const Element& element, const size_t qnodes_x, const size_t qnodes_y);
+
+    size_t nodes_x() const noexcept;
+    size_t nodes_y() const noexcept;
+    size_t qnodes_x() const noexcept;
+    size_t qnodes_y() const noexcept;
+    size_t node(const size_t a, const size_t b) const;
+
+    T X (const size_t a, const size_t qx) const;
+    T dX(const size_t a, const size_t qx) const;
+    T Y (const size_t b, const size_t qy) const;
+    T dY(const size_t b, const size_t qy) const;
+
+    // Values and derivatives with respect to xi and eta of the interpolation of the nodal values(i) in all quadrature nodes.
+    // The empty outputs are skipped.
+    template<class Values>
+    void interpolate(const Values& values, const std::span<T> value, const std::span<T> dxi, const std::span<T> deta) const;
+
+    // The element matrices are written as matrix[i * nodes_count + j] in the element numbering of the nodes.
+    // The stiffness matrix is sum_q grad_i(q)^T G(q) grad_j(q), where the gradients are taken with respect to xi and eta
+    // and coefficients(q) returns the 2x2 matrix G(q) indexed as G[k][l], so the quadrature weights and the Jacobi matrices
+    // are included in the coefficients. The mass matrix is sum_q c(q) N_i(q) N_j(q), where coefficients(q) returns c(q).
+    template<class Coefficients>
+    void stiffness(const Coefficients& coefficients, const std::span<T> matrix) const;
+    template<class Coefficients>
+    void mass(const Coefficients& coefficients, const std::span<T> matrix) const;
+    // For the small quadratures the integration entry by entry is as fast as the sum factorized element matrices,
+    // the factorization pays off starting from the 4x4 quadratures on the bilinear elements
+    bool is_factorization_efficient() const noexcept;
+};
+
+template<class T>
+std::vector<T> tensor_product_2d<T>::grid(std::vector<T> coordinates) {
+    std::ranges::sort(coordinates);
+    const auto [first, last] = std::ranges::unique(coordinates, is_equal);
+    coordinates.erase(first, last);
+    return coordinates;
+}
+
+template<class T>
+std::optional<size_t> tensor_product_2d<T>::find(const std::vector<T>& grid, const T coordinate) {
+    for(const size_t i : std::ranges::iota_view{0u, grid.size()})
+        if (is_equal(grid[i], coordinate))
+            return i;
+    return std::nullopt;
+}
+
+template<class T>
+bool tensor_product_2d<T>::is_equal(const T lhs, const T rhs) {
+    static constexpr T tolerance = 1000 * std::numeric_limits<T>::epsilon();
+    return std::abs(lhs - rhs) <= tolerance * std::max({T{1}, std::abs(lhs), std::abs(rhs)});
+}
+
+template<class T>
+template<class Element>
+std::optional<tensor_product_2d<T>> tensor_product_2d<T>::factorize(const Element& element, const size_t qnodes_x, const size_t qnodes_y) {
+    if (qnodes_x * qnodes_y != element.qnodes_count())
+        return std::nullopt;
+    std::vector<T> xs(element.nodes_count()), ys(element.nodes_count());
+    for(const size_t i : element.nodes()) {
+        xs[i] = element.node(i)[0];
+        ys[i] = element.node(i)[1];
+    }
+    const std::vector<T> grid_x = grid(std::move(xs));
+    const std::vector<T> grid_y = grid(std::move(ys));
+    if (grid_x.size() * grid_y.size() != element.nodes_count())
+        return std::nullopt;
+
+    tensor_product_2d factorization;
+    factorization._nodes_x = grid_x.size();
+    factorization._nodes_y = grid_y.size();
+    factorization._qnodes_x = qnodes_x;
+    factorization._qnodes_y = qnodes_y;
+    factorization._nodes.assign(element.nodes_count(), element.nodes_count());
+    for(const size_t i : element.nodes()) {
+        const size_t index = *find(grid_x, element.node(i)[0]) * grid_y.size() + *find(grid_y, element.node(i)[1]);
+        if (factorization._nodes[index] != element.nodes_count())
+            return std::nullopt;
+        factorization._nodes[index] = i;
+    }
+
+    factorization._X.assign(grid_x.size() * qnodes_x, T{0});
+    factorization._dX.assign(grid_x.size() * qnodes_x, T{0});
+    factorization._Y.assign(grid_y.size() * qnodes_y, T{0});
+    factorization._dY.assign(grid_y.size() * qnodes_y, T{0});
+    for(const size_t a : std::ranges::iota_view{0u, grid_x.size()})
+        for(const size_t b : std::ranges::iota_view{0u, grid_y.size()}) {
+            const size_t i = factorization.node(a, b);
+            for(const size_t qx : std::ranges::iota_view{0u, qnodes_x}) {
+                factorization._X [a * qnodes_x + qx] += element.qN  (i, qx * qnodes_y);
+                factorization._dX[a * qnodes_x + qx] += element.qNxi(i, qx * qnodes_y);
+            }
+            for(const size_t qy : std::ranges::iota_view{0u, qnodes_y}) {
+                factorization._Y [b * qnodes_y + qy] += element.qN   (i, qy);
+                factorization._dY[b * qnodes_y + qy] += element.qNeta(i, qy);
+            }
+        }
+
+    for(const size_t a : std::ranges::iota_view{0u, grid_x.size()})
+        for(const size_t b : std::ranges::iota_view{0u, grid_y.size()})
+            for(const size_t qx : std::ranges::iota_view{0u, qnodes_x})
+                for(const size_t qy : std::ranges::iota_view{0u, qnodes_y}) {
+                    const size_t i = factorization.node(a, b);
+                    const size_t q = qx * qnodes_y + qy;
+                    if (!is_equal(element.qN   (i, q), factorization.X (a, qx) * factorization.Y (b, qy)) ||
+                        !is_equal(element.qNxi (i, q), factorization.dX(a, qx) * factorization.Y (b, qy)) ||
+                        !is_equal(element.qNeta(i, q), factorization.X (a, qx) * factorization.dY(b, qy)))
+                        return std::nullopt;
+                }
+    return factorization;
+}
+
+template<class T>
+size_t tensor_product_2d<T>::nodes_x() const noexcept {
+    return _nodes_x;
+}
+
+template<class T>
+size_t tensor_product_2d<T>::nodes_y() const noexcept {
+    return _nodes_y;
+}
+
+template<class T>
+size_t tensor_product_2d<T>::qnodes_x() const noexcept {
+    return _qnodes_x;
+}
+
+template<class T>
+size_t tensor_product_2d<T>::qnodes_y() const noexcept {
+    return _qnodes_y;
+}
+
+template<class T>
+size_t tensor_product_2d<T>::node(const size_t a, const size_t b) const {
+    return _nodes[a * nodes_y() + b];
+}
+
+template<class T>
+T tensor_product_2d<T>::X(const size_t a, const size_t qx) const {
+    return _X[a * qnodes_x() + qx];
+}
+
+template<class T>
+T tensor_product_2d<T>::dX(const size_t a, const size_t qx) const {
+    return _dX[a * qnodes_x() + qx];
+}
+
+template<class T>
+T tensor_product_2d<T>::Y(const size_t b, const size_t qy) const {
+    return _Y[b * qnodes_y() + qy];
+}
+
+template<class T>
+T tensor_product_2d<T>::dY(const size_t b, const size_t qy) const {
+    return _dY[b * qnodes_y() + qy];
+}
+
+template<class T>
+template<class Values>
+void tensor_product_2d<T>::interpolate(const Values& values, const std::span<T> value, const std::span<T> dxi, const std::span<T> deta) const {
+    // Contraction in the direction y: partial[a * qnodes_y + qy] = sum_b values(node(a, b)) * Y_b(qy)
+    thread_local std::vector<T> partial, partial_deta;
+    partial.assign(nodes_x() * qnodes_y(), T{0});
+    partial_deta.assign(deta.empty() ? 0 : nodes_x() * qnodes_y(), T{0});
+    for(const size_t a : std::ranges::iota_view{0u, nodes_x()})
+        for(const size_t b : std::ranges::iota_view{0u, nodes_y()}) {
+            const T node_value = values(node(a, b));
+            for(const size_t qy : std::ranges::iota_view{0u, qnodes_y()}) {
+                partial[a * qnodes_y() + qy] += node_value * Y(b, qy);
+                if (!deta.empty())
+                    partial_deta[a * qnodes_y() + qy] += node_value * dY(b, qy);
+            }
+        }
+
+    // Contraction in the direction x
+    for(const size_t qx : std::ranges::iota_view{0u, qnodes_x()})
+        for(const size_t qy : std::ranges::iota_view{0u, qnodes_y()}) {
+            T sum = T{0}, sum_dxi = T{0}, sum_deta = T{0};
+            for(const size_t a : std::ranges::iota_view{0u, nodes_x()}) {
+                sum += X(a, qx) * partial[a * qnodes_y() + qy];
+                sum_dxi += dX(a, qx) * partial[a * qnodes_y() + qy];
+                if (!deta.empty())
+                    sum_deta += X(a, qx) * partial_deta[a * qnodes_y() + qy];
+            }
+            const size_t q = qx * qnodes_y() + qy;
+            if (!value.empty())
+                value[q] = sum;
+            if (!dxi.empty())
+                dxi[q] = sum_dxi;
+            if (!deta.empty())
+                deta[q] = sum_deta;
+        }
+}
+
+template<class T>
+bool tensor_product_2d<T>::is_factorization_efficient() const noexcept {
+    return std::min(qnodes_x(), qnodes_y()) >= 4;
+}
+
+template<class T>
+template<class Coefficients>
+void tensor_product_2d<T>::stiffness(const Coefficients& coefficients, const std::span<T> matrix) const {
+    // The derivative with respect to xi is dX_a * Y_b and with respect to eta is X_a * dY_b
+    const std::array<const std::vector<T>*, 2> factors_x = {&_dX, &_X}, factors_y = {&_Y, &_dY};
+    const size_t nodes_count = nodes_x() * nodes_y();
+    const size_t block_size = nodes_y() * nodes_y();
+
+    // Contraction in the direction y: partial[((k * 2 + l) * qnodes_x + qx) * nodes_y^2 + b * nodes_y + d] =
+    // sum_qy G_kl(q) * factor_y_k(b, qy) * factor_y_l(d, qy)
+    thread_local std::vector<T> partial;
+    partial.assign(4 * qnodes_x() * block_size, T{0});
+    for(const size_t qx : std::ranges::iota_view{0u, qnodes_x()})
+        for(const size_t qy : std::ranges::iota_view{0u, qnodes_y()}) {
+            const auto G = coefficients(qx * qnodes_y() + qy);
+            for(const size_t k : std::ranges::iota_view{0u, 2u})
+                for(const size_t l : std::ranges::iota_view{0u, 2u}) {
+                    T* const block = &partial[((k * 2 + l) * qnodes_x() + qx) * block_size];
+                    for(const size_t b : std::ranges::iota_view{0u, nodes_y()}) {
+                        const T factor = G[k][l] * (*factors_y[k])[b * qnodes_y() + qy];
+                        for(const size_t d : std::ranges::iota_view{0u, nodes_y()})
+                            block[b * nodes_y() + d] += factor * (*factors_y[l])[d * qnodes_y() + qy];
+                    }
+                }
+        }
+
+    // Contraction in the direction x
+    for(const size_t a : std::ranges::iota_view{0u, nodes_x()})
+        for(const size_t c : std::ranges::iota_view{0u, nodes_x()})
+            for(const size_t b : std::ranges::iota_view{0u, nodes_y()})
+                for(const size_t d : std::ranges::iota_view{0u, nodes_y()}) {
+                    T sum = T{0};
+                    for(const size_t k : std::ranges::iota_view{0u, 2u})
+                        for(const size_t l : std::ranges::iota_view{0u, 2u})
+                            for(const size_t qx : std::ranges::iota_view{0u, qnodes_x()})
+                                sum += (*factors_x[k])[a * qnodes_x() + qx] * (*factors_x[l])[c * qnodes_x() + qx] *
+                                       partial[((k * 2 + l) * qnodes_x() + qx) * block_size + b * nodes_y() + d];
+                    matrix[node(a, b) * nodes_count + node(c, d)] = sum;
+                }
+}
+
+template<class T>
+template<class Coefficients>
+void tensor_product_2d<T>::mass(const Coefficients& coefficients, const std::span<T> matrix) const {
+    const size_t nodes_count = nodes_x() * nodes_y();
+    const size_t block_size = nodes_y() * nodes_y();
+
+    // Contraction in the direction y: partial[qx * nodes_y^2 + b * nodes_y + d] = sum_qy c(q) * Y_b(qy) * Y_d(qy)
+    thread_local std::vector<T> partial;
+    partial.assign(qnodes_x() * block_size, T{0});
+    for(const size_t qx : std::ranges::iota_view{0u, qnodes_x()})
+        for(const size_t qy : std::ranges::iota_view{0u, qnodes_y()}) {
+            const T coefficient = coefficients(qx * qnodes_y() + qy);
+            T* const block = &partial[qx * block_size];
+            for(const size_t b : std::ranges::iota_view{0u, nodes_y()}) {
+                const T factor = coefficient * Y(b, qy);
+                for(const size_t d : std::ranges::iota_view{0u, nodes_y()})
+                    block[b * nodes_y() + d] += factor * Y(d, qy);
+            }
+        }
+
+    // Contraction in the direction x
+    for(const size_t a : std::ranges::iota_view{0u, nodes_x()})
+        for(const size_t c : std::ranges::iota_view{0u, nodes_x()})
+            for(const size_t b : std::ranges::iota_view{0u, nodes_y()})
+                for(const size_t d : std::ranges::iota_view{0u, nodes_y()}) {
+                    T sum = T{0};
+                    for(const size_t qx : std::ranges::iota_view{0u, qnodes_x()})
+                        sum += X(a, qx) * X(c, qx) * partial[qx * block_size + b * nodes_y() + d];
+                    matrix[node(a, b) * nodes_count + node(c, d)] = sum;
+                }
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "geometry/geometry_2d.hpp"
 #include "geometry/geometric_primitives/geometric_primitives_2d.hpp"
 
+#include "quadrature/quadrature_2d.hpp"
+#include "quadrature/dunavant_quadrature.hpp"
+
 #include "element/element_2d_integrate.hpp"
 #include "element/basis/basis_2d.hpp"
 
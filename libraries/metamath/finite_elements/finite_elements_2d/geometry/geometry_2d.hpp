@@ -8,6 +8,7 @@ namespace metamath::finite_element {
 template<class T, template<class, auto...> class Shape_Type, auto... Args>
 class geometry_2d : public geometry_2d_base<T>,
                     public Shape_Type<T, Args...> {
+protected:
     using shape_t = Shape_Type<T, Args...>;
     static_assert(shape_t::boundary.size() == 4, "Wrong number of boundaries.");
 
@@ -0,0 +1,111 @@
+#ifndef FINITE_ELEMENT_DUNAVANT_QUADRATURE_HPP
+#define FINITE_ELEMENT_DUNAVANT_QUADRATURE_HPP
+
+#include <array>
+
+namespace metamath::finite_element {
+
+// Symmetric quadratures on the triangle with the vertices (1, 0), (0, 1), (0, 0), which are exact for the polynomials of the degree Degree.
+// D.A. Dunavant. High degree efficient symmetrical Gaussian quadrature rules for the triangle.
+template<class T, size_t Degree>
+class dunavant;
+
+template<class T>
+class dunavant<T, 1> {
+protected:
+    static inline constexpr std::array<std::array<T, 2>, 1> nodes = { T{1} / T{3}, T{1} / T{3} };
+    static inline constexpr std::array<T, 1> weights = { T{1} / T{2} };
+
+    constexpr explicit dunavant() noexcept = default;
+
+public:
+    virtual ~dunavant() noexcept = default;
+};
+
+template<class T>
+class dunavant<T, 2> {
+protected:
+    static inline constexpr std::array<std::array<T, 2>, 3>
+        nodes = { T{2} / T{3}, T{1} / T{6},
+                  T{1} / T{6}, T{2} / T{3},
+                  T{1} / T{6}, T{1} / T{6} };
+    static inline constexpr std::array<T, 3> weights = { T{1} / T{6}, T{1} / T{6}, T{1} / T{6} };
+
+    constexpr explicit dunavant() noexcept = default;
+
+public:
+    virtual ~dunavant() noexcept = default;
+};
+
+// The only rule of the family with the negative weight
+template<class T>
+class dunavant<T, 3> {
+protected:
+    static inline constexpr std::array<std::array<T, 2>, 4>
+        nodes = { T{1} / T{3}, T{1} / T{3},
+                  T{3} / T{5}, T{1} / T{5},
+                  T{1} / T{5}, T{3} / T{5},
+                  T{1} / T{5}, T{1} / T{5} };
+    static inline constexpr std::array<T, 4> weights = { -T{27} / T{96}, T{25} / T{96}, T{25} / T{96}, T{25} / T{96} };
+
+    constexpr explicit dunavant() noexcept = default;
+
+public:
+    virtual ~dunavant() noexcept = default;
+};
+
+template<class T>
+class dunavant<T, 4> {
+    static inline constexpr T a = T{0.44594849091596488631832925388305};
+    static inline constexpr T b = T{0.091576213509770743459571463402202};
+    static inline constexpr T wa = T{0.22338158967801146569500700843312} / T{2};
+    static inline constexpr T wb = T{0.10995174365532186763832632490021} / T{2};
+
+protected:
+    static inline constexpr std::array<std::array<T, 2>, 6>
+        nodes = {   T{1} - T{2} * a,               a,
+                                  a, T{1} - T{2} * a,
+                                  a,               a,
+                    T{1} - T{2} * b,               b,
+                                  b, T{1} - T{2} * b,
+                                  b,               b };
+    static inline constexpr std::array<T, 6> weights = { wa, wa, wa, wb, wb, wb };
+
+    constexpr explicit dunavant() noexcept = default;
+
+public:
+    virtual ~dunavant() noexcept = default;
+};
+
+template<class T>
+class dunavant<T, 5> {
+    // a, b = (6 +- sqrt(15)) / 21 and wa, wb = (155 +- sqrt(15)) / 2400
+    static inline constexpr T a = T{0.47014206410511508977044120951345};
+    static inline constexpr T b = T{0.10128650732345633880098736191512};
+    static inline constexpr T wa = T{0.066197076394253090368824693916576};
+    static inline constexpr T wb = T{0.062969590272413576297841972750091};
+
+protected:
+    static inline constexpr std::array<std::array<T, 2>, 7>
+        nodes = {       T{1} / T{3},     T{1} / T{3},
+                    T{1} - T{2} * a,               a,
+                                  a, T{1} - T{2} * a,
+                                  a,               a,
+                    T{1} - T{2} * b,               b,
+                                  b, T{1} - T{2} * b,
+                                  b,               b };
+    static inline constexpr std::array<T, 7> weights = { T{9} / T{80}, wa, wa, wa, wb, wb, wb };
+
+    constexpr explicit dunavant() noexcept = default;
+
+public:
+    virtual ~dunavant() noexcept = default;
+};
+
+// The minimal degree of the rule, with which the stiffness of the triangle of the order Element_Order is integrated exactly
+template<size_t Element_Order>
+inline constexpr size_t dunavant_stiffness_degree = Element_Order > 1 ? 2 * (Element_Order - 1) : 1;
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef FINITE_ELEMENT_QUADRATURE_2D_HPP
+#define FINITE_ELEMENT_QUADRATURE_2D_HPP
+
+#include "quadrature_2d_base.hpp"
+
+namespace metamath::finite_element {
+
+template<class T, template<class, auto...> class Quadrature_Type, auto... Args>
+class quadrature_2d : public quadrature_2d_base<T>,
+                      public Quadrature_Type<T, Args...> {
+    using quadrature_t = Quadrature_Type<T, Args...>;
+    static_assert(quadrature_t::nodes.size() == quadrature_t::weights.size(),
+                  "The number of nodes and weights does not match.");
+
+public:
+    ~quadrature_2d() override = default;
+
+    std::unique_ptr<quadrature_2d_base<T>> clone() const override { return std::make_unique<quadrature_2d<T, Quadrature_Type, Args...>>(); }
+
+    size_t nodes_count() const override { return quadrature_t::nodes.size(); }
+
+    const std::array<T, 2>& node(const size_t i) const override { return quadrature_t::nodes[i]; }
+    T weight(const size_t i) const override { return quadrature_t::weights[i]; }
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef FINITE_ELEMENT_QUADRATURE_BASE_2D_HPP
+#define FINITE_ELEMENT_QUADRATURE_BASE_2D_HPP
+
+#include "quadrature_base.hpp"
+
+#include <array>
+#include <memory>
+
+namespace metamath::finite_element {
+
+// Quadratures with the nodes given in the reference element coordinates, which are not the tensor products of the 1D quadratures
+template<class T>
+class quadrature_2d_base : public quadrature_base<T> {
+public:
+    ~quadrature_2d_base() override = default;
+    virtual std::unique_ptr<quadrature_2d_base<T>> clone() const = 0;
+    virtual const std::array<T, 2>& node(const size_t i) const = 0;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -5,5 +5,6 @@
 #include "factorial.hpp"
 #include "operators.hpp"
 #include "power.hpp"
+#include "vectorizable.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef METAMATH_VECTORIZABLE_HPP
+#define METAMATH_VECTORIZABLE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// Branch-free elementary functions, which are inlined and vectorized by the compiler inside the "omp simd" loops,
+// while std::exp, std::log and std::pow are the library calls, which break the vectorization.
+// The double precision versions are accurate up to a few ulp, other types use the standard functions.
+namespace metamath::functions {
+
+// Results for x < -708 are flushed to zero, results for x > 709 are not infinite
+template<class T>
+constexpr T vectorizable_exp(const T x) noexcept {
+    if constexpr (!std::is_same_v<T, double>)
+        return std::exp(x);
+    else {
+        constexpr double log2e = 1.4426950408889634074;
+        constexpr double ln2_hi = 6.93147180369123816490e-01;
+        constexpr double ln2_lo = 1.90821492927058770002e-10;
+        constexpr double shifter = 0x1.8p52; // rounds to the integer and keeps it in the lower bits of the mantissa
+        const double clamped = std::min(std::max(x, -708.0), 709.0);
+        const double shifted = clamped * log2e + shifter;
+        const double k = shifted - shifter;
+        const double r = (clamped - k * ln2_hi) - k * ln2_lo; // |r| <= ln(2) / 2
+        double polynomial = 1.0 / 6227020800.0;
+        polynomial = polynomial * r + 1.0 / 479001600.0;
+        polynomial = polynomial * r + 1.0 / 39916800.0;
+        polynomial = polynomial * r + 1.0 / 3628800.0;
+        polynomial = polynomial * r + 1.0 / 362880.0;
+        polynomial = polynomial * r + 1.0 / 40320.0;
+        polynomial = polynomial * r + 1.0 / 5040.0;
+        polynomial = polynomial * r + 1.0 / 720.0;
+        polynomial = polynomial * r + 1.0 / 120.0;
+        polynomial = polynomial * r + 1.0 / 24.0;
+        polynomial = polynomial * r + 1.0 / 6.0;
+        polynomial = polynomial * r + 0.5;
+        polynomial = polynomial * r + 1.0;
+        polynomial = polynomial * r + 1.0;
+        const int64_t exponent = std::bit_cast<int64_t>(shifted) - std::bit_cast<int64_t>(shifter);
+        const double scale = std::bit_cast<double>(uint64_t(exponent + 1023) << 52);
+        return x < -708.0 ? 0.0 : polynomial * scale;
+    }
+}
+
+// Defined for the positive normal numbers
+template<class T>
+constexpr T vectorizable_log(const T x) noexcept {
+    if constexpr (!std::is_same_v<T, double>)
+        return std::log(x);
+    else {
+        constexpr double ln2_hi = 6.93147180369123816490e-01;
+        constexpr double ln2_lo = 1.90821492927058770002e-10;
+        constexpr double sqrt2 = 1.41421356237309504880;
+        constexpr double exponent_shifter = 0x1p52 + 1023; // unbiases the exponent bits stored in the mantissa
+        const uint64_t bits = std::bit_cast<uint64_t>(x);
+        const double mantissa = std::bit_cast<double>((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+        const double exponent = std::bit_cast<double>((bits >> 52) | 0x4330000000000000ull) - exponent_shifter;
+        const bool is_greater = mantissa > sqrt2;
+        const double m = is_greater ? 0.5 * mantissa : mantissa;
+        const double e = is_greater ? exponent + 1 : exponent;
+        const double f = (m - 1) / (m + 1); // |f| <= 0.1716
+        const double s = f * f;
+        double polynomial = 1.0 / 21;
+        polynomial = polynomial * s + 1.0 / 19;
+        polynomial = polynomial * s + 1.0 / 17;
+        polynomial = polynomial * s + 1.0 / 15;
+        polynomial = polynomial * s + 1.0 / 13;
+        polynomial = polynomial * s + 1.0 / 11;
+        polynomial = polynomial * s + 1.0 / 9;
+        polynomial = polynomial * s + 1.0 / 7;
+        polynomial = polynomial * s + 1.0 / 5;
+        polynomial = polynomial * s + 1.0 / 3;
+        return e * ln2_hi + (2 * f + (2 * f * s * polynomial + e * ln2_lo));
+    }
+}
+
+// Defined for the non-negative x and the positive y
+template<class T>
+constexpr T vectorizable_pow(const T x, const T y) noexcept {
+    return x > T{0} ? vectorizable_exp(y * vectorizable_log(x > T{0} ? x : T{1})) : T{0};
+}
+
+}
+
+#endif
@@ -6,6 +6,12 @@
     #include <omp.h>
 #endif
 
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+#include <sstream>
+
 namespace parallel_utils {
 
 // GCC implementation have bug: omp_get_num_threads() return 1 in nonparallel sections
@@ -20,6 +26,36 @@ int threads_count() {
     return threads > 1 ? threads : 1;
 }
 
+std::string bind_threads() {
+#if defined(_OPENMP) && defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask))
+        return {};
+    std::vector<int> processors;
+    for(const int processor : std::ranges::iota_view{0, CPU_SETSIZE})
+        if (CPU_ISSET(processor, &mask))
+            processors.push_back(processor);
+    std::vector<int> binding(threads_count(), -1);
+#pragma omp parallel default(none) shared(processors, binding) num_threads(binding.size())
+    {
+        const size_t thread = omp_get_thread_num();
+        const int processor = processors[thread * processors.size() / omp_get_num_threads()];
+        cpu_set_t thread_mask;
+        CPU_ZERO(&thread_mask);
+        CPU_SET(processor, &thread_mask);
+        if (!sched_setaffinity(0, sizeof(thread_mask), &thread_mask))
+            binding[thread] = processor;
+    }
+    std::ostringstream description;
+    for(const size_t thread : std::ranges::iota_view{0u, binding.size()})
+        description << (thread ? ", " : "") << thread << " -> " << (binding[thread] < 0 ? "unbound" : std::to_string(binding[thread]));
+    return description.str();
+#else
+    return {};
+#endif
+}
+
 OMP_ranges::OMP_ranges(const size_t size, const size_t threads)
     : _ranges{init_uniform_ranges(size, threads)} {}
 
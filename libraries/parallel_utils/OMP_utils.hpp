@@ -3,12 +3,19 @@
 
 #include <cstddef>
 #include <ranges>
+#include <string>
 #include <vector>
 
 namespace parallel_utils {
 
 int threads_count();
 
+// Binds each thread of the OpenMP pool to a single processor of the process affinity mask.
+// The threads are spread over the mask in order, so the consecutive threads, which get the consecutive rows of the matrices,
+// share the socket if the processors of the socket are numbered consecutively.
+// The binding is described for the log, it is empty if the binding is not supported.
+std::string bind_threads();
+
 class OMP_ranges final {
     std::vector<std::ranges::iota_view<size_t, size_t>> _ranges;
 
@@ -0,0 +1,37 @@
+#ifndef PARALLEL_UTILS_INIT_BALANCED_RANGES_HPP
+#define PARALLEL_UTILS_INIT_BALANCED_RANGES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace parallel_utils {
+
+// The ranges of the rows with close sums of the weights, which are given by the shifts of the rows as in the CSR matrices,
+// so the rows with the non-zero elements count close to the shifts.back() * (i + 1) / count end the i-th range.
+template<class I>
+std::vector<std::ranges::iota_view<size_t, size_t>> init_balanced_ranges(const std::span<const I> shifts, const size_t count) {
+    if (!count)
+        throw std::domain_error{"The count parameter cannot be 0!"};
+    if (shifts.empty())
+        throw std::domain_error{"The shifts must contain at least one element!"};
+    const size_t size = shifts.size() - 1;
+    const size_t weight = size_t(shifts.back() - shifts.front());
+    std::vector<std::ranges::iota_view<size_t, size_t>> ranges(count);
+    size_t left_bound = 0;
+    for(const size_t i : std::ranges::iota_view{0u, count}) {
+        const I bound = shifts.front() + I(weight / count * (i + 1) + weight % count * (i + 1) / count);
+        const auto end = std::lower_bound(std::next(shifts.begin(), left_bound), std::prev(shifts.end()), bound);
+        const size_t right_bound = i + 1 == count ? size : size_t(std::distance(shifts.begin(), end));
+        ranges[i] = {left_bound, right_bound};
+        left_bound = right_bound;
+    }
+    return ranges;
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define NONLOCAL_EQUATION_PARAMETERS_HPP
 
 #include "nonlocal_constants.hpp"
+#include "solver_2d/influence_functions_2d.hpp"
 
 #include <algorithm>
 #include <array>
@@ -16,8 +17,10 @@ template<size_t Dimension, class T>
 struct model_parameters final {
     static_assert(Dimension > 0, "Dimension must be non-zero.");
     using arg = std::conditional_t<Dimension == 1, T, std::array<T, Dimension>>;
-    std::function<T(const arg&, const arg&)> influence = [](const arg&, const arg&) constexpr noexcept { return T{0}; };
+    using influence_t = std::conditional_t<Dimension == 2, influence::influence_2d<T>, std::function<T(const arg&, const arg&)>>;
+    influence_t influence = [](const arg&, const arg&) constexpr noexcept { return T{0}; };
     T local_weight = T{1};
+    T quadrature_tolerance = T{0}; // zero means that reduced nonlocal quadratures are not used
 };
 
 template<size_t Dimension, class T, template<class, auto...> class Physical, auto... Args>
@@ -0,0 +1,101 @@
+#ifndef NONLOCAL_ADAPTIVE_CROSS_APPROXIMATION_HPP
+#define NONLOCAL_ADAPTIVE_CROSS_APPROXIMATION_HPP
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+namespace nonlocal::slae {
+
+// Block approximation A ≈ U * V^T
+template<class T>
+struct low_rank_block final {
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> U;
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> V;
+
+    size_t rank() const noexcept { return U.cols(); }
+    size_t memory() const noexcept { return sizeof(T) * (U.size() + V.size()); }
+};
+
+// Adaptive cross approximation with partial pivoting.
+// Only rank * (rows + cols) entries of the block are evaluated.
+// Returns std::nullopt if the requested accuracy is not reached with rank less than max_rank,
+// in this case it is cheaper to keep the block in a dense form.
+template<class T, class Entry>
+std::optional<low_rank_block<T>> adaptive_cross_approximation(const size_t rows, const size_t cols, const Entry& entry,
+                                                              const T tolerance, const size_t max_rank) {
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, 1>> us, vs;
+    std::vector<bool> used_rows(rows, false);
+    T approximation_norm = T{0};
+    size_t pivot_row = 0;
+    bool converged = false;
+    while(us.size() < max_rank) {
+        used_rows[pivot_row] = true;
+        Eigen::Matrix<T, Eigen::Dynamic, 1> v(cols);
+        for(const size_t j : std::ranges::iota_view{0u, cols})
+            v[j] = entry(pivot_row, j);
+        for(const size_t k : std::ranges::iota_view{0u, us.size()})
+            v -= us[k][pivot_row] * vs[k];
+
+        Eigen::Index pivot_col = 0;
+        if (v.cwiseAbs().maxCoeff(&pivot_col) == T{0}) {
+            const auto unused = std::find(used_rows.begin(), used_rows.end(), false);
+            if (unused == used_rows.end()) {
+                converged = true;
+                break;
+            }
+            pivot_row = std::distance(used_rows.begin(), unused);
+            continue;
+        }
+        v /= v[pivot_col];
+
+        Eigen::Matrix<T, Eigen::Dynamic, 1> u(rows);
+        for(const size_t i : std::ranges::iota_view{0u, rows})
+            u[i] = entry(i, pivot_col);
+        for(const size_t k : std::ranges::iota_view{0u, us.size()})
+            u -= vs[k][pivot_col] * us[k];
+
+        const T u_norm = u.norm(), v_norm = v.norm();
+        approximation_norm += u_norm * u_norm * v_norm * v_norm;
+        for(const size_t k : std::ranges::iota_view{0u, us.size()})
+            approximation_norm += 2 * u.dot(us[k]) * v.dot(vs[k]);
+        us.push_back(std::move(u));
+        vs.push_back(std::move(v));
+
+        if (u_norm * v_norm <= tolerance * std::sqrt(std::abs(approximation_norm))) {
+            converged = true;
+            break;
+        }
+
+        T max_value = T{-1};
+        for(const size_t i : std::ranges::iota_view{0u, rows})
+            if (!used_rows[i] && std::abs(us.back()[i]) > max_value) {
+                max_value = std::abs(us.back()[i]);
+                pivot_row = i;
+            }
+        if (max_value < T{0}) {
+            converged = true;
+            break;
+        }
+    }
+
+    if (!converged)
+        return std::nullopt;
+    low_rank_block<T> block{
+        .U = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>(rows, us.size()),
+        .V = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>(cols, vs.size())
+    };
+    for(const size_t k : std::ranges::iota_view{0u, us.size()}) {
+        block.U.col(k) = us[k];
+        block.V.col(k) = vs[k];
+    }
+    return block;
+}
+
+}
+
+#endif
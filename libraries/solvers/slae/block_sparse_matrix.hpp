@@ -0,0 +1,224 @@
+#ifndef NONLOCAL_BLOCK_SPARSE_MATRIX_HPP
+#define NONLOCAL_BLOCK_SPARSE_MATRIX_HPP
+
+#include "OMP_utils.hpp"
+#include "init_balanced_ranges.hpp"
+
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace nonlocal::slae {
+
+// Block sparse rows of the symmetric matrix with the square blocks Block x Block, one column index per block.
+// Only the upper triangle of the blocks is stored, the diagonal blocks are stored in full.
+// The values of the blocks are stored row by row one after another.
+template<class T, class I, size_t Block>
+class block_sparse_matrix final {
+    static_assert(Block > 0, "Block must be greater than 0.");
+
+    static constexpr size_t Block_Size = Block * Block;
+
+    size_t _rows = 0; // in blocks
+    size_t _cols = 0; // in blocks
+    std::vector<I> _shifts;
+    Eigen::Matrix<I, Eigen::Dynamic, 1> _indices; // not initialized by resize, so the threads touch their rows first
+    Eigen::Matrix<T, Eigen::Dynamic, 1> _values;
+    std::vector<std::ranges::iota_view<size_t, size_t>> _threads_ranges;
+    mutable Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> _threaded_z;
+
+    template<class Callback>
+    static void block_columns(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const size_t block_row, const Callback& callback);
+
+    void reduction(Eigen::Matrix<T, Eigen::Dynamic, 1>& z) const;
+
+public:
+    explicit block_sparse_matrix() noexcept = default;
+    // The upper triangle of the symmetric CSR matrix with the sorted indices as it is passed to the conjugate_gradient.
+    // The rows of the blocks are first touched by the threads which multiply them.
+    explicit block_sparse_matrix(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix,
+                                 const size_t threads_count = parallel_utils::threads_count());
+
+    size_t rows() const noexcept;
+    size_t cols() const noexcept;
+    size_t blocks_count() const noexcept;
+    size_t indices_memory() const noexcept;
+
+    std::span<const I> shifts() const noexcept;
+    std::span<const I> indices() const noexcept;
+    std::span<const T, Block_Size> block(const size_t index) const;
+
+    // The upper triangle of the scalar matrix including the zeros of the blocks
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> to_sparse() const;
+
+    // z = A * p for operator_conjugate_gradient
+    void product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const;
+};
+
+template<class T, class I, size_t Block>
+template<class Callback>
+void block_sparse_matrix<T, I, Block>::block_columns(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const size_t block_row,
+                                                     const Callback& callback) {
+    // Merge of the sorted rows of the block row, each block column is passed once in the ascending order
+    std::array<I, Block> positions;
+    for(const size_t i : std::ranges::iota_view{0u, Block})
+        positions[i] = matrix.outerIndexPtr()[Block * block_row + i];
+    for(size_t previous = size_t(-1);;) {
+        size_t block_col = size_t(-1);
+        for(const size_t i : std::ranges::iota_view{0u, Block})
+            if (positions[i] < matrix.outerIndexPtr()[Block * block_row + i + 1])
+                block_col = std::min(block_col, size_t(matrix.innerIndexPtr()[positions[i]]) / Block);
+        if (block_col == size_t(-1))
+            return;
+        if (block_col != previous)
+            callback(block_col);
+        previous = block_col;
+        for(const size_t i : std::ranges::iota_view{0u, Block})
+            while(positions[i] < matrix.outerIndexPtr()[Block * block_row + i + 1] &&
+                  size_t(matrix.innerIndexPtr()[positions[i]]) / Block == block_col)
+                ++positions[i];
+    }
+}
+
+template<class T, class I, size_t Block>
+block_sparse_matrix<T, I, Block>::block_sparse_matrix(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const size_t threads_count)
+    : _rows{size_t(matrix.rows()) / Block}
+    , _cols{size_t(matrix.cols()) / Block}
+    , _shifts(_rows + 1, I{0}) {
+    if (matrix.rows() % Block || matrix.cols() % Block)
+        throw std::logic_error{"The sizes of the matrix must be multiples of the block size."};
+    if (!matrix.isCompressed())
+        throw std::logic_error{"The matrix must be compressed."};
+
+#pragma omp parallel for default(none) shared(matrix) schedule(dynamic, 64)
+    for(size_t row = 0; row < _rows; ++row)
+        block_columns(matrix, row, [this, row](const size_t) { ++_shifts[row + 1]; });
+    std::partial_sum(_shifts.begin(), _shifts.end(), _shifts.begin());
+
+    _threads_ranges = parallel_utils::init_balanced_ranges(std::span<const I>{_shifts}, std::clamp(threads_count, size_t{1}, std::max(_rows, size_t{1})));
+    _threaded_z.resize(Block * _rows, _threads_ranges.size());
+    _indices.resize(_shifts.back());
+    _values.resize(Block_Size * _shifts.back());
+#pragma omp parallel for default(none) shared(matrix) schedule(static, 1)
+    for(size_t thread = 0; thread < _threads_ranges.size(); ++thread)
+        for(const size_t row : _threads_ranges[thread]) {
+            I position = _shifts[row];
+            block_columns(matrix, row, [this, &position](const size_t block_col) { _indices[position++] = block_col; });
+            std::fill(_values.data() + Block_Size * _shifts[row], _values.data() + Block_Size * _shifts[row + 1], T{0});
+            for(const size_t i : std::ranges::iota_view{0u, Block}) {
+                I* block = _indices.data() + _shifts[row];
+                for(I k = matrix.outerIndexPtr()[Block * row + i]; k < matrix.outerIndexPtr()[Block * row + i + 1]; ++k) {
+                    const size_t col = matrix.innerIndexPtr()[k];
+                    block = std::lower_bound(block, _indices.data() + _shifts[row + 1], I(col / Block));
+                    _values[Block_Size * std::distance(_indices.data(), block) + Block * i + col % Block] = matrix.valuePtr()[k];
+                }
+            }
+            // The lower triangle of the diagonal block
+            T* const diagonal = _values.data() + Block_Size * _shifts[row];
+            for(const size_t i : std::ranges::iota_view{1u, Block})
+                for(const size_t j : std::ranges::iota_view{0u, i})
+                    diagonal[Block * i + j] = diagonal[Block * j + i];
+        }
+}
+
+template<class T, class I, size_t Block>
+size_t block_sparse_matrix<T, I, Block>::rows() const noexcept {
+    return _rows;
+}
+
+template<class T, class I, size_t Block>
+size_t block_sparse_matrix<T, I, Block>::cols() const noexcept {
+    return _cols;
+}
+
+template<class T, class I, size_t Block>
+size_t block_sparse_matrix<T, I, Block>::blocks_count() const noexcept {
+    return _indices.size();
+}
+
+template<class T, class I, size_t Block>
+size_t block_sparse_matrix<T, I, Block>::indices_memory() const noexcept {
+    return sizeof(I) * (_shifts.size() + _indices.size());
+}
+
+template<class T, class I, size_t Block>
+std::span<const I> block_sparse_matrix<T, I, Block>::shifts() const noexcept {
+    return _shifts;
+}
+
+template<class T, class I, size_t Block>
+std::span<const I> block_sparse_matrix<T, I, Block>::indices() const noexcept {
+    return {_indices.data(), size_t(_indices.size())};
+}
+
+template<class T, class I, size_t Block>
+std::span<const T, block_sparse_matrix<T, I, Block>::Block_Size> block_sparse_matrix<T, I, Block>::block(const size_t index) const {
+    return std::span<const T, Block_Size>{_values.data() + Block_Size * index, Block_Size};
+}
+
+template<class T, class I, size_t Block>
+Eigen::SparseMatrix<T, Eigen::RowMajor, I> block_sparse_matrix<T, I, Block>::to_sparse() const {
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(Block * rows(), Block * cols());
+    for(const size_t row : std::ranges::iota_view{0u, rows()})
+        for(const size_t i : std::ranges::iota_view{0u, Block}) {
+            const bool has_diagonal = _shifts[row] < _shifts[row + 1] && size_t(_indices[_shifts[row]]) == row;
+            matrix.outerIndexPtr()[Block * row + i + 1] = Block * (_shifts[row + 1] - _shifts[row]) - (has_diagonal ? i : 0);
+        }
+    std::partial_sum(matrix.outerIndexPtr(), matrix.outerIndexPtr() + matrix.rows() + 1, matrix.outerIndexPtr());
+    matrix.data().resize(matrix.outerIndexPtr()[matrix.rows()]);
+    for(const size_t row : std::ranges::iota_view{0u, rows()})
+        for(const size_t i : std::ranges::iota_view{0u, Block}) {
+            I position = matrix.outerIndexPtr()[Block * row + i];
+            for(const size_t k : std::ranges::iota_view{size_t(_shifts[row]), size_t(_shifts[row + 1])})
+                for(const size_t j : std::ranges::iota_view{size_t(_indices[k]) == row ? i : 0, Block}) {
+                    matrix.innerIndexPtr()[position] = Block * _indices[k] + j;
+                    matrix.valuePtr()[position++] = _values[Block_Size * k + Block * i + j];
+                }
+        }
+    return matrix;
+}
+
+template<class T, class I, size_t Block>
+void block_sparse_matrix<T, I, Block>::reduction(Eigen::Matrix<T, Eigen::Dynamic, 1>& z) const {
+    for(size_t i = 1; i < _threaded_z.cols(); ++i) {
+        const size_t begin = Block * *_threads_ranges[i].begin();
+        _threaded_z.block(begin, 0, _threaded_z.rows() - begin, 1) += _threaded_z.block(begin, i, _threaded_z.rows() - begin, 1);
+    }
+    z = _threaded_z.col(0);
+}
+
+template<class T, class I, size_t Block>
+void block_sparse_matrix<T, I, Block>::product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const {
+#pragma omp parallel for default(none) shared(p) schedule(static, 1) num_threads(_threads_ranges.size())
+    for(size_t thread = 0; thread < _threads_ranges.size(); ++thread) {
+        T* const z_thread = _threaded_z.col(thread).data();
+        std::fill_n(z_thread + Block * *_threads_ranges[thread].begin(), _threaded_z.rows() - Block * *_threads_ranges[thread].begin(), T{0});
+        for(const size_t row : _threads_ranges[thread]) {
+            std::array<T, Block> z_row = {};
+            for(const size_t k : std::ranges::iota_view{size_t(_shifts[row]), size_t(_shifts[row + 1])}) {
+                const size_t col = _indices[k];
+                const T* const values = _values.data() + Block_Size * k;
+                for(const size_t i : std::ranges::iota_view{0u, Block})
+                    for(const size_t j : std::ranges::iota_view{0u, Block})
+                        z_row[i] += values[Block * i + j] * p[Block * col + j];
+                if (col != row)
+                    for(const size_t j : std::ranges::iota_view{0u, Block})
+                        for(const size_t i : std::ranges::iota_view{0u, Block})
+                            z_thread[Block * col + j] += values[Block * i + j] * p[Block * row + i];
+            }
+            for(const size_t i : std::ranges::iota_view{0u, Block})
+                z_thread[Block * row + i] += z_row[i];
+        }
+    }
+    reduction(z);
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -2,10 +2,14 @@
 #define NONLOCAL_CONJUGATE_GRADIENT_HPP
 
 #include "OMP_utils.hpp"
+#include "init_balanced_ranges.hpp"
+#include "delta_indices.hpp"
+#include "sliced_ellpack_matrix.hpp"
 
 #include <Eigen/Sparse>
 #include <iostream>
 #include <optional>
+#include <utility>
 
 namespace nonlocal::slae {
 
@@ -14,23 +18,60 @@ struct conjugate_gradient_parameters final {
     T tolerance = std::is_same_v<T, float> ? 1e-6 : 1e-15;
     uintmax_t max_iterations = 10000;
     int threads_count = parallel_utils::threads_count();
+    std::optional<T> sliced_ellpack_padding; // SELL-C-sigma is used if its padding is not greater than specified
+    size_t sliced_ellpack_sigma = 256;
+    bool compressed_indices = false;         // The columns are decoded from the deltas, so the indices traffic is reduced
 };
 
+// Product(z, p) must calculate z = A * p for a symmetric positive definite operator A
+template<class T, class Product>
+Eigen::Matrix<T, Eigen::Dynamic, 1> conjugate_gradient_iterations(const Product& product,
+                                                                  const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+                                                                  const std::optional<Eigen::Matrix<T, Eigen::Dynamic, 1>>& x0,
+                                                                  const conjugate_gradient_parameters<T>& parameters,
+                                                                  uintmax_t& iteration, T& residual) {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> x = x0.template value_or(Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(b.size()));
+    Eigen::Matrix<T, Eigen::Dynamic, 1> z = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(b.size());
+    Eigen::Matrix<T, Eigen::Dynamic, 1> r = b;
+    if (x0) {
+        product(z, x);
+        r -= z;
+    }
+    Eigen::Matrix<T, Eigen::Dynamic, 1> p = r;
+    T r_squaredNorm = r.squaredNorm();
+    const T b_norm = b.norm();
+    iteration = 0;
+    residual = std::sqrt(r_squaredNorm) / b_norm;
+    while(iteration < parameters.max_iterations && residual > parameters.tolerance) {
+        product(z, p);
+        const T nu = r_squaredNorm / p.dot(z);
+        x += nu * p;
+        r -= nu * z;
+        const T r_squaredNorm_prev = std::exchange(r_squaredNorm, r.squaredNorm()),
+                mu = r_squaredNorm / r_squaredNorm_prev;
+        p = r + mu * p;
+        ++iteration;
+        residual = std::sqrt(r_squaredNorm) / b_norm;
+    }
+    return x;
+}
+
 template<class T, class I>
 class conjugate_gradient final {
     const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& _A;
     conjugate_gradient_parameters<T> _parameters = {};
-    std::vector<std::array<size_t, 2>> _threads_ranges;
+    std::vector<std::ranges::iota_view<size_t, size_t>> _threads_ranges;
     mutable Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> _threaded_z;
+    std::optional<sliced_ellpack_matrix<T, I>> _sliced_ellpack;
+    std::optional<delta_indices<I>> _delta_indices;
     mutable uintmax_t _iteration = 0;
     mutable T _residual = 0;
 
-    static std::vector<std::array<size_t, 2>> 
-    distribute_rows(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& A, const size_t threads_count);
-
     void reduction(Eigen::Matrix<T, Eigen::Dynamic, 1>& z) const;
     void matrix_vector_product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z,
                                const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const;
+    void compressed_matrix_vector_product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z,
+                                          const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const;
 
 public:
     explicit conjugate_gradient(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& A,
@@ -39,6 +80,8 @@ public:
     T tolerance() const noexcept;
     uintmax_t max_iterations() const noexcept;
     int threads_count() const noexcept;
+    const std::optional<sliced_ellpack_matrix<T, I>>& sliced_ellpack() const noexcept;
+    const std::optional<delta_indices<I>>& compressed_indices() const noexcept;
 
     T residual() const noexcept;
     uintmax_t iterations() const noexcept;
@@ -51,35 +94,44 @@ public:
                                               const std::optional<Eigen::Matrix<T, Eigen::Dynamic, 1>>& x0 = std::nullopt) const;
 };
 
+// Conjugate gradient for operators which are not stored as CSR matrices.
+// Operator must provide the method product(z, p) which calculates z = A * p.
+template<class T, class Operator>
+class operator_conjugate_gradient final {
+    const Operator& _A;
+    conjugate_gradient_parameters<T> _parameters = {};
+    mutable uintmax_t _iteration = 0;
+    mutable T _residual = 0;
+
+public:
+    explicit operator_conjugate_gradient(const Operator& A, const conjugate_gradient_parameters<T>& parameters = {});
+
+    T tolerance() const noexcept;
+    uintmax_t max_iterations() const noexcept;
+
+    T residual() const noexcept;
+    uintmax_t iterations() const noexcept;
+
+    void set_tolerance(const T tolerance) noexcept;
+    void set_max_iterations(const uintmax_t max_iterations) noexcept;
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1> solve(const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+                                              const std::optional<Eigen::Matrix<T, Eigen::Dynamic, 1>>& x0 = std::nullopt) const;
+};
+
 template<class T, class I>
 conjugate_gradient<T, I>::conjugate_gradient(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& A,
                                              const conjugate_gradient_parameters<T>& parameters)
     : _A{A}
     , _parameters{parameters} {
+        if (_parameters.sliced_ellpack_padding &&
+            sliced_ellpack_matrix<T, I>::padding(_A, true, _parameters.sliced_ellpack_sigma) <= *_parameters.sliced_ellpack_padding)
+            _sliced_ellpack.emplace(_A, true, _parameters.sliced_ellpack_sigma, std::max(_parameters.threads_count, 1));
         set_threads_count(_parameters.threads_count);
+        if (!_sliced_ellpack && _parameters.compressed_indices)
+            _delta_indices.emplace(_A, _threads_ranges);
     }
 
-template<class T, class I>
-std::vector<std::array<size_t, 2>> 
-conjugate_gradient<T, I>::distribute_rows(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& A, const size_t threads_count) {
-    if (threads_count < 0)
-        throw std::logic_error{"Threads count must be greater than 0."};
-    const size_t mean_count = A.nonZeros() / threads_count;
-    std::vector<std::array<size_t, 2>> threads_ranges(threads_count);
-    threads_ranges.front().front() = 0;
-    for(size_t row = 0, thread_sum = 0, curr_thread = 0; row < size_t(A.rows()); ++row) {
-        thread_sum += A.outerIndexPtr()[row + 1] - A.outerIndexPtr()[row];
-        if (curr_thread < threads_count && (thread_sum >= mean_count || row == A.rows() - 1)) {
-            thread_sum = 0;
-            threads_ranges[curr_thread].back() = row;
-            ++curr_thread;
-            threads_ranges[curr_thread].front() = row;
-        }
-    }
-    threads_ranges.back().back() = A.rows();
-    return threads_ranges;
-}
-
 template<class T, class I>
 T conjugate_gradient<T, I>::tolerance() const noexcept {
     return _parameters.tolerance;
@@ -95,6 +147,16 @@ int conjugate_gradient<T, I>::threads_count() const noexcept {
     return _parameters.threads_count;
 }
 
+template<class T, class I>
+const std::optional<sliced_ellpack_matrix<T, I>>& conjugate_gradient<T, I>::sliced_ellpack() const noexcept {
+    return _sliced_ellpack;
+}
+
+template<class T, class I>
+const std::optional<delta_indices<I>>& conjugate_gradient<T, I>::compressed_indices() const noexcept {
+    return _delta_indices;
+}
+
 template<class T, class I>
 T conjugate_gradient<T, I>::residual() const noexcept {
     return _residual;
@@ -120,21 +182,35 @@ void conjugate_gradient<T, I>::set_threads_count(const int threads_count) {
     _parameters.threads_count = threads_count;
     if (_parameters.threads_count > _A.rows())
         _parameters.threads_count = _A.rows();
+    if (_sliced_ellpack) {
+        _sliced_ellpack->set_threads_count(_parameters.threads_count);
+        return;
+    }
     _threaded_z.resize(_A.rows(), _parameters.threads_count);
-    _threads_ranges = distribute_rows(_A, _parameters.threads_count);
+    // The rows with close non-zero elements counts, the matrix rows are first touched by the same threads during the assembly
+    _threads_ranges = parallel_utils::init_balanced_ranges(std::span<const I>{_A.outerIndexPtr(), size_t(_A.rows() + 1)}, 
+                                                           _parameters.threads_count);
 }
 
 template<class T, class I>
 void conjugate_gradient<T, I>::reduction(Eigen::Matrix<T, Eigen::Dynamic, 1>& z) const {
     for(size_t i = 1; i < _threaded_z.cols(); ++i)
-        _threaded_z.block(_threads_ranges[i].front(), 0, z.size() - _threads_ranges[i].front(), 1) += 
-        _threaded_z.block(_threads_ranges[i].front(), i, z.size() - _threads_ranges[i].front(), 1);
+        _threaded_z.block(*_threads_ranges[i].begin(), 0, z.size() - *_threads_ranges[i].begin(), 1) += 
+        _threaded_z.block(*_threads_ranges[i].begin(), i, z.size() - *_threads_ranges[i].begin(), 1);
     z = _threaded_z.col(0);
 }
 
 template<class T, class I>
 void conjugate_gradient<T, I>::matrix_vector_product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z,
                                                      const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const {
+    if (_sliced_ellpack) {
+        _sliced_ellpack->product(z, p);
+        return;
+    }
+    if (_delta_indices) {
+        compressed_matrix_vector_product(z, p);
+        return;
+    }
 #pragma omp parallel default(none) shared(p) num_threads(_parameters.threads_count)
 {
 #ifdef _OPENMP
@@ -143,7 +219,7 @@ void conjugate_gradient<T, I>::matrix_vector_product(Eigen::Matrix<T, Eigen::Dyn
     const I thread = 0;
 #endif
     _threaded_z.col(thread).setZero();
-    for(I row = _threads_ranges[thread].front(); row < I(_threads_ranges[thread].back()); ++row) {
+    for(I row = *_threads_ranges[thread].begin(); row < I(*_threads_ranges[thread].end()); ++row) {
         const I ind = _A.outerIndexPtr()[row];
         _threaded_z(row, thread) += _A.valuePtr()[ind] * p[_A.innerIndexPtr()[ind]];
         for(I i = ind+1; i < _A.outerIndexPtr()[row+1]; ++i) {
@@ -155,30 +231,84 @@ void conjugate_gradient<T, I>::matrix_vector_product(Eigen::Matrix<T, Eigen::Dyn
     reduction(z);
 }
 
+template<class T, class I>
+void conjugate_gradient<T, I>::compressed_matrix_vector_product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z,
+                                                                const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const {
+#pragma omp parallel default(none) shared(p) num_threads(_parameters.threads_count)
+{
+#ifdef _OPENMP
+    const I thread = omp_get_thread_num();
+#else
+    const I thread = 0;
+#endif
+    _threaded_z.col(thread).setZero();
+    for(I row = *_threads_ranges[thread].begin(); row < I(*_threads_ranges[thread].end()); ++row) {
+        const I ind = _A.outerIndexPtr()[row];
+        if (ind == _A.outerIndexPtr()[row+1])
+            continue;
+        auto decoder = _delta_indices->row(row);
+        _threaded_z(row, thread) += _A.valuePtr()[ind] * p[decoder.first()];
+        for(I i = ind+1; i < _A.outerIndexPtr()[row+1]; ++i) {
+            const I col = decoder.next();
+            _threaded_z(row, thread) += _A.valuePtr()[i] * p[col];
+            _threaded_z(col, thread) += _A.valuePtr()[i] * p[row];
+        }
+    }
+}
+    reduction(z);
+}
+
 template<class T, class I>
 Eigen::Matrix<T, Eigen::Dynamic, 1> conjugate_gradient<T, I>::solve(const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
                                                                     const std::optional<Eigen::Matrix<T, Eigen::Dynamic, 1>>& x0) const {
-    const Eigen::Matrix<T, Eigen::Dynamic, 1>& b_full = b;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> x = x0.template value_or(Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(b_full.size()));
-    Eigen::Matrix<T, Eigen::Dynamic, 1> r = b_full - _A.template selfadjointView<Eigen::Upper>() * x;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> p = r;
-    Eigen::Matrix<T, Eigen::Dynamic, 1> z = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(b_full.size());
-    T r_squaredNorm = r.squaredNorm();
-    const T b_norm = b_full.norm();
-    _iteration = 0;
-    _residual = std::sqrt(r_squaredNorm) / b_norm;
-    while(_iteration < _parameters.max_iterations && _residual > _parameters.tolerance) {
+    const auto product = [this](Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) {
         matrix_vector_product(z, p);
-        const T nu = r_squaredNorm / p.dot(z);
-        x += nu * p;
-        r -= nu * z;
-        const T r_squaredNorm_prev = std::exchange(r_squaredNorm, r.squaredNorm()),
-                mu = r_squaredNorm / r_squaredNorm_prev;
-        p = r + mu * p;
-        ++_iteration;
-        _residual = std::sqrt(r_squaredNorm) / b_norm;
-    }
-    return x;
+    };
+    return conjugate_gradient_iterations(product, b, x0, _parameters, _iteration, _residual);
+}
+
+template<class T, class Operator>
+operator_conjugate_gradient<T, Operator>::operator_conjugate_gradient(const Operator& A, const conjugate_gradient_parameters<T>& parameters)
+    : _A{A}
+    , _parameters{parameters} {}
+
+template<class T, class Operator>
+T operator_conjugate_gradient<T, Operator>::tolerance() const noexcept {
+    return _parameters.tolerance;
+}
+
+template<class T, class Operator>
+uintmax_t operator_conjugate_gradient<T, Operator>::max_iterations() const noexcept {
+    return _parameters.max_iterations;
+}
+
+template<class T, class Operator>
+T operator_conjugate_gradient<T, Operator>::residual() const noexcept {
+    return _residual;
+}
+
+template<class T, class Operator>
+uintmax_t operator_conjugate_gradient<T, Operator>::iterations() const noexcept {
+    return _iteration;
+}
+
+template<class T, class Operator>
+void operator_conjugate_gradient<T, Operator>::set_tolerance(const T tolerance) noexcept {
+    _parameters.tolerance = tolerance;
+}
+
+template<class T, class Operator>
+void operator_conjugate_gradient<T, Operator>::set_max_iterations(const uintmax_t max_iterations) noexcept {
+    _parameters.max_iterations = max_iterations;
+}
+
+template<class T, class Operator>
+Eigen::Matrix<T, Eigen::Dynamic, 1> operator_conjugate_gradient<T, Operator>::solve(const Eigen::Matrix<T, Eigen::Dynamic, 1>& b,
+                                                                                   const std::optional<Eigen::Matrix<T, Eigen::Dynamic, 1>>& x0) const {
+    const auto product = [this](Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) {
+        _A.product(z, p);
+    };
+    return conjugate_gradient_iterations(product, b, x0, _parameters, _iteration, _residual);
 }
 
 }
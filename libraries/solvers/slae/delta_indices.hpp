@@ -0,0 +1,175 @@
+#ifndef NONLOCAL_DELTA_INDICES_HPP
+#define NONLOCAL_DELTA_INDICES_HPP
+
+#include <Eigen/Sparse>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace nonlocal::slae {
+
+// Column indices of the CSR matrix compressed by the deltas between the neighbouring columns of the row.
+// The delta is stored in one byte if it is less than WORD_CODE, otherwise the escape code is followed by the 16-bit delta
+// or by the delta of the full width. The first delta of the row is taken from the row number with the zigzag sign encoding,
+// so the upper triangle rows start with the zero byte. The columns of the rows must be sorted.
+template<class I>
+class delta_indices final {
+    using code_t = std::uint8_t;
+    using word_t = std::uint16_t;
+    using full_t = std::make_unsigned_t<I>;
+
+    static constexpr code_t WORD_CODE = 254;
+    static constexpr code_t FULL_CODE = 255;
+
+    std::vector<size_t> _shifts;                     // rows shifts in bytes
+    Eigen::Matrix<code_t, Eigen::Dynamic, 1> _codes; // not initialized by resize, so the threads touch their rows first
+
+    static size_t code_size(const full_t delta) noexcept;
+    static code_t* encode(code_t* code, const full_t delta) noexcept;
+    static full_t zigzag(const I col, const I row) noexcept;
+
+public:
+    class decoder final {
+        const code_t* _code = nullptr;
+        full_t _col = 0;
+
+        full_t delta() noexcept;
+
+    public:
+        explicit decoder(const code_t* const code, const size_t row) noexcept;
+
+        // Column of the first element of the row, must be called once before next
+        I first() noexcept;
+        // Column of the next element of the row
+        I next() noexcept;
+    };
+
+    explicit delta_indices() noexcept = default;
+    template<class T>
+    explicit delta_indices(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const std::span<const std::ranges::iota_view<size_t, size_t>> threads_ranges);
+
+    size_t rows() const noexcept;
+    size_t bytes() const noexcept;
+
+    decoder row(const size_t row) const noexcept;
+};
+
+template<class I>
+size_t delta_indices<I>::code_size(const full_t delta) noexcept {
+    return delta < WORD_CODE ? 1 : delta <= std::numeric_limits<word_t>::max() ? 1 + sizeof(word_t) : 1 + sizeof(full_t);
+}
+
+template<class I>
+typename delta_indices<I>::code_t* delta_indices<I>::encode(code_t* code, const full_t delta) noexcept {
+    if (delta < WORD_CODE) {
+        *code = code_t(delta);
+        return code + 1;
+    }
+    if (delta <= std::numeric_limits<word_t>::max()) {
+        *code = WORD_CODE;
+        const word_t word = word_t(delta);
+        std::memcpy(code + 1, &word, sizeof(word_t));
+        return code + 1 + sizeof(word_t);
+    }
+    *code = FULL_CODE;
+    std::memcpy(code + 1, &delta, sizeof(full_t));
+    return code + 1 + sizeof(full_t);
+}
+
+template<class I>
+typename delta_indices<I>::full_t delta_indices<I>::zigzag(const I col, const I row) noexcept {
+    return col >= row ? full_t(col - row) << 1 : ((full_t(row - col) - 1) << 1) | 1;
+}
+
+template<class I>
+template<class T>
+delta_indices<I>::delta_indices(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix,
+                                const std::span<const std::ranges::iota_view<size_t, size_t>> threads_ranges)
+    : _shifts(matrix.rows() + 1, 0) {
+    if (!matrix.isCompressed())
+        throw std::logic_error{"The matrix must be compressed."};
+    bool is_sorted = true;
+#pragma omp parallel for default(none) shared(matrix) reduction(&&: is_sorted) schedule(dynamic, 64)
+    for(size_t row = 0; row < size_t(matrix.rows()); ++row)
+        for(I i = matrix.outerIndexPtr()[row]; i < matrix.outerIndexPtr()[row + 1]; ++i) {
+            const I col = matrix.innerIndexPtr()[i];
+            if (i == matrix.outerIndexPtr()[row])
+                _shifts[row + 1] += code_size(zigzag(col, I(row)));
+            else {
+                is_sorted = is_sorted && col > matrix.innerIndexPtr()[i - 1];
+                _shifts[row + 1] += code_size(full_t(col - matrix.innerIndexPtr()[i - 1]));
+            }
+        }
+    if (!is_sorted)
+        throw std::logic_error{"The columns of the matrix rows must be sorted."};
+    std::partial_sum(_shifts.begin(), _shifts.end(), _shifts.begin());
+
+    _codes.resize(_shifts.back());
+#pragma omp parallel for default(none) shared(matrix, threads_ranges) schedule(static, 1)
+    for(size_t thread = 0; thread < threads_ranges.size(); ++thread)
+        for(const size_t row : threads_ranges[thread]) {
+            code_t* code = _codes.data() + _shifts[row];
+            for(I i = matrix.outerIndexPtr()[row]; i < matrix.outerIndexPtr()[row + 1]; ++i)
+                code = encode(code, i == matrix.outerIndexPtr()[row] ? zigzag(matrix.innerIndexPtr()[i], I(row)) :
+                                                                         full_t(matrix.innerIndexPtr()[i] - matrix.innerIndexPtr()[i - 1]));
+        }
+}
+
+template<class I>
+size_t delta_indices<I>::rows() const noexcept {
+    return _shifts.size() - 1;
+}
+
+template<class I>
+size_t delta_indices<I>::bytes() const noexcept {
+    return _codes.size() + sizeof(size_t) * _shifts.size();
+}
+
+template<class I>
+typename delta_indices<I>::decoder delta_indices<I>::row(const size_t row) const noexcept {
+    return decoder{_codes.data() + _shifts[row], row};
+}
+
+template<class I>
+delta_indices<I>::decoder::decoder(const code_t* const code, const size_t row) noexcept
+    : _code{code}
+    , _col{full_t(row)} {}
+
+template<class I>
+typename delta_indices<I>::full_t delta_indices<I>::decoder::delta() noexcept {
+    full_t delta = *_code;
+    if (delta < WORD_CODE)
+        ++_code;
+    else if (delta == WORD_CODE) {
+        word_t word;
+        std::memcpy(&word, _code + 1, sizeof(word_t));
+        delta = word;
+        _code += 1 + sizeof(word_t);
+    } else {
+        std::memcpy(&delta, _code + 1, sizeof(full_t));
+        _code += 1 + sizeof(full_t);
+    }
+    return delta;
+}
+
+template<class I>
+I delta_indices<I>::decoder::first() noexcept {
+    const full_t code = delta();
+    return I(_col = code & 1 ? _col - (code >> 1) - 1 : _col + (code >> 1));
+}
+
+template<class I>
+I delta_indices<I>::decoder::next() noexcept {
+    return I(_col += delta());
+}
+
+}
+
+#endif
\ No newline at end of file
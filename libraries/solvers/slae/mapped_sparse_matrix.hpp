@@ -0,0 +1,315 @@
+#ifndef NONLOCAL_MAPPED_SPARSE_MATRIX_HPP
+#define NONLOCAL_MAPPED_SPARSE_MATRIX_HPP
+
+#include "OMP_utils.hpp"
+#include "init_balanced_ranges.hpp"
+
+#include <Eigen/Sparse>
+
+#if defined(__unix__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace nonlocal::slae {
+
+struct out_of_core_parameters final {
+    std::filesystem::path path;       // File of the matrix, it is overwritten
+    size_t block_bytes = size_t{64} << 20; // Size of the rows block which is streamed at once
+};
+
+// File mapped into the memory, the pages are read and written by the kernel on demand
+class mapped_file final {
+    std::byte* _data = nullptr;
+    size_t _size = 0;
+
+public:
+    explicit mapped_file() noexcept = default;
+    explicit mapped_file(const std::filesystem::path& path, const size_t size, const bool is_writable);
+    mapped_file(const mapped_file&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    ~mapped_file() noexcept;
+
+    std::byte* data() const noexcept;
+    size_t size() const noexcept;
+
+    // The advices are applied to the whole pages inside the range
+    void will_need(const size_t begin, const size_t end) const noexcept;
+    void dont_need(const size_t begin, const size_t end) const noexcept;
+    void flush(const size_t begin, const size_t end) const noexcept;
+};
+
+// The upper triangle of the symmetric CSR matrix stored in the file as it is passed to the conjugate_gradient.
+// The file contains the header with the sizes, the shifts, the column indices and the values.
+// The shifts are kept in memory, the indices and the values are streamed by the blocks of rows during the product:
+// the next block is requested from the disk before the current one is multiplied and the multiplied block is released.
+template<class T, class I>
+class mapped_sparse_matrix final {
+    struct header final {
+        uint64_t rows = 0;
+        uint64_t cols = 0;
+        uint64_t nonzeros = 0;
+        uint64_t index_size = sizeof(I);
+        uint64_t value_size = sizeof(T);
+    };
+
+    static size_t indices_offset(const size_t rows) noexcept;
+    static size_t values_offset(const size_t rows, const size_t nonzeros) noexcept;
+    static std::vector<std::ranges::iota_view<size_t, size_t>> init_blocks(const std::span<const I> shifts, const size_t block_bytes);
+
+    mapped_file _file;
+    header _header;
+    std::vector<I> _shifts;
+    std::vector<std::ranges::iota_view<size_t, size_t>> _blocks;
+    std::vector<std::vector<std::ranges::iota_view<size_t, size_t>>> _threads_ranges; // per block
+    mutable Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> _threaded_z;
+
+    const I* indices() const noexcept;
+    const T* values() const noexcept;
+    void prefetch(const size_t block) const noexcept;
+    void release(const size_t block) const noexcept;
+
+public:
+    // The matrix is written by the blocks of rows, so the written pages are flushed and can be evicted before the next block
+    static void write(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const out_of_core_parameters& parameters);
+
+    explicit mapped_sparse_matrix(const out_of_core_parameters& parameters, const size_t threads_count = parallel_utils::threads_count());
+
+    size_t rows() const noexcept;
+    size_t cols() const noexcept;
+    size_t nonzeros() const noexcept;
+    size_t blocks_count() const noexcept;
+
+    // z = A * p for operator_conjugate_gradient
+    void product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const;
+};
+
+#if defined(__unix__)
+
+inline mapped_file::mapped_file(const std::filesystem::path& path, const size_t size, const bool is_writable)
+    : _size{size} {
+    const int fd = is_writable ? open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"Unable to open the file " + path.string()};
+    if (is_writable && ftruncate(fd, off_t(size))) {
+        close(fd);
+        throw std::runtime_error{"Unable to resize the file " + path.string()};
+    }
+    if (size) {
+        void* const data = mmap(nullptr, size, is_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error{"Unable to map the file " + path.string()};
+        }
+        _data = static_cast<std::byte*>(data);
+    }
+    close(fd);
+}
+
+inline mapped_file::~mapped_file() noexcept {
+    if (_data)
+        munmap(_data, _size);
+}
+
+inline void mapped_file::will_need(const size_t begin, const size_t end) const noexcept {
+    const size_t page = sysconf(_SC_PAGESIZE);
+    if (const size_t aligned = begin / page * page; aligned < end)
+        madvise(_data + aligned, end - aligned, MADV_WILLNEED);
+}
+
+inline void mapped_file::dont_need(const size_t begin, const size_t end) const noexcept {
+    const size_t page = sysconf(_SC_PAGESIZE);
+    if (const size_t aligned_begin = (begin + page - 1) / page * page, aligned_end = end / page * page; aligned_begin < aligned_end)
+        madvise(_data + aligned_begin, aligned_end - aligned_begin, MADV_DONTNEED);
+}
+
+inline void mapped_file::flush(const size_t begin, const size_t end) const noexcept {
+    const size_t page = sysconf(_SC_PAGESIZE);
+    if (const size_t aligned = begin / page * page; aligned < end)
+        msync(_data + aligned, end - aligned, MS_ASYNC);
+}
+
+#else
+
+inline mapped_file::mapped_file(const std::filesystem::path&, const size_t, const bool) {
+    throw std::runtime_error{"Memory mapped files are not supported on this platform."};
+}
+
+inline mapped_file::~mapped_file() noexcept = default;
+inline void mapped_file::will_need(const size_t, const size_t) const noexcept {}
+inline void mapped_file::dont_need(const size_t, const size_t) const noexcept {}
+inline void mapped_file::flush(const size_t, const size_t) const noexcept {}
+
+#endif
+
+inline mapped_file::mapped_file(mapped_file&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)}
+    , _size{std::exchange(other._size, 0)} {}
+
+inline mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    return *this;
+}
+
+inline std::byte* mapped_file::data() const noexcept {
+    return _data;
+}
+
+inline size_t mapped_file::size() const noexcept {
+    return _size;
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::indices_offset(const size_t rows) noexcept {
+    return sizeof(header) + sizeof(I) * (rows + 1);
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::values_offset(const size_t rows, const size_t nonzeros) noexcept {
+    const size_t offset = indices_offset(rows) + sizeof(I) * nonzeros;
+    return (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+template<class T, class I>
+std::vector<std::ranges::iota_view<size_t, size_t>> mapped_sparse_matrix<T, I>::init_blocks(const std::span<const I> shifts, const size_t block_bytes) {
+    const size_t bytes = (sizeof(I) + sizeof(T)) * size_t(shifts.back());
+    const size_t block = std::max(block_bytes, size_t{1});
+    const size_t count = std::clamp((bytes + block - 1) / block, size_t{1}, std::max(shifts.size() - 1, size_t{1}));
+    return parallel_utils::init_balanced_ranges(shifts, count);
+}
+
+template<class T, class I>
+void mapped_sparse_matrix<T, I>::write(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const out_of_core_parameters& parameters) {
+    if (!matrix.isCompressed())
+        throw std::logic_error{"The matrix must be compressed."};
+    const header head = {.rows = uint64_t(matrix.rows()), .cols = uint64_t(matrix.cols()), .nonzeros = uint64_t(matrix.nonZeros())};
+    const mapped_file file{parameters.path, values_offset(head.rows, head.nonzeros) + sizeof(T) * head.nonzeros, true};
+    std::memcpy(file.data(), &head, sizeof(header));
+    std::memcpy(file.data() + sizeof(header), matrix.outerIndexPtr(), sizeof(I) * (head.rows + 1));
+    for(const auto block : init_blocks(std::span<const I>{matrix.outerIndexPtr(), head.rows + 1}, parameters.block_bytes)) {
+        const size_t begin = matrix.outerIndexPtr()[*block.begin()], end = matrix.outerIndexPtr()[*block.end()];
+        const size_t indices_begin = indices_offset(head.rows) + sizeof(I) * begin;
+        const size_t values_begin = values_offset(head.rows, head.nonzeros) + sizeof(T) * begin;
+        std::memcpy(file.data() + indices_begin, matrix.innerIndexPtr() + begin, sizeof(I) * (end - begin));
+        std::memcpy(file.data() + values_begin, matrix.valuePtr() + begin, sizeof(T) * (end - begin));
+        for(const auto [block_begin, block_end] : {std::pair{indices_begin, indices_begin + sizeof(I) * (end - begin)},
+                                                   std::pair{values_begin, values_begin + sizeof(T) * (end - begin)}}) {
+            file.flush(block_begin, block_end);
+            file.dont_need(block_begin, block_end);
+        }
+    }
+}
+
+template<class T, class I>
+mapped_sparse_matrix<T, I>::mapped_sparse_matrix(const out_of_core_parameters& parameters, const size_t threads_count) {
+    const uintmax_t size = std::filesystem::file_size(parameters.path);
+    if (size < sizeof(header))
+        throw std::runtime_error{"The matrix file " + parameters.path.string() + " is too small."};
+    _file = mapped_file{parameters.path, size, false};
+    std::memcpy(&_header, _file.data(), sizeof(header));
+    if (_header.index_size != sizeof(I) || _header.value_size != sizeof(T) ||
+        size != values_offset(_header.rows, _header.nonzeros) + sizeof(T) * _header.nonzeros)
+        throw std::runtime_error{"The matrix file " + parameters.path.string() + " does not match the matrix type."};
+    _shifts.resize(_header.rows + 1);
+    std::memcpy(_shifts.data(), _file.data() + sizeof(header), sizeof(I) * _shifts.size());
+    _blocks = init_blocks(_shifts, parameters.block_bytes);
+    _threads_ranges.reserve(_blocks.size());
+    for(const auto block : _blocks) {
+        const size_t count = std::clamp(threads_count, size_t{1}, std::max(block.size(), size_t{1}));
+        auto ranges = parallel_utils::init_balanced_ranges(std::span<const I>{&_shifts[*block.begin()], block.size() + 1}, count);
+        for(auto& range : ranges)
+            range = std::ranges::iota_view{*range.begin() + *block.begin(), *range.end() + *block.begin()};
+        _threads_ranges.push_back(std::move(ranges));
+    }
+    _threaded_z.resize(_header.rows, std::clamp(threads_count, size_t{1}, std::max(size_t(_header.rows), size_t{1})));
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::rows() const noexcept {
+    return _header.rows;
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::cols() const noexcept {
+    return _header.cols;
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::nonzeros() const noexcept {
+    return _header.nonzeros;
+}
+
+template<class T, class I>
+size_t mapped_sparse_matrix<T, I>::blocks_count() const noexcept {
+    return _blocks.size();
+}
+
+template<class T, class I>
+const I* mapped_sparse_matrix<T, I>::indices() const noexcept {
+    return reinterpret_cast<const I*>(_file.data() + indices_offset(rows()));
+}
+
+template<class T, class I>
+const T* mapped_sparse_matrix<T, I>::values() const noexcept {
+    return reinterpret_cast<const T*>(_file.data() + values_offset(rows(), nonzeros()));
+}
+
+template<class T, class I>
+void mapped_sparse_matrix<T, I>::prefetch(const size_t block) const noexcept {
+    const size_t begin = _shifts[*_blocks[block].begin()], end = _shifts[*_blocks[block].end()];
+    _file.will_need(indices_offset(rows()) + sizeof(I) * begin, indices_offset(rows()) + sizeof(I) * end);
+    _file.will_need(values_offset(rows(), nonzeros()) + sizeof(T) * begin, values_offset(rows(), nonzeros()) + sizeof(T) * end);
+}
+
+template<class T, class I>
+void mapped_sparse_matrix<T, I>::release(const size_t block) const noexcept {
+    const size_t begin = _shifts[*_blocks[block].begin()], end = _shifts[*_blocks[block].end()];
+    _file.dont_need(indices_offset(rows()) + sizeof(I) * begin, indices_offset(rows()) + sizeof(I) * end);
+    _file.dont_need(values_offset(rows(), nonzeros()) + sizeof(T) * begin, values_offset(rows(), nonzeros()) + sizeof(T) * end);
+}
+
+template<class T, class I>
+void mapped_sparse_matrix<T, I>::product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const {
+    const I* const indices = this->indices();
+    const T* const values = this->values();
+    _threaded_z.setZero();
+    if (!_blocks.empty())
+        prefetch(0);
+    for(const size_t block : std::ranges::iota_view{0u, _blocks.size()}) {
+        if (block + 1 < _blocks.size())
+            prefetch(block + 1);
+        const auto& threads_ranges = _threads_ranges[block];
+#pragma omp parallel for default(none) shared(p, threads_ranges, indices, values) schedule(static, 1) num_threads(threads_ranges.size())
+        for(size_t thread = 0; thread < threads_ranges.size(); ++thread)
+            for(const size_t row : threads_ranges[thread]) {
+                const I ind = _shifts[row];
+                if (ind == _shifts[row + 1])
+                    continue;
+                _threaded_z(row, thread) += values[ind] * p[indices[ind]];
+                for(I i = ind + 1; i < _shifts[row + 1]; ++i) {
+                    _threaded_z(row, thread) += values[i] * p[indices[i]];
+                    _threaded_z(indices[i], thread) += values[i] * p[row];
+                }
+            }
+        release(block);
+    }
+    z = _threaded_z.rowwise().sum();
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+#ifndef NONLOCAL_SLICED_ELLPACK_MATRIX_HPP
+#define NONLOCAL_SLICED_ELLPACK_MATRIX_HPP
+
+#include "OMP_utils.hpp"
+#include "init_balanced_ranges.hpp"
+
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace nonlocal::slae {
+
+// The number of the values of type T in the widest vector register available
+template<class T>
+constexpr size_t simd_width() noexcept {
+#if defined(__AVX512F__)
+    return std::max(size_t{64} / sizeof(T), size_t{1});
+#elif defined(__AVX__)
+    return std::max(size_t{32} / sizeof(T), size_t{1});
+#else
+    return std::max(size_t{16} / sizeof(T), size_t{1});
+#endif
+}
+
+// Sliced ELLPACK matrix with the sorting window (SELL-C-sigma).
+// The rows are sorted by their lengths in descending order inside the windows of Sigma rows and then are grouped into the chunks of C rows.
+// The chunk is stored column by column with the width of its longest row, so the products of the chunk rows are vectorized.
+// The symmetric matrices are given by the upper triangle as for the conjugate_gradient and are stored in full.
+template<class T, class I, size_t C = simd_width<T>()>
+class sliced_ellpack_matrix final {
+    static_assert(C > 0, "Chunk size must be greater than 0.");
+
+    size_t _rows = 0;
+    size_t _nonzeros = 0;
+    std::vector<size_t> _shifts;                  // chunks shifts, multiples of C
+    std::vector<size_t> _slots;                   // rows of the chunks lanes, the lanes after the last row are equal to rows()
+    Eigen::Matrix<I, Eigen::Dynamic, 1> _indices; // not initialized by resize, so the threads touch their chunks first
+    Eigen::Matrix<T, Eigen::Dynamic, 1> _values;
+    std::vector<std::ranges::iota_view<size_t, size_t>> _threads_ranges;
+
+    static std::vector<size_t> rows_lengths(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric);
+    static std::vector<size_t> sorted_rows(const std::vector<size_t>& lengths, const size_t sigma);
+    static size_t chunk_width(const std::vector<size_t>& lengths, const std::vector<size_t>& rows, const size_t chunk);
+
+public:
+    explicit sliced_ellpack_matrix() noexcept = default;
+    explicit sliced_ellpack_matrix(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric, const size_t sigma,
+                                   const size_t threads_count = parallel_utils::threads_count());
+
+    // The ratio of the padding to the non-zero elements without the conversion
+    static T padding(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric, const size_t sigma);
+
+    size_t rows() const noexcept;
+    size_t cols() const noexcept;
+    size_t chunks_count() const noexcept;
+    size_t nonzeros() const noexcept;
+    size_t stored() const noexcept;
+    T padding() const noexcept;
+
+    void set_threads_count(const size_t threads_count);
+
+    // z = A * p for operator_conjugate_gradient
+    void product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const;
+};
+
+template<class T, class I, size_t C>
+std::vector<size_t> sliced_ellpack_matrix<T, I, C>::rows_lengths(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric) {
+    std::vector<size_t> lengths(matrix.rows());
+    for(const size_t row : std::ranges::iota_view{0u, size_t(matrix.rows())})
+        lengths[row] = matrix.outerIndexPtr()[row + 1] - matrix.outerIndexPtr()[row];
+    if (is_symmetric)
+        for(const size_t row : std::ranges::iota_view{0u, size_t(matrix.rows())})
+            for(I i = matrix.outerIndexPtr()[row]; i < matrix.outerIndexPtr()[row + 1]; ++i)
+                if (const size_t col = matrix.innerIndexPtr()[i]; col != row)
+                    ++lengths[col];
+    return lengths;
+}
+
+template<class T, class I, size_t C>
+std::vector<size_t> sliced_ellpack_matrix<T, I, C>::sorted_rows(const std::vector<size_t>& lengths, const size_t sigma) {
+    std::vector<size_t> rows(lengths.size());
+    std::iota(rows.begin(), rows.end(), size_t{0});
+    const size_t window = std::max(sigma, size_t{1});
+    for(size_t begin = 0; begin < rows.size(); begin += window)
+        std::stable_sort(rows.begin() + begin, rows.begin() + std::min(begin + window, rows.size()),
+                         [&lengths](const size_t lhs, const size_t rhs) { return lengths[lhs] > lengths[rhs]; });
+    return rows;
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::chunk_width(const std::vector<size_t>& lengths, const std::vector<size_t>& rows, const size_t chunk) {
+    size_t width = 0;
+    for(const size_t slot : std::ranges::iota_view{C * chunk, std::min(C * (chunk + 1), rows.size())})
+        width = std::max(width, lengths[rows[slot]]);
+    return width;
+}
+
+template<class T, class I, size_t C>
+T sliced_ellpack_matrix<T, I, C>::padding(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric, const size_t sigma) {
+    const std::vector<size_t> lengths = rows_lengths(matrix, is_symmetric);
+    const std::vector<size_t> rows = sorted_rows(lengths, sigma);
+    size_t stored = 0;
+    for(const size_t chunk : std::ranges::iota_view{0u, (rows.size() + C - 1) / C})
+        stored += C * chunk_width(lengths, rows, chunk);
+    const size_t nonzeros = std::reduce(lengths.begin(), lengths.end(), size_t{0});
+    return nonzeros ? T(stored - nonzeros) / nonzeros : T{0};
+}
+
+template<class T, class I, size_t C>
+sliced_ellpack_matrix<T, I, C>::sliced_ellpack_matrix(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix, const bool is_symmetric,
+                                                      const size_t sigma, const size_t threads_count)
+    : _rows{size_t(matrix.rows())} {
+    if (!matrix.isCompressed())
+        throw std::logic_error{"The matrix must be compressed."};
+    const std::vector<size_t> lengths = rows_lengths(matrix, is_symmetric);
+    const std::vector<size_t> rows = sorted_rows(lengths, sigma);
+    _nonzeros = std::reduce(lengths.begin(), lengths.end(), size_t{0});
+    _slots.resize(C * ((rows.size() + C - 1) / C), _rows);
+    std::copy(rows.begin(), rows.end(), _slots.begin());
+    _shifts.resize(_slots.size() / C + 1, 0);
+    for(const size_t chunk : std::ranges::iota_view{0u, chunks_count()})
+        _shifts[chunk + 1] = _shifts[chunk] + C * chunk_width(lengths, rows, chunk);
+    set_threads_count(threads_count);
+
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> full;
+    if (is_symmetric)
+        full = matrix.template selfadjointView<Eigen::Upper>();
+    const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& source = is_symmetric ? full : matrix;
+    _indices.resize(_shifts.back());
+    _values.resize(_shifts.back());
+#pragma omp parallel for default(none) shared(source) schedule(static, 1)
+    for(size_t thread = 0; thread < _threads_ranges.size(); ++thread)
+        for(const size_t chunk : _threads_ranges[thread]) {
+            const size_t width = (_shifts[chunk + 1] - _shifts[chunk]) / C;
+            for(const size_t lane : std::ranges::iota_view{0u, C}) {
+                const size_t row = _slots[C * chunk + lane];
+                const size_t begin = row < _rows ? source.outerIndexPtr()[row] : 0;
+                const size_t length = row < _rows ? source.outerIndexPtr()[row + 1] - begin : 0;
+                // The padding refers to the own row or to the first column, so the loads stay inside the vector
+                const I padding_col = row < _rows ? I(row) : I{0};
+                for(const size_t j : std::ranges::iota_view{0u, width}) {
+                    const size_t slot = _shifts[chunk] + C * j + lane;
+                    _indices[slot] = j < length ? source.innerIndexPtr()[begin + j] : padding_col;
+                    _values[slot] = j < length ? source.valuePtr()[begin + j] : T{0};
+                }
+            }
+        }
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::rows() const noexcept {
+    return _rows;
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::cols() const noexcept {
+    return _rows;
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::chunks_count() const noexcept {
+    return _slots.size() / C;
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::nonzeros() const noexcept {
+    return _nonzeros;
+}
+
+template<class T, class I, size_t C>
+size_t sliced_ellpack_matrix<T, I, C>::stored() const noexcept {
+    return _shifts.empty() ? 0 : _shifts.back();
+}
+
+template<class T, class I, size_t C>
+T sliced_ellpack_matrix<T, I, C>::padding() const noexcept {
+    return nonzeros() ? T(stored() - nonzeros()) / nonzeros() : T{0};
+}
+
+template<class T, class I, size_t C>
+void sliced_ellpack_matrix<T, I, C>::set_threads_count(const size_t threads_count) {
+    _threads_ranges = parallel_utils::init_balanced_ranges(std::span<const size_t>{_shifts},
+                                                           std::clamp(threads_count, size_t{1}, std::max(chunks_count(), size_t{1})));
+}
+
+template<class T, class I, size_t C>
+void sliced_ellpack_matrix<T, I, C>::product(Eigen::Matrix<T, Eigen::Dynamic, 1>& z, const Eigen::Matrix<T, Eigen::Dynamic, 1>& p) const {
+    z.resize(rows());
+#pragma omp parallel for default(none) shared(z, p) schedule(static, 1) num_threads(_threads_ranges.size())
+    for(size_t thread = 0; thread < _threads_ranges.size(); ++thread)
+        for(const size_t chunk : _threads_ranges[thread]) {
+            std::array<T, C> sum = {};
+            for(size_t slot = _shifts[chunk]; slot < _shifts[chunk + 1]; slot += C) {
+                const I* const indices = _indices.data() + slot;
+                const T* const values = _values.data() + slot;
+                const T* const x = p.data();
+#pragma omp simd
+                for(size_t lane = 0; lane < C; ++lane)
+                    sum[lane] += values[lane] * x[indices[lane]];
+            }
+            for(const size_t lane : std::ranges::iota_view{0u, C})
+                if (const size_t row = _slots[C * chunk + lane]; row < rows())
+                    z[row] = sum[lane];
+        }
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef NONLOCAL_ASSEMBLY_PLAN_2D_HPP
+#define NONLOCAL_ASSEMBLY_PLAN_2D_HPP
+
+#include <cstddef>
+
+namespace nonlocal {
+
+// The sizes of the assembly, which are known after the portrait shifts are counted and before the indices and values are allocated.
+// The kernel evaluations are counted for the full nonlocal quadratures of the ordered pairs of the elements,
+// so they are the upper bound for the reduced quadratures and the symmetric assembly by pairs.
+struct assembly_plan_2d final {
+    size_t rows = 0;
+    size_t nonzeros = 0;
+    size_t local_pairs = 0;        // pairs of the nodes of the same element
+    size_t nonlocal_pairs = 0;     // pairs of the neighbour elements
+    size_t kernel_evaluations = 0; // pairs of the quadrature nodes of the neighbour elements
+    size_t matrix_memory = 0;      // bytes of the indices and values of the both parts of the matrix
+    size_t neighbours_memory = 0;  // bytes of the neighbours lists of the elements
+};
+
+}
+
+#endif
\ No newline at end of file
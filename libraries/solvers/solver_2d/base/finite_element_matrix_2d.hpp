@@ -3,13 +3,21 @@
 
 #include "../solvers_utils.hpp"
 
+#include "assembly_plan_2d.hpp"
 #include "shift_initializer.hpp"
-#include "index_initializer.hpp"
+#include "portrait_initializer.hpp"
 #include "integrator.hpp"
+#include "pair_integrator.hpp"
+#include "nonlocal_quadrature_rules_2d.hpp"
 
 #include "mesh_2d.hpp"
 
+#include "mapped_sparse_matrix.hpp"
+
+#include "OMP_utils.hpp"
+
 #include <iostream>
+#include <unordered_set>
 
 namespace nonlocal {
 
@@ -27,19 +35,62 @@ class finite_element_matrix_2d {
 
     std::shared_ptr<mesh::mesh_2d<T, I>> _mesh;
     matrix_parts_t<T, Matrix_Index> _matrix;
+    nonlocal_quadrature_rules_2d<T, I> _nonlocal_rules;
+
+    // Stack array for the static shapes and thread local vector for the dynamic ones.
+    // The buffers of the same type are distinguished by Id, otherwise the thread local vectors are shared.
+    template<class Shape, class U, size_t Size, size_t Id = 0>
+    static decltype(auto) shape_buffer(const size_t size);
+
+    template<class ShapeL, class ShapeNL, class Influence, class Integrator>
+    void integrate_nonloc_pair_kernel(const Influence& influence, const size_t eL, const size_t eNL, const Integrator& integrator) const;
+
+    template<class Initializer>
+    void node_run(const std::unordered_map<std::string, theory_t>& theories, Initializer& initializer, const size_t node) const;
 
 protected:
     explicit finite_element_matrix_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh);
 
     template<class Initializer>
     void mesh_run(const std::unordered_map<std::string, theory_t>& theories, Initializer&& initializer);
+    // The nodes are processed by the threads which first touched their rows, see utils::threads_rows
+    template<class Initializer>
+    void mesh_run(const std::unordered_map<std::string, theory_t>& theories, Initializer&& initializer,
+                  const std::vector<std::ranges::iota_view<size_t, size_t>>& threads_rows);
 
+    // The counting pass of init_shifts, the rows are not accumulated and the total is not limited by Matrix_Index
+    size_t count_nonzeros(const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, const bool is_symmetric);
     void init_shifts(const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, const bool is_symmetric);
-    void init_indices(const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner,
-                      const bool is_symmetric, const bool sort_indices = true);
+    // Must be called after init_shifts instead of init_indices
+    assembly_plan_2d plan(const std::unordered_map<std::string, theory_t>& theories) const;
+    // Single pass over the mesh, which counts the shifts and collects the sorted indices at once, instead of init_shifts.
+    // The shifts preset in the outer indices are kept, the indices of such entries are placed at the ends of the rows and left to the caller.
+    // All values are zeroed.
+    void init_portrait(const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, const bool is_symmetric);
+    // The portrait of the other matrix with the zero values, so the matrices can be summed by their values.
+    // The portrait must contain all entries the matrix is assembled into.
+    void share_portrait(const finite_element_matrix_2d& other);
     template<class Integrate_Loc, class Integrate_Nonloc>
     void calc_coeffs(const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, const bool is_symmetric,
                      Integrate_Loc&& integrate_loc, Integrate_Nonloc&& integrate_nonloc);
+    // Nonlocal part of the symmetric problems, where each unordered pair of the neighbour elements is integrated once,
+    // so if the outer and inner quadratures differ, the outer one is taken on the element with the smaller number.
+    // The groups must be excluded from the nonlocal theories passed to calc_coeffs, since their local part is assembled there.
+    template<class Integrate_Pair>
+    void calc_nonlocal_pairs(const std::unordered_set<std::string>& groups, const std::vector<bool>& is_inner, Integrate_Pair&& integrate_pair);
+
+    // Chooses reduced quadratures for the nonlocal pairs of elements according to the models quadrature tolerances
+    template<class Parameters>
+    void compute_nonlocal_rules(const std::unordered_map<std::string, theory_t>& theories, const Parameters& parameters);
+    const nonlocal_quadrature_rules_2d<T, I>& nonlocal_rules() const noexcept;
+
+    // All pairs of nodes of the elements eL and eNL are integrated at once according to the nonlocal rule of the pair,
+    // so the influence function and the inner integrals are evaluated once per pair of quadrature nodes.
+    // The element eL is integrated with the NONLOCAL_OUTER quadrature and the element eNL with the NONLOCAL_INNER one.
+    // The integrator is called as integrator(iL * nodes_count(eNL) + jNL, weightL, dNi(qL), inner_integral_j(qL)).
+    // The pairs of the elements of the same default type are integrated by the kernels with the compile-time sizes.
+    template<class Influence, class Integrator>
+    void integrate_nonloc_pair(const Influence& influence, const size_t eL, const size_t eNL, const Integrator& integrator) const;
 
 public:
     virtual ~finite_element_matrix_2d() noexcept = default;
@@ -54,6 +105,9 @@ public:
     const Eigen::SparseMatrix<T, Eigen::RowMajor, Matrix_Index>& matrix(const matrix_part part) const noexcept;
 
     void clear();
+    // The inner part is written to the file by the blocks of rows and released, so the solver streams it from the file.
+    // Must be called when the assembly and the boundary conditions are done.
+    void write_inner(const slae::out_of_core_parameters& parameters);
 };
 
 template<size_t DoF, class T, class I, class Matrix_Index>
@@ -106,59 +160,336 @@ void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::clear() {
     matrix_bound() = Eigen::SparseMatrix<T, Eigen::RowMajor, Matrix_Index>{};
 }
 
+template<size_t DoF, class T, class I, class Matrix_Index>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::write_inner(const slae::out_of_core_parameters& parameters) {
+    slae::mapped_sparse_matrix<T, Matrix_Index>::write(matrix_inner(), parameters);
+    matrix_inner().resize(0, 0);
+    matrix_inner().data().squeeze();
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Parameters>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::compute_nonlocal_rules(
+    const std::unordered_map<std::string, theory_t>& theories, const Parameters& parameters) {
+    _nonlocal_rules.clear();
+    for(const auto& [group, theory] : theories)
+        if (theory == theory_t::NONLOCAL) {
+            const auto& model = parameters.at(group).model;
+            model.influence.visit([this, &group, &model](const auto& influence) {
+                _nonlocal_rules.compute(mesh(), group, influence, model.quadrature_tolerance);
+            });
+        }
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+const nonlocal_quadrature_rules_2d<T, I>& finite_element_matrix_2d<DoF, T, I, Matrix_Index>::nonlocal_rules() const noexcept {
+    return _nonlocal_rules;
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Shape, class U, size_t Size, size_t Id>
+decltype(auto) finite_element_matrix_2d<DoF, T, I, Matrix_Index>::shape_buffer(const size_t size) {
+    if constexpr (Shape::is_static)
+        return std::array<U, Size>{};
+    else {
+        thread_local std::vector<U> buffer;
+        buffer.resize(size);
+        return (buffer);
+    }
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class ShapeL, class ShapeNL, class Influence, class Integrator>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::integrate_nonloc_pair_kernel(
+    const Influence& influence, const size_t eL, const size_t eNL, const Integrator& integrator) const {
+    using namespace metamath::functions;
+    using enum mesh::quadrature_set_t;
+    const auto& mesh = this->mesh();
+    const auto& rules = nonlocal_rules();
+    const auto& elL = mesh.container().element_2d(eL, NONLOCAL_OUTER);
+    const auto& elNL = mesh.container().element_2d(eNL, NONLOCAL_INNER);
+    const size_t nodes_countL = ShapeL::nodes_count(elL);
+    const size_t qnodes_countL = ShapeL::qnodes_count(elL);
+    const size_t nodes_countNL = ShapeNL::nodes_count(elNL);
+    const size_t qnodes_countNL = ShapeNL::qnodes_count(elNL);
+    const size_t qshiftL = mesh.quad_shift(eL, NONLOCAL_OUTER);
+    const size_t qshiftNL = mesh.quad_shift(eNL, NONLOCAL_INNER);
+    const size_t derivatives_shiftL = mesh.quad_node_shift(eL, 0, NONLOCAL_OUTER);
+    const size_t derivatives_shiftNL = mesh.quad_node_shift(eNL, 0, NONLOCAL_INNER);
+    const size_t derivatives_countL = mesh.derivatives_count(eL, NONLOCAL_OUTER);
+    const size_t derivatives_countNL = mesh.derivatives_count(eNL, NONLOCAL_INNER);
+    const bool is_affineL = mesh.is_affine(eL);
+    const bool is_affineNL = mesh.is_affine(eNL);
+    auto&& inner_integrals = shape_buffer<ShapeNL, std::array<T, 2>, ShapeNL::nodes>(nodes_countNL);
+    // The gradients of the affine element eL are constant, so the inner integrals are summed over qL
+    // and the integrator is called once for each pair of nodes, as it is linear in the both gradients
+    auto&& outer_integrals = shape_buffer<ShapeNL, std::array<T, 2>, ShapeNL::nodes, 1>(is_affineL ? nodes_countNL : 0);
+    if (is_affineL)
+        std::fill_n(outer_integrals.begin(), nodes_countNL, std::array<T, 2>{});
+    const auto integrate_outer = [&mesh, &integrator, &inner_integrals, &outer_integrals, is_affineL,
+                                  nodes_countL, nodes_countNL, derivatives_shiftL, derivatives_countL]
+                                 (const T weightL, const size_t qL) {
+        if (is_affineL) {
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                outer_integrals[jNL] += weightL * inner_integrals[jNL];
+            return;
+        }
+        for(const size_t iL : std::ranges::iota_view{0u, nodes_countL}) {
+            const std::array<T, 2>& dNi = mesh.derivatives(derivatives_shiftL + iL * derivatives_countL, qL, NONLOCAL_OUTER);
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                integrator(iL * nodes_countNL + jNL, weightL, dNi, inner_integrals[jNL]);
+        }
+    };
+    const auto integrate_affine_outer = [&mesh, &integrator, &outer_integrals, is_affineL, nodes_countL, nodes_countNL, derivatives_shiftL] {
+        if (is_affineL)
+            for(const size_t iL : std::ranges::iota_view{0u, nodes_countL}) {
+                const std::array<T, 2>& dNi = mesh.derivatives(derivatives_shiftL + iL, NONLOCAL_OUTER);
+                for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                    integrator(iL * nodes_countNL + jNL, T{1}, dNi, outer_integrals[jNL]);
+            }
+    };
+
+    switch (rules.rule(mesh, eL, eNL)) {
+    case nonlocal_rule_t::CENTRES: {
+        const T influence_value = influence(rules.centre(eL), rules.centre(eNL));
+        for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+            inner_integrals[jNL] = influence_value * mesh.gradient_integral(eNL, jNL);
+        for(const size_t iL : std::ranges::iota_view{0u, nodes_countL})
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                integrator(iL * nodes_countNL + jNL, T{1}, mesh.gradient_integral(eL, iL), inner_integrals[jNL]);
+        return;
+    }
+
+    case nonlocal_rule_t::INNER_CENTRE:
+        for(const size_t qL : std::ranges::iota_view{0u, qnodes_countL}) {
+            const T influence_value = influence(mesh.quad_coord(qshiftL + qL, NONLOCAL_OUTER), rules.centre(eNL));
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                inner_integrals[jNL] = influence_value * mesh.gradient_integral(eNL, jNL);
+            integrate_outer(ShapeL::weight(elL, qL), qL);
+        }
+        integrate_affine_outer();
+        return;
+
+    case nonlocal_rule_t::FULL:
+    break;
+    }
+
+    if (const auto& quadrature_neighbours = mesh.quadrature_neighbours(); quadrature_neighbours.contains(qshiftL)) {
+        const size_t neighbour = mesh.neighbour_index(eL, eNL);
+        mesh.visit_precision([&mesh, &quadrature_neighbours, &elL, &inner_integrals, &integrate_outer, neighbour, is_affineNL, qnodes_countL,
+                              nodes_countNL, qshiftL, qshiftNL, derivatives_shiftNL, derivatives_countNL]<class U>(const std::type_identity<U>) {
+            for(const size_t qL : std::ranges::iota_view{0u, qnodes_countL}) {
+                const auto indices = quadrature_neighbours.indices(qshiftL + qL, neighbour);
+                const auto values = quadrature_neighbours.template values<U>(qshiftL + qL, neighbour);
+                if (is_affineNL) {
+                    const T values_sum = std::reduce(values.begin(), values.end(), T{0});
+                    for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                        inner_integrals[jNL] = values_sum * mesh.derivatives(derivatives_shiftNL + jNL, NONLOCAL_INNER);
+                } else
+                    for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL}) {
+                        const size_t derivatives_shift = derivatives_shiftNL + jNL * derivatives_countNL;
+                        inner_integrals[jNL] = {};
+                        for(const size_t k : std::ranges::iota_view{0u, indices.size()})
+                            inner_integrals[jNL] += T(values[k]) * mesh.derivatives(derivatives_shift, indices[k] - qshiftNL, NONLOCAL_INNER);
+                    }
+                integrate_outer(ShapeL::weight(elL, qL), qL);
+            }
+        });
+        integrate_affine_outer();
+        return;
+    }
+
+    auto&& qcoords_buffer = shape_buffer<ShapeNL, std::array<T, 2>, ShapeNL::qnodes, 2>(qnodes_countNL);
+    const std::span<const std::array<T, 2>> qcoordsNL = mesh.quad_coords(eNL, qcoords_buffer, NONLOCAL_INNER);
+    auto&& influences = shape_buffer<ShapeNL, T, ShapeNL::qnodes>(qnodes_countNL);
+    for(const size_t qL : std::ranges::iota_view{0u, qnodes_countL}) {
+        influence::evaluate(influence, mesh.quad_coord(qshiftL + qL, NONLOCAL_OUTER), qcoordsNL, std::span<T>{influences.data(), qnodes_countNL});
+        for(const size_t qNL : std::ranges::iota_view{0u, qnodes_countNL})
+            influences[qNL] *= ShapeNL::weight(elNL, qNL);
+        if (is_affineNL) {
+            const T influences_sum = std::reduce(influences.begin(), std::next(influences.begin(), qnodes_countNL), T{0});
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL})
+                inner_integrals[jNL] = influences_sum * mesh.derivatives(derivatives_shiftNL + jNL, NONLOCAL_INNER);
+        } else
+            for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL}) {
+                const size_t derivatives_shift = derivatives_shiftNL + jNL * derivatives_countNL;
+                inner_integrals[jNL] = {};
+                for(const size_t qNL : std::ranges::iota_view{0u, qnodes_countNL})
+                    inner_integrals[jNL] += influences[qNL] * mesh.derivatives(derivatives_shift, qNL, NONLOCAL_INNER);
+            }
+        integrate_outer(ShapeL::weight(elL, qL), qL);
+    }
+    integrate_affine_outer();
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Influence, class Integrator>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::integrate_nonloc_pair(
+    const Influence& influence, const size_t eL, const size_t eNL, const Integrator& integrator) const {
+    using enum mesh::quadrature_set_t;
+    const auto& container = mesh().container();
+    if (const mesh::element_2d_t type = container.element_type_2d(eL); type == container.element_type_2d(eNL))
+        mesh::visit_element_2d_shape(type, container.element_2d(eL, NONLOCAL_OUTER),
+            [this, &influence, &integrator, &elNL = container.element_2d(eNL, NONLOCAL_INNER), eL, eNL]<class Shape>(const Shape) {
+                if constexpr (Shape::is_static)
+                    if (!Shape::is_matched(elNL))
+                        return integrate_nonloc_pair_kernel<mesh::dynamic_element_2d_shape, mesh::dynamic_element_2d_shape>(influence, eL, eNL, integrator);
+                integrate_nonloc_pair_kernel<Shape, Shape>(influence, eL, eNL, integrator);
+            });
+    else
+        integrate_nonloc_pair_kernel<mesh::dynamic_element_2d_shape, mesh::dynamic_element_2d_shape>(influence, eL, eNL, integrator);
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Initializer>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::node_run(const std::unordered_map<std::string, theory_t>& theories,
+                                                                 Initializer& initializer, const size_t node) const {
+    if constexpr (std::is_base_of_v<indexator_base<DoF>, Initializer>)
+        initializer.reset(node);
+    for(const I eL : mesh().elements(node)) {
+        const size_t iL = mesh().global_to_local(eL, node);
+        const std::string& group = mesh().container().group(eL);
+        if (const theory_t theory = theories.at(group); theory == theory_t::LOCAL)
+            for(const size_t jL : std::ranges::iota_view{0u, mesh().container().nodes_count(eL)})
+                initializer(group, eL, iL, jL);
+        else if (theory == theory_t::NONLOCAL)
+            for(const I eNL : mesh().neighbours(eL))
+                for(const size_t jNL : std::ranges::iota_view{0u, mesh().container().nodes_count(eNL)})
+                    initializer(group, eL, eNL, iL, jNL);
+        else
+            throw std::domain_error{"Unknown theory."};
+    }
+}
+
 template<size_t DoF, class T, class I, class Matrix_Index>
 template<class Initializer>
 void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::mesh_run(const std::unordered_map<std::string, theory_t>& theories,
                                                                  Initializer&& initializer) {
     const auto process_nodes = mesh().process_nodes();
 #pragma omp parallel for default(none) shared(theories, process_nodes) firstprivate(initializer) schedule(dynamic)
-    for(size_t node = process_nodes.front(); node < *process_nodes.end(); ++node) {
-        if constexpr (std::is_base_of_v<indexator_base<DoF>, Initializer>)
-            initializer.reset(node);
-        for(const I eL : mesh().elements(node)) {
-            const size_t iL = mesh().global_to_local(eL, node);
-            const std::string& group = mesh().container().group(eL);
-            if (const theory_t theory = theories.at(group); theory == theory_t::LOCAL)
-                for(const size_t jL : std::ranges::iota_view{0u, mesh().container().nodes_count(eL)})
-                    initializer(group, eL, iL, jL);
-            else if (theory == theory_t::NONLOCAL)
-                for(const I eNL : mesh().neighbours(eL))
-                    for(const size_t jNL : std::ranges::iota_view{0u, mesh().container().nodes_count(eNL)})
-                        initializer(group, eL, eNL, iL, jNL);
-            else
-                throw std::domain_error{"Unknown theory."};
-        }
+    for(size_t node = process_nodes.front(); node < *process_nodes.end(); ++node)
+        node_run(theories, initializer, node);
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Initializer>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::mesh_run(const std::unordered_map<std::string, theory_t>& theories,
+                                                                 Initializer&& initializer,
+                                                                 const std::vector<std::ranges::iota_view<size_t, size_t>>& threads_rows) {
+    const auto process_nodes = mesh().process_nodes();
+#pragma omp parallel for default(none) shared(theories, process_nodes, threads_rows) firstprivate(initializer) schedule(static, 1)
+    for(size_t thread = 0; thread < threads_rows.size(); ++thread) {
+        // The node belongs to the thread of its first row
+        const size_t begin = std::min(process_nodes.size(), (*threads_rows[thread].begin() + DoF - 1) / DoF);
+        const size_t end = std::min(process_nodes.size(), (*threads_rows[thread].end() + DoF - 1) / DoF);
+        for(const size_t node : std::ranges::iota_view{process_nodes.front() + begin, process_nodes.front() + end})
+            node_run(theories, initializer, node);
     }
 }
 
 template<size_t DoF, class T, class I, class Matrix_Index>
-void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::init_shifts(
+size_t finite_element_matrix_2d<DoF, T, I, Matrix_Index>::count_nonzeros(
     const std::unordered_map<std::string, theory_t>& theories, 
     const std::vector<bool>& is_inner, const bool is_symmetric) {
     const auto process_nodes = mesh().process_nodes();
     const auto process_rows = std::ranges::iota_view{DoF * process_nodes.front(), DoF * *process_nodes.end()};
     mesh_run(theories, shift_initializer<DoF, T, Matrix_Index>{_matrix, mesh().container(), is_inner, process_nodes.front(), is_symmetric});
     first_kind_filler(process_rows, is_inner, [this](const size_t row) { ++matrix_inner().outerIndexPtr()[row + 1]; });
+    size_t nonzeros = 0;
+    for(const auto& matrix : _matrix)
+        for(const size_t row : std::ranges::iota_view{0u, size_t(matrix.rows())})
+            nonzeros += matrix.outerIndexPtr()[row + 1];
+    return nonzeros;
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::init_shifts(
+    const std::unordered_map<std::string, theory_t>& theories, 
+    const std::vector<bool>& is_inner, const bool is_symmetric) {
+    count_nonzeros(theories, is_inner, is_symmetric);
     utils::accumulate_shifts(matrix_inner());
     utils::accumulate_shifts(matrix_bound());
     std::cout << "Non-zero elements count: " << matrix_inner().nonZeros() + matrix_bound().nonZeros() << std::endl;
 }
 
 template<size_t DoF, class T, class I, class Matrix_Index>
-void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::init_indices(
-    const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, 
-    const bool is_symmetric, const bool sort_indices) {
+assembly_plan_2d finite_element_matrix_2d<DoF, T, I, Matrix_Index>::plan(const std::unordered_map<std::string, theory_t>& theories) const {
+    using namespace mesh;
+    const auto& container = mesh().container();
+    size_t local_pairs = 0, nonlocal_pairs = 0, kernel_evaluations = 0, neighbours = 0;
+#pragma omp parallel for default(none) shared(theories, container) reduction(+ : local_pairs, nonlocal_pairs, kernel_evaluations, neighbours)
+    for(size_t eL = 0; eL < container.elements_2d_count(); ++eL) {
+        local_pairs += container.nodes_count(eL) * container.nodes_count(eL);
+        neighbours += mesh().neighbours(eL).size();
+        if (theories.at(container.group(eL)) == theory_t::NONLOCAL) {
+            const size_t qnodesL = container.element_2d(eL, quadrature_set_t::NONLOCAL_OUTER).qnodes_count();
+            nonlocal_pairs += mesh().neighbours(eL).size();
+            for(const I eNL : mesh().neighbours(eL))
+                kernel_evaluations += qnodesL * container.element_2d(eNL, quadrature_set_t::NONLOCAL_INNER).qnodes_count();
+        }
+    }
+    const auto part_memory = [](const Eigen::SparseMatrix<T, Eigen::RowMajor, Matrix_Index>& matrix) {
+        return size_t(matrix.nonZeros()) * (sizeof(T) + sizeof(Matrix_Index)) + size_t(matrix.rows() + 1) * sizeof(Matrix_Index);
+    };
+    return {
+        .rows = size_t(matrix_inner().rows()),
+        .nonzeros = size_t(matrix_inner().nonZeros() + matrix_bound().nonZeros()),
+        .local_pairs = local_pairs,
+        .nonlocal_pairs = nonlocal_pairs,
+        .kernel_evaluations = kernel_evaluations,
+        .matrix_memory = part_memory(matrix_inner()) + part_memory(matrix_bound()),
+        .neighbours_memory = neighbours * (sizeof(I) + sizeof(support_t))
+    };
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::init_portrait(
+    const std::unordered_map<std::string, theory_t>& theories, const std::vector<bool>& is_inner, const bool is_symmetric) {
     const auto process_nodes = mesh().process_nodes();
     const auto process_rows = std::ranges::iota_view{DoF * process_nodes.front(), DoF * *process_nodes.end()};
-    utils::allocate_matrix(matrix_inner());
-    utils::allocate_matrix(matrix_bound());
-    mesh_run(theories, index_initializer<DoF, T, Matrix_Index>{_matrix, mesh().container(), is_inner, process_nodes.front(), is_symmetric});
-    first_kind_filler(process_rows, is_inner, [this, shift = process_rows.front()](const size_t row) { 
-        matrix_inner().innerIndexPtr()[matrix_inner().outerIndexPtr()[row]] = row + shift; 
-    });
-    if (sort_indices) {
-        utils::sort_indices(matrix_inner());
-        utils::sort_indices(matrix_bound());
+    portrait_columns<DoF, Matrix_Index> columns{size_t(parallel_utils::threads_count()), size_t(matrix_inner().rows())};
+    mesh_run(theories, portrait_initializer<DoF, T, Matrix_Index>{_matrix, columns, mesh().container(), is_inner, process_nodes.front(), is_symmetric});
+    first_kind_filler(process_rows, is_inner, [this](const size_t row) { ++matrix_inner().outerIndexPtr()[row + 1]; });
+    utils::accumulate_shifts(matrix_inner());
+    utils::accumulate_shifts(matrix_bound());
+    std::cout << "Non-zero elements count: " << matrix_inner().nonZeros() + matrix_bound().nonZeros() << std::endl;
+
+    // The pages of the rows are first touched by the threads which will assemble and multiply them
+    const auto threads_rows = utils::threads_rows(matrix_inner());
+    for(const matrix_part part : {matrix_part::INNER, matrix_part::BOUND}) {
+        auto& matrix = _matrix[size_t(part)];
+        matrix.data().resize(matrix.outerIndexPtr()[matrix.rows()]);
+#pragma omp parallel for default(none) shared(matrix, columns, part, is_inner, process_rows, threads_rows) schedule(static, 1)
+        for(size_t thread = 0; thread < threads_rows.size(); ++thread)
+            for(const size_t row : threads_rows[thread]) {
+                const auto& segment = columns.segments[size_t(part)][row];
+                const auto& row_columns = columns.threads[segment.thread][size_t(part)][row % DoF];
+                Matrix_Index* indices = &matrix.innerIndexPtr()[matrix.outerIndexPtr()[row]];
+                if (part == matrix_part::INNER && row < process_rows.size() && !is_inner[row + process_rows.front()])
+                    *indices++ = row + process_rows.front();
+                indices = std::copy(std::next(row_columns.begin(), segment.begin), std::next(row_columns.begin(), segment.end), indices);
+                std::sort(&matrix.innerIndexPtr()[matrix.outerIndexPtr()[row]], indices);
+                std::fill(&matrix.valuePtr()[matrix.outerIndexPtr()[row]], &matrix.valuePtr()[matrix.outerIndexPtr()[row + 1]], T{0});
+            }
+    }
+}
+
+template<size_t DoF, class T, class I, class Matrix_Index>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::share_portrait(const finite_element_matrix_2d& other) {
+    const auto threads_rows = utils::threads_rows(other.matrix_inner());
+    for(const matrix_part part : {matrix_part::INNER, matrix_part::BOUND}) {
+        auto& matrix = _matrix[size_t(part)];
+        const auto& other_matrix = other._matrix[size_t(part)];
+        matrix.resize(other_matrix.rows(), other_matrix.cols());
+        std::copy_n(other_matrix.outerIndexPtr(), other_matrix.rows() + 1, matrix.outerIndexPtr());
+        matrix.data().resize(other_matrix.nonZeros());
+#pragma omp parallel for default(none) shared(matrix, other_matrix, threads_rows) schedule(static, 1)
+        for(size_t thread = 0; thread < threads_rows.size(); ++thread)
+            for(const size_t row : threads_rows[thread]) {
+                const Matrix_Index begin = other_matrix.outerIndexPtr()[row], end = other_matrix.outerIndexPtr()[row + 1];
+                std::copy(&other_matrix.innerIndexPtr()[begin], &other_matrix.innerIndexPtr()[end], &matrix.innerIndexPtr()[begin]);
+                std::fill(&matrix.valuePtr()[begin], &matrix.valuePtr()[end], T{0});
+            }
     }
 }
 
@@ -170,12 +501,30 @@ void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::calc_coeffs(
     const auto process_nodes = mesh().process_nodes();
     const auto process_rows = std::ranges::iota_view{DoF * process_nodes.front(), DoF * *process_nodes.end()};
     mesh_run(theories, integrator<DoF, T, Matrix_Index, Integrate_Loc, Integrate_Nonloc>{
-        _matrix, mesh().container(), is_inner, process_nodes.front(), is_symmetric, integrate_loc, integrate_nonloc});
+        _matrix, mesh().container(), is_inner, process_nodes.front(), is_symmetric, integrate_loc, integrate_nonloc},
+        utils::threads_rows(matrix_inner()));
     first_kind_filler(process_rows, is_inner, [this](const size_t row) { 
         matrix_inner().valuePtr()[matrix_inner().outerIndexPtr()[row]] = T{1};
     });
 }
 
+template<size_t DoF, class T, class I, class Matrix_Index>
+template<class Integrate_Pair>
+void finite_element_matrix_2d<DoF, T, I, Matrix_Index>::calc_nonlocal_pairs(
+    const std::unordered_set<std::string>& groups, const std::vector<bool>& is_inner, Integrate_Pair&& integrate_pair) {
+    pair_integrator<DoF, T, Matrix_Index, Integrate_Pair> integrator{
+        _matrix, mesh().container(), is_inner, mesh().process_nodes(), integrate_pair};
+    for(const std::string& group : groups)
+        for(const auto elements : mesh().container().elements_batches(group)) {
+#pragma omp parallel for default(none) shared(group, elements) firstprivate(integrator) schedule(dynamic)
+            for(size_t eL = elements.front(); eL < *elements.end(); ++eL) {
+                const std::vector<I>& neighbours = mesh().neighbours(eL);
+                for(auto it = std::lower_bound(neighbours.begin(), neighbours.end(), I(eL)); it != neighbours.end(); ++it)
+                    integrator(group, eL, *it);
+            }
+        }
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,284 @@
+#ifndef NONLOCAL_HIERARCHICAL_INFLUENCE_MATRIX_2D_HPP
+#define NONLOCAL_HIERARCHICAL_INFLUENCE_MATRIX_2D_HPP
+
+#include "cluster_tree_2d.hpp"
+#include "adaptive_cross_approximation.hpp"
+
+#include "OMP_utils.hpp"
+#include "init_balanced_ranges.hpp"
+#include "init_uniform_ranges.hpp"
+
+#include <Eigen/Sparse>
+
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace nonlocal {
+
+template<class T>
+struct hierarchical_parameters final {
+    T tolerance = T{1e-6};
+    T admissibility = T{2};
+    size_t leaf_size = 32;
+};
+
+// Hierarchical approximation of the matrix Φ_ij = φ(x_i, x_j), where x_i are quadrature nodes of the elements group.
+// Admissible (far) blocks are compressed with the adaptive cross approximation,
+// inadmissible (near) blocks are stored as sparse entries.
+// If the influence function support is known, blocks outside of it are not stored at all.
+template<class T, class I>
+class hierarchical_influence_matrix_2d final {
+public:
+    struct level_statistics final {
+        size_t low_rank_blocks = 0;
+        size_t near_blocks = 0;
+        size_t low_rank_memory = 0;
+        size_t near_memory = 0;
+        size_t max_rank = 0;
+    };
+
+private:
+    using cluster_t = typename mesh::cluster_tree_2d<T, I>::cluster;
+
+    struct far_block final {
+        size_t rows_begin = 0;
+        size_t cols_begin = 0;
+        size_t level = 0;
+        slae::low_rank_block<T> block;
+    };
+
+    std::vector<size_t> _quad_permutation; // permuted index -> group local quadrature index
+    std::vector<far_block> _far;
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> _near;
+    std::vector<level_statistics> _statistics;
+    std::vector<std::ranges::iota_view<size_t, size_t>> _threads_far;               // far blocks of the threads balanced by their costs
+    std::vector<std::vector<std::ranges::iota_view<size_t, size_t>>> _threads_rows; // sorted disjoint rows touched by the far blocks of the threads
+    std::vector<std::ranges::iota_view<size_t, size_t>> _reduction_ranges;
+    mutable Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> _threaded_y;           // only the touched rows of the threads are zeroed
+    mutable Eigen::Matrix<T, Eigen::Dynamic, 2> _x_permuted;
+    mutable Eigen::Matrix<T, Eigen::Dynamic, 2> _y_permuted;
+
+    static mesh::support_t classify(const cluster_t& rows, const cluster_t& cols, const std::optional<mesh::support_2d<T>>& support);
+
+    void init_threads(const size_t threads_count);
+
+public:
+    template<class Influence>
+    explicit hierarchical_influence_matrix_2d(const mesh::mesh_2d<T, I>& mesh, const std::string& group, const Influence& influence,
+                                              const hierarchical_parameters<T>& parameters,
+                                              const std::optional<mesh::support_2d<T>>& support = std::nullopt);
+
+    size_t size() const noexcept;
+    size_t memory() const noexcept;
+    const std::vector<level_statistics>& statistics() const noexcept;
+
+    // y = Φ * x, both vectors are indexed by quadrature nodes of the group
+    void multiply(Eigen::Matrix<T, Eigen::Dynamic, 2>& y, const Eigen::Matrix<T, Eigen::Dynamic, 2>& x) const;
+};
+
+template<class T, class I>
+template<class Influence>
+hierarchical_influence_matrix_2d<T, I>::hierarchical_influence_matrix_2d(
+    const mesh::mesh_2d<T, I>& mesh, const std::string& group, const Influence& influence,
+    const hierarchical_parameters<T>& parameters, const std::optional<mesh::support_2d<T>>& support) {
+    const auto elements = mesh.container().elements(group);
+    const mesh::cluster_tree_2d<T, I> tree{mesh, elements, parameters.leaf_size};
+    const size_t quad_shift = mesh.quad_shift(elements.front());
+
+    std::vector<size_t> quad_offsets;
+    quad_offsets.reserve(elements.size() + 1);
+    quad_offsets.push_back(0);
+    _quad_permutation.reserve(mesh.quad_shift(*elements.end()) - quad_shift);
+    for(const I e : tree.elements(tree.root())) {
+        for(const size_t qshift : mesh.quad_shifts_count(e))
+            _quad_permutation.push_back(qshift - quad_shift);
+        quad_offsets.push_back(_quad_permutation.size());
+    }
+
+    std::vector<std::array<const cluster_t*, 2>> near_pairs, far_pairs;
+    std::vector<std::array<const cluster_t*, 2>> stack = {{&tree.root(), &tree.root()}};
+    while(!stack.empty()) {
+        const auto [rows, cols] = stack.back();
+        stack.pop_back();
+        const mesh::support_t type = classify(*rows, *cols, support);
+        if (type == mesh::support_t::OUTSIDE)
+            continue;
+        if (const T distance = rows->box.distance(cols->box); type == mesh::support_t::INSIDE &&
+            distance > T{0} && std::min(rows->box.diameter(), cols->box.diameter()) <= parameters.admissibility * distance)
+            far_pairs.push_back({rows, cols});
+        else if (tree.is_leaf(*rows) && tree.is_leaf(*cols))
+            near_pairs.push_back({rows, cols});
+        else if (tree.is_leaf(*rows))
+            for(const size_t col : cols->children)
+                stack.push_back({rows, &tree.at(col)});
+        else if (tree.is_leaf(*cols))
+            for(const size_t row : rows->children)
+                stack.push_back({&tree.at(row), cols});
+        else
+            for(const size_t row : rows->children)
+                for(const size_t col : cols->children)
+                    stack.push_back({&tree.at(row), &tree.at(col)});
+    }
+
+    const auto coord = [this, &mesh, quad_shift](const size_t index) {
+        return mesh.quad_coord(quad_shift + _quad_permutation[index]);
+    };
+    const auto quad_range = [&quad_offsets](const cluster_t& cl) {
+        return std::ranges::iota_view{quad_offsets[cl.begin], quad_offsets[cl.end]};
+    };
+
+    std::vector<std::optional<far_block>> far_blocks(far_pairs.size());
+#pragma omp parallel for default(none) shared(far_pairs, far_blocks, influence, parameters, coord, quad_range) schedule(dynamic)
+    for(size_t b = 0; b < far_pairs.size(); ++b) {
+        const auto rows = quad_range(*far_pairs[b].front());
+        const auto cols = quad_range(*far_pairs[b].back());
+        const auto entry = [&influence, &coord, &rows, &cols](const size_t i, const size_t j) {
+            return influence(coord(rows[i]), coord(cols[j]));
+        };
+        if (auto block = slae::adaptive_cross_approximation<T>(rows.size(), cols.size(), entry,
+                                                                parameters.tolerance, std::min(rows.size(), cols.size()) / 2))
+            far_blocks[b] = far_block{.rows_begin = rows.front(), .cols_begin = cols.front(),
+                                      .level = far_pairs[b].front()->level, .block = std::move(*block)};
+    }
+    for(const size_t b : std::ranges::iota_view{0u, far_pairs.size()})
+        if (far_blocks[b])
+            _far.push_back(std::move(*far_blocks[b]));
+        else // the block turned out to be incompressible
+            near_pairs.push_back(far_pairs[b]);
+
+    std::vector<std::vector<Eigen::Triplet<T, I>>> threaded_triplets(parallel_utils::threads_count());
+    std::vector<size_t> near_blocks_sizes(near_pairs.size(), 0);
+#pragma omp parallel for default(none) shared(near_pairs, near_blocks_sizes, threaded_triplets, influence, coord, quad_range) schedule(dynamic)
+    for(size_t b = 0; b < near_pairs.size(); ++b) {
+#ifdef _OPENMP
+        auto& triplets = threaded_triplets[omp_get_thread_num()];
+#else
+        auto& triplets = threaded_triplets.front();
+#endif
+        const size_t size_before = triplets.size();
+        for(const size_t row : quad_range(*near_pairs[b].front()))
+            for(const size_t col : quad_range(*near_pairs[b].back()))
+                if (const T value = influence(coord(row), coord(col)); value != T{0})
+                    triplets.emplace_back(row, col, value);
+        near_blocks_sizes[b] = triplets.size() - size_before;
+    }
+    std::vector<Eigen::Triplet<T, I>> triplets;
+    for(auto& thread_triplets : threaded_triplets) {
+        triplets.insert(triplets.end(), thread_triplets.begin(), thread_triplets.end());
+        thread_triplets = {};
+    }
+    if (triplets.size() > size_t(std::numeric_limits<I>::max()))
+        throw std::overflow_error{"The number of the near field elements exceeds the range of the matrix index type."};
+    _near.resize(_quad_permutation.size(), _quad_permutation.size());
+    _near.setFromTriplets(triplets.begin(), triplets.end());
+
+    _statistics.resize(tree.levels());
+    for(const far_block& block : _far) {
+        level_statistics& level = _statistics[block.level];
+        ++level.low_rank_blocks;
+        level.low_rank_memory += block.block.memory();
+        level.max_rank = std::max(level.max_rank, block.block.rank());
+    }
+    for(const size_t b : std::ranges::iota_view{0u, near_pairs.size()}) {
+        level_statistics& level = _statistics[near_pairs[b].front()->level];
+        ++level.near_blocks;
+        level.near_memory += near_blocks_sizes[b] * (sizeof(T) + sizeof(I));
+    }
+
+    init_threads(parallel_utils::threads_count());
+}
+
+template<class T, class I>
+void hierarchical_influence_matrix_2d<T, I>::init_threads(const size_t threads_count) {
+    std::vector<size_t> costs(_far.size() + 1, 0);
+    for(const size_t b : std::ranges::iota_view{0u, _far.size()})
+        costs[b + 1] = costs[b] + _far[b].block.rank() * (_far[b].block.U.rows() + _far[b].block.V.rows());
+    _threads_far = parallel_utils::init_balanced_ranges(std::span<const size_t>{costs}, std::clamp(threads_count, size_t{1}, std::max(_far.size(), size_t{1})));
+    _threads_rows.resize(_threads_far.size());
+    for(const size_t thread : std::ranges::iota_view{0u, _threads_far.size()}) {
+        std::vector<std::array<size_t, 2>> blocks_rows;
+        for(const size_t b : _threads_far[thread])
+            blocks_rows.push_back({_far[b].rows_begin, _far[b].rows_begin + _far[b].block.U.rows()});
+        std::sort(blocks_rows.begin(), blocks_rows.end());
+        auto& rows = _threads_rows[thread];
+        for(const auto [begin, end] : blocks_rows)
+            if (!rows.empty() && begin <= *rows.back().end())
+                rows.back() = {*rows.back().begin(), std::max(*rows.back().end(), end)};
+            else
+                rows.push_back({begin, end});
+    }
+    _reduction_ranges = parallel_utils::init_uniform_ranges(size(), std::clamp(threads_count, size_t{1}, std::max(size(), size_t{1})));
+    _threaded_y.resize(size(), 2 * _threads_far.size());
+    _x_permuted.resize(size(), 2);
+    _y_permuted.resize(size(), 2);
+}
+
+// Compactly supported influence functions are not smooth on the support boundary,
+// so only the blocks which lie entirely inside the support are suitable for the low-rank approximation.
+template<class T, class I>
+mesh::support_t hierarchical_influence_matrix_2d<T, I>::classify(const cluster_t& rows, const cluster_t& cols,
+                                                                const std::optional<mesh::support_2d<T>>& support) {
+    return support ? support->classify(rows.box, cols.box) : mesh::support_t::INSIDE;
+}
+
+template<class T, class I>
+size_t hierarchical_influence_matrix_2d<T, I>::size() const noexcept {
+    return _quad_permutation.size();
+}
+
+template<class T, class I>
+size_t hierarchical_influence_matrix_2d<T, I>::memory() const noexcept {
+    size_t memory = 0;
+    for(const level_statistics& level : statistics())
+        memory += level.low_rank_memory + level.near_memory;
+    return memory;
+}
+
+template<class T, class I>
+const std::vector<typename hierarchical_influence_matrix_2d<T, I>::level_statistics>&
+hierarchical_influence_matrix_2d<T, I>::statistics() const noexcept {
+    return _statistics;
+}
+
+template<class T, class I>
+void hierarchical_influence_matrix_2d<T, I>::multiply(Eigen::Matrix<T, Eigen::Dynamic, 2>& y, const Eigen::Matrix<T, Eigen::Dynamic, 2>& x) const {
+#pragma omp parallel for default(none) shared(x)
+    for(size_t i = 0; i < size(); ++i)
+        _x_permuted.row(i) = x.row(_quad_permutation[i]);
+    _y_permuted.noalias() = _near * _x_permuted;
+
+#pragma omp parallel for default(none) schedule(static, 1) num_threads(_threads_far.size())
+    for(size_t thread = 0; thread < _threads_far.size(); ++thread) {
+        for(const auto& rows : _threads_rows[thread])
+            _threaded_y.block(*rows.begin(), 2 * thread, rows.size(), 2).setZero();
+        for(const size_t b : _threads_far[thread]) {
+            const auto& [rows_begin, cols_begin, level, block] = _far[b];
+            const Eigen::Matrix<T, Eigen::Dynamic, 2> projection = block.V.transpose() * _x_permuted.middleRows(cols_begin, block.V.rows());
+            _threaded_y.block(rows_begin, 2 * thread, block.U.rows(), 2).noalias() += block.U * projection;
+        }
+    }
+
+    // Each range of the rows gathers the intersections with the touched rows of all threads
+#pragma omp parallel for default(none) schedule(static, 1) num_threads(_reduction_ranges.size())
+    for(size_t range = 0; range < _reduction_ranges.size(); ++range) {
+        const size_t begin = *_reduction_ranges[range].begin(), end = *_reduction_ranges[range].end();
+        for(const size_t thread : std::ranges::iota_view{0u, _threads_rows.size()}) {
+            const auto& rows = _threads_rows[thread];
+            auto it = std::lower_bound(rows.begin(), rows.end(), begin, [](const auto& touched, const size_t row) { return *touched.end() <= row; });
+            for(; it != rows.end() && *it->begin() < end; ++it) {
+                const size_t first = std::max(*it->begin(), begin), last = std::min(*it->end(), end);
+                _y_permuted.middleRows(first, last - first) += _threaded_y.block(first, 2 * thread, last - first, 2);
+            }
+        }
+    }
+
+    y.resize(size(), 2);
+#pragma omp parallel for default(none) shared(y)
+    for(size_t i = 0; i < size(); ++i)
+        y.row(_quad_permutation[i]) = _y_permuted.row(i);
+}
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef NONLOCAL_NONLOCAL_QUADRATURE_RULES_2D_HPP
+#define NONLOCAL_NONLOCAL_QUADRATURE_RULES_2D_HPP
+
+#include "../influence_functions_2d.hpp"
+
+#include "mesh_2d.hpp"
+
+#include <atomic>
+
+namespace nonlocal {
+
+enum class nonlocal_rule_t : uint8_t {
+    FULL,         // qL x qNL influence function evaluations
+    INNER_CENTRE, // influence function is frozen at the centre of eNL, qL evaluations
+    CENTRES       // influence function is frozen at the centres of both elements, single evaluation
+};
+
+// Reduced quadratures for the pairs of elements, over which the influence function is almost constant.
+// The rule is chosen from the influence function variation estimated in the corners and centres
+// of the quadrature nodes bounding boxes. Pairs which cut the influence function support boundary
+// always use the full quadrature, since the influence function is not smooth there.
+// The same holds for the truncated normal distribution.
+// For the constant influence function the pairs inside the support are integrated exactly with the CENTRES rule.
+template<class T, class I>
+class nonlocal_quadrature_rules_2d final {
+    struct last_rule final {
+        size_t generation = 0;
+        size_t eL = 0;
+        size_t eNL = 0;
+        nonlocal_rule_t rule = nonlocal_rule_t::FULL;
+    };
+
+    static inline std::atomic<size_t> _generations = 0;
+
+    std::vector<std::vector<nonlocal_rule_t>> _rules; // the same order as in mesh_2d::neighbours
+    std::vector<mesh::bounding_box_2d<T>> _boxes;
+    std::vector<std::array<T, 2>> _centres;
+    size_t _generation = ++_generations; // identifies the rules in the thread local cache of the last found rule
+
+    static std::array<std::array<T, 2>, 5> samples(const mesh::bounding_box_2d<T>& box);
+
+    template<class Influence>
+    nonlocal_rule_t rule(const Influence& influence, const size_t eL, const size_t eNL, const T tolerance) const;
+
+public:
+    template<class Influence>
+    void compute(const mesh::mesh_2d<T, I>& mesh, const std::string& group, const Influence& influence, const T tolerance);
+    void clear();
+
+    nonlocal_rule_t rule(const mesh::mesh_2d<T, I>& mesh, const size_t eL, const size_t eNL) const;
+    const std::array<T, 2>& centre(const size_t e) const;
+};
+
+template<class T, class I>
+std::array<std::array<T, 2>, 5> nonlocal_quadrature_rules_2d<T, I>::samples(const mesh::bounding_box_2d<T>& box) {
+    return {
+        box.center(),
+        std::array{box.min[X], box.min[Y]}, std::array{box.max[X], box.min[Y]},
+        std::array{box.min[X], box.max[Y]}, std::array{box.max[X], box.max[Y]}
+    };
+}
+
+template<class T, class I>
+template<class Influence>
+nonlocal_rule_t nonlocal_quadrature_rules_2d<T, I>::rule(const Influence& influence, const size_t eL, const size_t eNL, const T tolerance) const {
+    const T central = influence(centre(eL), centre(eNL));
+    T inner_variation = T{0}, variation = T{0};
+    for(const std::array<T, 2>& pointL : samples(_boxes[eL])) {
+        const T inner_central = influence(pointL, centre(eNL));
+        for(const std::array<T, 2>& pointNL : samples(_boxes[eNL])) {
+            const T value = influence(pointL, pointNL);
+            inner_variation = std::max(inner_variation, std::abs(value - inner_central));
+            variation = std::max(variation, std::abs(value - central));
+            if (inner_variation > tolerance && variation > tolerance)
+                return nonlocal_rule_t::FULL;
+        }
+    }
+    if (variation <= tolerance)
+        return nonlocal_rule_t::CENTRES;
+    if (inner_variation <= tolerance)
+        return nonlocal_rule_t::INNER_CENTRE;
+    return nonlocal_rule_t::FULL;
+}
+
+template<class T, class I>
+template<class Influence>
+void nonlocal_quadrature_rules_2d<T, I>::compute(const mesh::mesh_2d<T, I>& mesh, const std::string& group,
+                                                 const Influence& influence, const T tolerance) {
+    static constexpr bool is_constant = std::is_same_v<Influence, influence::constant_2d<T, 2>>;
+    if (tolerance <= T{0} && !is_constant)
+        return;
+    _generation = ++_generations;
+    const size_t elements_count = mesh.container().elements_2d_count();
+    if (_boxes.empty()) {
+        _boxes.resize(elements_count);
+        _centres.resize(elements_count);
+#pragma omp parallel for default(none) shared(mesh, elements_count)
+        for(size_t e = 0; e < elements_count; ++e) {
+            _boxes[e] = mesh.nonlocal_bounding_box(e);
+            _centres[e] = _boxes[e].center();
+        }
+    }
+    _rules.resize(elements_count);
+
+    bool is_smooth = false;
+    if constexpr (std::is_same_v<Influence, influence::normal_distribution_2d<T>>)
+        is_smooth = !influence.is_truncated();
+    const auto elements = mesh.container().elements(group);
+#pragma omp parallel for default(none) shared(mesh, influence, tolerance, elements, is_smooth) schedule(dynamic)
+    for(size_t eL = elements.front(); eL < *elements.end(); ++eL) {
+        const std::vector<I>& neighbours = mesh.neighbours(eL);
+        const std::vector<mesh::support_t>& types = mesh.neighbours_types(eL);
+        const T absolute_tolerance = tolerance * std::abs(influence(centre(eL), centre(eL)));
+        _rules[eL].assign(neighbours.size(), nonlocal_rule_t::FULL);
+        for(const size_t k : std::ranges::iota_view{0u, neighbours.size()})
+            if constexpr (is_constant)
+                _rules[eL][k] = types[k] == mesh::support_t::INSIDE ? nonlocal_rule_t::CENTRES : nonlocal_rule_t::FULL;
+            else if (is_smooth || types[k] == mesh::support_t::INSIDE)
+                _rules[eL][k] = rule(influence, eL, neighbours[k], absolute_tolerance);
+    }
+}
+
+template<class T, class I>
+void nonlocal_quadrature_rules_2d<T, I>::clear() {
+    _rules.clear();
+    _boxes.clear();
+    _centres.clear();
+    _generation = ++_generations;
+}
+
+template<class T, class I>
+nonlocal_rule_t nonlocal_quadrature_rules_2d<T, I>::rule(const mesh::mesh_2d<T, I>& mesh, const size_t eL, const size_t eNL) const {
+    if (eL >= _rules.size() || _rules[eL].empty())
+        return nonlocal_rule_t::FULL;
+    // The rule is requested for all pairs of nodes of the elements one after another
+    thread_local last_rule last;
+    if (last.generation != _generation || last.eL != eL || last.eNL != eNL) {
+        const std::vector<I>& neighbours = mesh.neighbours(eL);
+        const auto it = std::lower_bound(neighbours.begin(), neighbours.end(), I(eNL));
+        last = {.generation = _generation, .eL = eL, .eNL = eNL, .rule = _rules[eL][std::distance(neighbours.begin(), it)]};
+    }
+    return last.rule;
+}
+
+template<class T, class I>
+const std::array<T, 2>& nonlocal_quadrature_rules_2d<T, I>::centre(const size_t e) const {
+    return _centres[e];
+}
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef NONLOCAL_PAIR_INTEGRATOR_HPP
+#define NONLOCAL_PAIR_INTEGRATOR_HPP
+
+#include "mesh_container_2d.hpp"
+
+#include "matrix_separator_base.hpp"
+
+namespace nonlocal {
+
+// Integrates the unordered pair of the neighbour elements (eL, eNL) once and adds the block
+// to the rows of the nodes of eL and its transpose to the rows of the nodes of eNL.
+// It is valid only for the symmetric problems, where the block of (eNL, eL) is the transposed block of (eL, eNL).
+// The rows are shared between the threads, so the coefficients are updated atomically.
+template<size_t DoF, class T, class I, class Integrate_Pair>
+class pair_integrator final : public matrix_separator_base<T, I> {
+    using _base = matrix_separator_base<T, I>;
+    using block_t = metamath::types::square_matrix<T, DoF>;
+
+    const mesh::mesh_container_2d<T, I>& _mesh;
+    const std::ranges::iota_view<size_t, size_t> _process_nodes;
+    const Integrate_Pair& _integrate_pair;
+    std::vector<block_t> _blocks; // nodes_count(eL) x nodes_count(eNL) row major
+
+    bool is_process_element(const size_t e) const;
+    void add(const size_t row_node, const size_t col_node, const block_t& block, const bool is_transposed);
+
+public:
+    explicit pair_integrator(matrix_parts_t<T, I>& matrix, const mesh::mesh_container_2d<T, I>& mesh, const std::vector<bool>& is_inner,
+                             const std::ranges::iota_view<size_t, size_t> process_nodes, const Integrate_Pair& integrate_pair);
+    ~pair_integrator() noexcept override = default;
+
+    void operator()(const std::string& group, const size_t eL, const size_t eNL);
+};
+
+template<size_t DoF, class T, class I, class Integrate_Pair>
+pair_integrator<DoF, T, I, Integrate_Pair>::pair_integrator(
+    matrix_parts_t<T, I>& matrix, const mesh::mesh_container_2d<T, I>& mesh, const std::vector<bool>& is_inner,
+    const std::ranges::iota_view<size_t, size_t> process_nodes, const Integrate_Pair& integrate_pair)
+    : _base{matrix, is_inner, process_nodes.front(), true}
+    , _mesh{mesh}
+    , _process_nodes{process_nodes}
+    , _integrate_pair{integrate_pair} {}
+
+template<size_t DoF, class T, class I, class Integrate_Pair>
+bool pair_integrator<DoF, T, I, Integrate_Pair>::is_process_element(const size_t e) const {
+    for(const size_t i : std::ranges::iota_view{0u, _mesh.nodes_count(e)})
+        if (const size_t node = _mesh.node_number(e, i); node >= _process_nodes.front() && node < *_process_nodes.end())
+            return true;
+    return false;
+}
+
+template<size_t DoF, class T, class I, class Integrate_Pair>
+void pair_integrator<DoF, T, I, Integrate_Pair>::add(const size_t row_node, const size_t col_node, const block_t& block, const bool is_transposed) {
+    if (row_node < _process_nodes.front() || row_node >= *_process_nodes.end())
+        return;
+    for(const size_t row_loc : std::ranges::iota_view{0u, DoF})
+        for(const size_t col_loc : std::ranges::iota_view{0u, DoF}) {
+            const size_t row = DoF * row_node + row_loc;
+            const size_t col = DoF * col_node + col_loc;
+            if (const matrix_part part = _base::part(row, col); part != matrix_part::NO) {
+                T& coefficient = _base::matrix(part).coeffRef(row - DoF * _base::node_shift(), col);
+                const T value = is_transposed ? block[col_loc][row_loc] : block[row_loc][col_loc];
+#pragma omp atomic
+                coefficient += value;
+            }
+        }
+}
+
+template<size_t DoF, class T, class I, class Integrate_Pair>
+void pair_integrator<DoF, T, I, Integrate_Pair>::operator()(const std::string& group, const size_t eL, const size_t eNL) {
+    if (!is_process_element(eL) && !is_process_element(eNL))
+        return;
+    const size_t nodes_countL = _mesh.nodes_count(eL);
+    const size_t nodes_countNL = _mesh.nodes_count(eNL);
+    _blocks.resize(nodes_countL * nodes_countNL);
+    _integrate_pair(group, eL, eNL, _blocks);
+    for(const size_t iL : std::ranges::iota_view{0u, nodes_countL})
+        for(const size_t jNL : std::ranges::iota_view{0u, nodes_countNL}) {
+            const size_t rowL = _mesh.node_number(eL, iL);
+            const size_t rowNL = _mesh.node_number(eNL, jNL);
+            const block_t& block = _blocks[iL * nodes_countNL + jNL];
+            add(rowL, rowNL, block, false);
+            if (eL != eNL)
+                add(rowNL, rowL, block, true);
+        }
+}
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef NONLOCAL_PORTRAIT_INITIALIZER_HPP
+#define NONLOCAL_PORTRAIT_INITIALIZER_HPP
+
+#include "mesh_container_2d.hpp"
+
+#include "indexator_base.hpp"
+#include "matrix_separator_base.hpp"
+
+namespace nonlocal {
+
+// Columns of the rows found in the single pass over the mesh.
+// Each thread appends the columns of its rows to its own lists, so the row segments refer to the lists of the thread which processed the row.
+template<size_t DoF, class I>
+struct portrait_columns final {
+    struct segment final {
+        size_t thread = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::array<std::array<std::vector<I>, DoF>, 2>> threads;
+    std::array<std::vector<segment>, 2> segments;
+
+    explicit portrait_columns(const size_t threads_count, const size_t rows);
+};
+
+template<size_t DoF, class T, class I>
+class portrait_initializer final : public matrix_separator_base<T, I>
+                                 , public indexator_base<DoF> {
+    using _matrix = matrix_separator_base<T, I>;
+    using _indexator = indexator_base<DoF>;
+
+    portrait_columns<DoF, I>& _columns;
+    const mesh::mesh_container_2d<T, I>& _mesh;
+    size_t _thread = 0;
+
+    void run(const size_t row_glob, const size_t col_glob);
+
+public:
+    explicit portrait_initializer(matrix_parts_t<T, I>& matrix, portrait_columns<DoF, I>& columns, const mesh::mesh_container_2d<T, I>& mesh,
+                                  const std::vector<bool>& is_inner, const size_t node_shift, const bool is_symmetric);
+    ~portrait_initializer() noexcept override = default;
+
+    void reset(const size_t node);
+
+    void operator()(const std::string&, const size_t e, const size_t i, const size_t j);
+    void operator()(const std::string&, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL);
+};
+
+template<size_t DoF, class I>
+portrait_columns<DoF, I>::portrait_columns(const size_t threads_count, const size_t rows)
+    : threads(threads_count)
+    , segments{std::vector<segment>(rows), std::vector<segment>(rows)} {}
+
+template<size_t DoF, class T, class I>
+portrait_initializer<DoF, T, I>::portrait_initializer(matrix_parts_t<T, I>& matrix, portrait_columns<DoF, I>& columns,
+                                                      const mesh::mesh_container_2d<T, I>& mesh, const std::vector<bool>& is_inner,
+                                                      const size_t node_shift, const bool is_symmetric)
+    : _matrix{matrix, is_inner, node_shift, is_symmetric}
+    , _indexator{is_inner.size(), is_symmetric}
+    , _columns{columns}
+    , _mesh{mesh} {}
+
+template<size_t DoF, class T, class I>
+void portrait_initializer<DoF, T, I>::reset(const size_t node) {
+    _thread = omp_get_thread_num();
+    for(const matrix_part part : {matrix_part::INNER, matrix_part::BOUND})
+        for(const size_t dof : std::ranges::iota_view{0u, DoF}) {
+            const size_t size = _columns.threads[_thread][size_t(part)][dof].size();
+            _columns.segments[size_t(part)][DoF * (node - _matrix::node_shift()) + dof] = {.thread = _thread, .begin = size, .end = size};
+        }
+    _indexator::reset(node);
+}
+
+template<size_t DoF, class T, class I>
+void portrait_initializer<DoF, T, I>::run(const size_t row_glob, const size_t col_glob) {
+    for(const size_t row_loc : std::ranges::iota_view{0u, DoF})
+        for(const size_t col_loc : std::ranges::iota_view{0u, DoF}) {
+            const size_t row = row_glob + row_loc;
+            const size_t col = col_glob + col_loc;
+            if (const matrix_part part = _matrix::part(row, col); part != matrix_part::NO)
+                _indexator::check_flag(_indexator::flags(part)[row_loc], col, [this, part, row, col, row_loc]() {
+                    const size_t row_shifted = row - DoF * _matrix::node_shift();
+                    _columns.threads[_thread][size_t(part)][row_loc].push_back(col);
+                    ++_columns.segments[size_t(part)][row_shifted].end;
+                    ++_matrix::matrix(part).outerIndexPtr()[row_shifted + 1];
+                });
+        }
+}
+
+template<size_t DoF, class T, class I>
+void portrait_initializer<DoF, T, I>::operator()(const std::string&, const size_t e, const size_t i, const size_t j) {
+    run(DoF * _mesh.node_number(e, i), DoF * _mesh.node_number(e, j));
+}
+
+template<size_t DoF, class T, class I>
+void portrait_initializer<DoF, T, I>::operator()(const std::string&, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) {
+    run(DoF * _mesh.node_number(eL, iL), DoF * _mesh.node_number(eNL, jNL));
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -17,7 +17,7 @@ void integrate_right_part(Eigen::Matrix<T, Eigen::Dynamic, 1>& right_part,
         const auto& el = mesh.container().element_2d(e);
         for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
             using namespace metamath::functions;
-            integral += el.weight(q) * el.qN(i, q) * mesh::jacobian(mesh.jacobi_matrix(e, q)) * functor(mesh.quad_coord(e, q));
+            integral += mesh.weighted_jacobian(e, q) * el.qN(i, q) * functor(mesh.quad_coord(e, q));
         }
         return integral;
     };
@@ -0,0 +1,90 @@
+#ifndef NONLOCAL_TENSOR_PRODUCT_MATRICES_2D_HPP
+#define NONLOCAL_TENSOR_PRODUCT_MATRICES_2D_HPP
+
+#include "mesh_2d.hpp"
+
+#include <unordered_set>
+
+namespace nonlocal {
+
+// Local matrices of the tensor product elements computed once per element by the sum factorized kernels of tensor_product_2d.
+// The assembly visits each element from all its nodes, so the matrices are kept until the assembly is done.
+// The affine elements, the elements with the small quadratures, see tensor_product_2d::is_factorization_efficient,
+// and the other elements have no matrices and are integrated entry by entry.
+template<class T, class Value = T>
+class tensor_product_matrices_2d final {
+    std::vector<size_t> _shifts; // the matrix of the element e is stored in [_shifts[e], _shifts[e + 1])
+    std::vector<Value> _values;
+    std::vector<uint8_t> _nodes_count;
+
+public:
+    // The matrices are computed for the elements of the groups adjacent to the process nodes.
+    // The kernel is called as kernel(group, e, tensor_product, matrix), where the matrix is stored as matrix[i * nodes_count + j]
+    template<class I, class Kernel>
+    void compute(const mesh::mesh_2d<T, I>& mesh, const std::unordered_set<std::string>& groups, const Kernel& kernel);
+    void clear();
+
+    bool contains(const size_t e) const noexcept;
+    const Value& operator()(const size_t e, const size_t i, const size_t j) const;
+};
+
+template<class T, class Value>
+template<class I, class Kernel>
+void tensor_product_matrices_2d<T, Value>::compute(const mesh::mesh_2d<T, I>& mesh, const std::unordered_set<std::string>& groups,
+                                                   const Kernel& kernel) {
+    clear();
+    const auto is_factorized = [&mesh](const size_t e) {
+        const auto& tensor_product = mesh.container().element_2d(e).tensor_product();
+        return !mesh.is_affine(e) && tensor_product && tensor_product->is_factorization_efficient();
+    };
+    if (std::ranges::none_of(groups, [&mesh, &is_factorized](const std::string& group) {
+            return std::ranges::any_of(mesh.container().elements(group), is_factorized); }))
+        return;
+
+    const size_t elements_count = mesh.container().elements_2d_count();
+    std::vector<bool> is_process_element(elements_count, false);
+    for(const size_t node : mesh.process_nodes())
+        for(const I e : mesh.elements(node))
+            is_process_element[e] = true;
+
+    std::vector<const std::string*> elements_groups(elements_count, nullptr);
+    for(const std::string& group : groups)
+        for(const size_t e : mesh.container().elements(group))
+            if (is_process_element[e] && is_factorized(e))
+                elements_groups[e] = &group;
+
+    _shifts.assign(elements_count + 1, 0);
+    _nodes_count.assign(elements_count, 0);
+    for(const size_t e : std::ranges::iota_view{0u, elements_count}) {
+        if (elements_groups[e])
+            _nodes_count[e] = mesh.container().element_2d(e).nodes_count();
+        _shifts[e + 1] = _shifts[e] + _nodes_count[e] * _nodes_count[e];
+    }
+    _values.resize(_shifts.back());
+#pragma omp parallel for default(none) shared(mesh, kernel, elements_groups, elements_count) schedule(dynamic)
+    for(size_t e = 0; e < elements_count; ++e)
+        if (elements_groups[e])
+            kernel(*elements_groups[e], e, *mesh.container().element_2d(e).tensor_product(),
+                   std::span<Value>{&_values[_shifts[e]], _shifts[e + 1] - _shifts[e]});
+}
+
+template<class T, class Value>
+void tensor_product_matrices_2d<T, Value>::clear() {
+    _shifts = {};
+    _values = {};
+    _nodes_count = {};
+}
+
+template<class T, class Value>
+bool tensor_product_matrices_2d<T, Value>::contains(const size_t e) const noexcept {
+    return e < _nodes_count.size() && _nodes_count[e];
+}
+
+template<class T, class Value>
+const Value& tensor_product_matrices_2d<T, Value>::operator()(const size_t e, const size_t i, const size_t j) const {
+    return _values[_shifts[e] + i * _nodes_count[e] + j];
+}
+
+}
+
+#endif
\ No newline at end of file
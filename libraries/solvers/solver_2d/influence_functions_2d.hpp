@@ -6,6 +6,11 @@
 #include <array>
 #include <cinttypes>
 #include <cmath>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <variant>
 
 namespace nonlocal::influence {
 
@@ -58,6 +63,12 @@ public:
     T operator()(const std::array<T, 2>& x, const std::array<T, 2>& y) const noexcept {
         return _superellipse_region::norm_pow<N>(x, y, _r) < 1 ? _norm : 0;
     }
+
+    void operator()(const std::array<T, 2>& x, const std::span<const std::array<T, 2>> ys, const std::span<T> values) const noexcept {
+#pragma omp simd
+        for(size_t i = 0; i < ys.size(); ++i)
+            values[i] = _superellipse_region::norm_pow<N>(x, ys[i], _r) < 1 ? _norm : 0;
+    }
 };
 
 template<class T, uintmax_t P, uintmax_t Q, uintmax_t N = 2>
@@ -90,32 +101,150 @@ public:
         else
             return h < 1 ? _norm * power<Q>(1 - power<P / N>(h)) : 0;
     }
+
+    void operator()(const std::array<T, 2>& x, const std::span<const std::array<T, 2>> ys, const std::span<T> values) const noexcept {
+        using metamath::functions::power;
+#pragma omp simd
+        for(size_t i = 0; i < ys.size(); ++i) {
+            const T h = _superellipse_region::norm_pow<N>(x, ys[i], _r);
+            if constexpr (P % N)
+                values[i] = h < 1 ? _norm * power<Q>(1 - metamath::functions::vectorizable_pow(h, T{P} / N)) : 0;
+            else
+                values[i] = h < 1 ? _norm * power<Q>(1 - power<P / N>(h)) : 0;
+        }
+    }
 };
 
+// The normal distribution can be truncated by the ellipse, outside of which the tail with the given probability mass remains.
+// The truncated function is renormalized, so its integral is still equal to 1.
 template<class T>
 class normal_distribution_2d final {
     std::array<T, 2> _r = {}, _disp_mul = {};
     T _norm = 0;
+    T _tolerance = 0;
+    T _min_exponent = -std::numeric_limits<T>::infinity(); // exponents below it are outside of the truncation ellipse
 
 public:
-    explicit normal_distribution_2d(const T& r) noexcept { set_radius(r); }
-    explicit normal_distribution_2d(const std::array<T, 2>& r) noexcept { set_radius(r); }
+    explicit normal_distribution_2d(const T& r, const T tolerance = T{0}) noexcept { set_radius(r); set_tolerance(tolerance); }
+    explicit normal_distribution_2d(const std::array<T, 2>& r, const T tolerance = T{0}) noexcept { set_radius(r); set_tolerance(tolerance); }
+
+    // The tail mass beyond the ellipse with the semi-axes rho * r is equal to exp(-rho^2 / 2)
+    static T truncation_factor(const T tolerance) noexcept {
+        return tolerance > T{0} ? std::sqrt(-2 * std::log(tolerance)) : std::numeric_limits<T>::infinity();
+    }
 
     void set_radius(const T& r) noexcept { set_radius(std::array{r, r}); }
     void set_radius(const std::array<T, 2>& r) noexcept {
         _r = r;
         _disp_mul = {-T{0.5} / (_r[0] * _r[0]),
                      -T{0.5} / (_r[1] * _r[1])};
-        _norm = T{0.5} / (std::numbers::pi_v<T> * r[0] * r[1]);
+        _norm = T{0.5} / (std::numbers::pi_v<T> * r[0] * r[1] * (1 - _tolerance));
+    }
+
+    // Zero tolerance disables the truncation
+    void set_tolerance(const T tolerance) noexcept {
+        _tolerance = tolerance;
+        _min_exponent = tolerance > T{0} ? std::log(tolerance) : -std::numeric_limits<T>::infinity();
+        set_radius(_r);
     }
 
     const std::array<T, 2>& radius() const noexcept { return _r; }
     T norm() const noexcept { return _norm; }
+    T tolerance() const noexcept { return _tolerance; }
+    bool is_truncated() const noexcept { return _tolerance > T{0}; }
+    std::array<T, 2> truncation_radius() const noexcept {
+        const T factor = truncation_factor(_tolerance);
+        return {factor * _r[0], factor * _r[1]};
+    }
 
     T operator()(const std::array<T, 2>& x, const std::array<T, 2>& y) const noexcept {
         using metamath::functions::power;
-        return _norm * std::exp(_disp_mul[0] * power<2>(x[0] - y[0]) +
-                                _disp_mul[1] * power<2>(x[1] - y[1]));
+        const T exponent = _disp_mul[0] * power<2>(x[0] - y[0]) +
+                           _disp_mul[1] * power<2>(x[1] - y[1]);
+        return exponent > _min_exponent ? _norm * std::exp(exponent) : 0;
+    }
+
+    void operator()(const std::array<T, 2>& x, const std::span<const std::array<T, 2>> ys, const std::span<T> values) const noexcept {
+        using metamath::functions::power;
+#pragma omp simd
+        for(size_t i = 0; i < ys.size(); ++i) {
+            const T exponent = _disp_mul[0] * power<2>(x[0] - ys[i][0]) +
+                               _disp_mul[1] * power<2>(x[1] - ys[i][1]);
+            values[i] = exponent > _min_exponent ? _norm * metamath::functions::vectorizable_exp(exponent) : 0;
+        }
+    }
+};
+
+// Values of the influence function in the points ys for the fixed point x.
+// Functions without the batch evaluation are evaluated point by point.
+template<class Influence, class T>
+void evaluate(const Influence& influence, const std::array<T, 2>& x,
+              const std::span<const std::array<T, 2>> ys, const std::span<T> values) {
+    if constexpr (requires { influence(x, ys, values); })
+        influence(x, ys, values);
+    else
+        for(const size_t i : std::ranges::iota_view{0u, ys.size()})
+            values[i] = influence(x, ys[i]);
+}
+
+// Closed set of the influence functions used by the solvers.
+// The concrete function is dispatched once with visit, so the loops inside the visitor
+// are compiled for the concrete type and the function calls are inlined.
+// Arbitrary functions are stored in std::function and are evaluated without inlining.
+template<class T>
+class influence_2d final {
+public:
+    using function_t = std::function<T(const std::array<T, 2>&, const std::array<T, 2>&)>;
+
+private:
+    using variant_t = std::variant<constant_2d<T>, polynomial_2d<T, 2, 1>, normal_distribution_2d<T>, function_t>;
+
+    template<class Influence>
+    static constexpr bool is_alternative = std::is_same_v<Influence, constant_2d<T>> ||
+                                           std::is_same_v<Influence, polynomial_2d<T, 2, 1>> ||
+                                           std::is_same_v<Influence, normal_distribution_2d<T>> ||
+                                           std::is_same_v<Influence, function_t>;
+
+    variant_t _influence;
+
+    template<class Influence>
+    static variant_t make_variant(Influence&& influence) {
+        if constexpr (is_alternative<std::remove_cvref_t<Influence>>)
+            return variant_t{std::forward<Influence>(influence)};
+        else
+            return variant_t{function_t{std::forward<Influence>(influence)}};
+    }
+
+public:
+    influence_2d()
+        : _influence{function_t{[](const std::array<T, 2>&, const std::array<T, 2>&) constexpr noexcept { return T{0}; }}} {}
+    template<class Influence>
+    requires (!std::is_same_v<std::remove_cvref_t<Influence>, influence_2d>)
+    influence_2d(Influence&& influence)
+        : _influence{make_variant(std::forward<Influence>(influence))} {}
+
+    // Similarly to std::function::target returns nullptr if the stored function has another type
+    template<class Influence>
+    const Influence* target() const noexcept {
+        if constexpr (is_alternative<Influence>)
+            return std::get_if<Influence>(&_influence);
+        else {
+            const function_t* const function = std::get_if<function_t>(&_influence);
+            return function ? function->template target<Influence>() : nullptr;
+        }
+    }
+
+    template<class Visitor>
+    decltype(auto) visit(Visitor&& visitor) const {
+        return std::visit(std::forward<Visitor>(visitor), _influence);
+    }
+
+    T operator()(const std::array<T, 2>& x, const std::array<T, 2>& y) const {
+        return visit([&x, &y](const auto& influence) { return influence(x, y); });
+    }
+
+    void operator()(const std::array<T, 2>& x, const std::span<const std::array<T, 2>> ys, const std::span<T> values) const {
+        visit([&x, ys, values](const auto& influence) { evaluate(influence, x, ys, values); });
     }
 };
 
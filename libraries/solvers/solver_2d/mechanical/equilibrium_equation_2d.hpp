@@ -10,7 +10,9 @@
 #include "mechanical_solution_2d.hpp"
 #include "temperature_condition_2d.hpp"
 
+#include "block_sparse_matrix.hpp"
 #include "conjugate_gradient.hpp"
+#include "mapped_sparse_matrix.hpp"
 
 #include <chrono>
 
@@ -20,7 +22,10 @@ template<class Matrix_Index, class T, class I, class Right_Part>
 mechanical::mechanical_solution_2d<T, I> equilibrium_equation(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh,
                                                               const mechanical_parameters_2d<T>& parameters,
                                                               const mechanical_boundaries_conditions_2d<T>& boundaries_conditions,
-                                                              const Right_Part& right_part) {
+                                                              const Right_Part& right_part,
+                                                              const bool block_sparse = false,
+                                                              const slae::conjugate_gradient_parameters<T>& slae_parameters = {},
+                                                              const std::optional<slae::out_of_core_parameters>& out_of_core = std::nullopt) {
     auto start_time = std::chrono::high_resolution_clock::now();
     stiffness_matrix<T, I, Matrix_Index> stiffness{mesh};
     stiffness.compute(parameters.materials, parameters.plane, utils::inner_nodes(mesh->container(), boundaries_conditions));
@@ -33,11 +38,36 @@ mechanical::mechanical_solution_2d<T, I> equilibrium_equation(const std::shared_
     temperature_condition(f, *mesh, parameters);
 
     start_time = std::chrono::high_resolution_clock::now();
-    const slae::conjugate_gradient<T, Matrix_Index> solver{stiffness.matrix_inner()};
-    const auto displacement = solver.solve(f);
+    Eigen::Matrix<T, Eigen::Dynamic, 1> displacement;
+    uintmax_t iterations = 0;
+    if (out_of_core) {
+        stiffness.write_inner(*out_of_core);
+        const slae::mapped_sparse_matrix<T, Matrix_Index> matrix{*out_of_core};
+        std::cout << "Out-of-core matrix blocks: " << matrix.blocks_count() << std::endl;
+        const slae::operator_conjugate_gradient<T, slae::mapped_sparse_matrix<T, Matrix_Index>> solver{matrix};
+        displacement = solver.solve(f);
+        iterations = solver.iterations();
+    } else if (block_sparse) {
+        // The scalar inner part is not needed after the conversion, the boundary part stays scalar
+        const slae::block_sparse_matrix<T, Matrix_Index, 2> matrix{stiffness.matrix_inner()};
+        stiffness.matrix_inner().resize(0, 0);
+        stiffness.matrix_inner().data().squeeze();
+        std::cout << "Block sparse matrix blocks: " << matrix.blocks_count() << std::endl;
+        const slae::operator_conjugate_gradient<T, slae::block_sparse_matrix<T, Matrix_Index, 2>> solver{matrix};
+        displacement = solver.solve(f);
+        iterations = solver.iterations();
+    } else {
+        const slae::conjugate_gradient<T, Matrix_Index> solver{stiffness.matrix_inner(), slae_parameters};
+        if (solver.sliced_ellpack())
+            std::cout << "Sliced ELLPACK padding: " << solver.sliced_ellpack()->padding() << std::endl;
+        if (solver.compressed_indices())
+            std::cout << "Compressed indices bytes: " << solver.compressed_indices()->bytes() << std::endl;
+        displacement = solver.solve(f);
+        iterations = solver.iterations();
+    }
     elapsed_seconds = std::chrono::high_resolution_clock::now() - start_time;
     std::cout << "SLAE solution time: " << elapsed_seconds.count() << 's' << std::endl;
-    std::cout << "Iterations: " << solver.iterations() << std::endl;
+    std::cout << "Iterations: " << iterations << std::endl;
     return mechanical_solution_2d<T, I>{mesh, parameters, displacement};
 }
 
@@ -24,6 +24,7 @@ class mechanical_solution_2d : public solution_2d<T, I> {
     void substract_temperature_strains(std::array<std::vector<T>, 3>& strain) const;
     template<class Influence>
     std::array<T, 3> calc_nonlocal_strain(const size_t eL, const std::array<std::vector<T>, 3>& strains, const Influence& influence) const;
+    std::array<T, 3> calc_nonlocal_strain(const size_t qshiftL, const std::array<std::vector<T>, 3>& strains) const;
     void add_stress(const hooke_matrix<T>& hooke, const std::array<T, 3>& strain, const size_t qshift);
 
 public:
@@ -175,6 +176,21 @@ std::array<T, 3> mechanical_solution_2d<T, I>::calc_nonlocal_strain(const size_t
     return nonlocal_stress;
 }
 
+template<class T, class I>
+std::array<T, 3> mechanical_solution_2d<T, I>::calc_nonlocal_strain(const size_t qshiftL, const std::array<std::vector<T>, 3>& strains) const {
+    std::array<T, 3> nonlocal_stress = {};
+    _base::mesh().visit_precision([this, &strains, &nonlocal_stress, qshiftL]<class U>(const std::type_identity<U>) {
+        const auto indices = _base::mesh().quadrature_neighbours().indices(qshiftL);
+        const auto values = _base::mesh().quadrature_neighbours().template values<U>(qshiftL);
+        for(const size_t k : std::ranges::iota_view{0u, indices.size()}) {
+            const T influence_weight = values[k] * mesh::jacobian(_base::mesh().jacobi_matrix(indices[k]));
+            for(const size_t i : std::ranges::iota_view{0u, nonlocal_stress.size()})
+                nonlocal_stress[i] += influence_weight * strains[i][indices[k]];
+        }
+    });
+    return nonlocal_stress;
+}
+
 template<class T, class I>
 void mechanical_solution_2d<T, I>::add_stress(const hooke_matrix<T>& hooke, const std::array<T, 3>& strain, const size_t qshift) {
     _stress[_11][qshift] += hooke[_11] * strain[_11] + hooke[_22] * strain[_22];
@@ -199,11 +215,15 @@ void mechanical_solution_2d<T, I>::calc_strain_and_stress() {
 #pragma omp parallel for default(none) shared(strains, model, local_hooke, nonlocal_hooke, elements) schedule(dynamic)
         for(size_t eL = elements.front(); eL < *elements.end(); ++eL)
             for(const size_t qshiftL : std::ranges::iota_view{_base::mesh().quad_shift(eL), _base::mesh().quad_shift(eL + 1)}) {
-                if (theory_type(model.local_weight) == theory_t::NONLOCAL) {
-                    const auto influence = [&influence = model.influence, &qnodeL = _base::mesh().quad_coord(qshiftL)]
-                                           (const std::array<T, 2>& qnodeNL) { return influence(qnodeL, qnodeNL); };
-                    add_stress(nonlocal_hooke, calc_nonlocal_strain(eL, strains, influence), qshiftL);
-                }
+                if (theory_type(model.local_weight) == theory_t::NONLOCAL && _base::mesh().is_single_quadrature() &&
+                    _base::mesh().quadrature_neighbours().contains(qshiftL))
+                    add_stress(nonlocal_hooke, calc_nonlocal_strain(qshiftL, strains), qshiftL);
+                else if (theory_type(model.local_weight) == theory_t::NONLOCAL)
+                    model.influence.visit([this, &strains, &nonlocal_hooke, eL, qshiftL](const auto& function) {
+                        const auto influence = [&function, qnodeL = _base::mesh().quad_coord(qshiftL)]
+                                               (const std::array<T, 2>& qnodeNL) { return function(qnodeL, qnodeNL); };
+                        add_stress(nonlocal_hooke, calc_nonlocal_strain(eL, strains, influence), qshiftL);
+                    });
                 add_stress(local_hooke, {strains[_11][qshiftL], strains[_22][qshiftL], strains[_12][qshiftL]}, qshiftL);
             }
     }
@@ -2,6 +2,7 @@
 #define NONLOCAL_STIFFNESS_MATRIX_2D_HPP
 
 #include "finite_element_matrix_2d.hpp"
+#include "tensor_product_matrices_2d.hpp"
 #include "mechanical_parameters_2d.hpp"
 
 namespace nonlocal::mechanical {
@@ -22,8 +23,16 @@ protected:
     static block_t calc_block(const hooke_matrix<T>& hooke, const block_t& integral) noexcept;
     static void add_to_integral(block_t& integral, const std::array<T, 2>& wdN, const std::array<T, 2>& dN) noexcept;
     block_t integrate_loc(const hooke_matrix<T>& hooke, const size_t e, const size_t i, const size_t j) const;
-    block_t integrate_nonloc(const hooke_parameter& parameter, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) const;
+    // The integrals of the gradients products for all pairs of nodes of the tensor product element
+    // by the sum factorized kernels, see tensor_product_2d::stiffness. The blocks are passed to calc_block
+    void integrate_loc(const size_t e, const metamath::finite_element::tensor_product_2d<T>& tensor_product,
+                       const std::span<block_t> integrals) const;
+    template<class Influence>
+    void integrate_nonloc_pair(const hooke_matrix<T>& hooke, const Influence& influence,
+                               const size_t eL, const size_t eNL, std::vector<block_t>& blocks) const;
 
+    // The Neumann problem entries are preset in the outer indices
+    void resize_matrix(const bool is_neumann);
     void create_matrix_portrait(const std::unordered_map<std::string, theory_t> theories,
                                 const std::vector<bool>& is_inner, const bool is_neumann);
 
@@ -35,6 +44,11 @@ public:
     ~stiffness_matrix() noexcept override = default;
 
     void compute(const parameters_2d<T>& parameters, const plane_t plane, const std::vector<bool>& is_inner);
+
+    // Dry run of the assembly, only the non-zero elements of the rows are counted
+    assembly_plan_2d plan(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner);
+    // The non-zero elements count of the matrix, the matrix is left empty
+    size_t nonzeros_count(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner);
 };
 
 template<class T, class I, class J>
@@ -80,37 +94,77 @@ template<class T, class I, class J>
 stiffness_matrix<T, I, J>::block_t stiffness_matrix<T, I, J>::integrate_loc(
     const hooke_matrix<T>& hooke, const size_t e, const size_t i, const size_t j) const {
     block_t integral = {};
-    const auto& el = _base::mesh().container().element_2d(e);
-    for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()}) {
+    const auto& mesh = _base::mesh();
+    const auto& el = mesh.container().element_2d(e);
+    if (mesh.is_affine(e)) {
+        using namespace metamath::functions;
+        const T factor = std::reduce(el.qnodes().begin(), el.qnodes().end(), T{0},
+                                     [&mesh, e](const T sum, const size_t q) { return sum + mesh.weighted_jacobian(e, q); });
+        add_to_integral(integral, factor * mesh.gradient(e, i, 0), mesh.gradient(e, j, 0));
+        return calc_block(hooke, integral);
+    }
+    if (mesh.has_physical_gradients()) {
+        mesh.visit_precision([&mesh, &el, &integral, e, i, j]<class U>(const std::type_identity<U>) {
+            const std::span<const U> weighted_jacobians = mesh.template weighted_jacobians<U>(e);
+            const std::span<const U> dNix = mesh.template gradients<U>(e, i, X), dNiy = mesh.template gradients<U>(e, i, Y);
+            const std::span<const U> dNjx = mesh.template gradients<U>(e, j, X), dNjy = mesh.template gradients<U>(e, j, Y);
+            for(const size_t q : el.qnodes()) {
+                const T weight = weighted_jacobians[q];
+                add_to_integral(integral, {weight * dNix[q], weight * dNiy[q]}, {dNjx[q], dNjy[q]});
+            }
+        });
+        return calc_block(hooke, integral);
+    }
+    for(const size_t q : el.qnodes()) {
         using namespace metamath::functions;
-        const T weight = el.weight(q) / mesh::jacobian(_base::mesh().jacobi_matrix(e, q));
-        add_to_integral(integral, weight * _base::mesh().derivatives(e, i, q), _base::mesh().derivatives(e, j, q));
+        const T weight = el.weight(q) / mesh::jacobian(mesh.jacobi_matrix(e, q));
+        add_to_integral(integral, weight * mesh.derivatives(e, i, q), mesh.derivatives(e, j, q));
     }
     return calc_block(hooke, integral);
 }
 
 template<class T, class I, class J>
-stiffness_matrix<T, I, J>::block_t stiffness_matrix<T, I, J>::integrate_nonloc(
-    const hooke_parameter& parameter, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) const {
-    block_t integral = {};
-    const auto& elL  = _base::mesh().container().element_2d(eL );
-    const auto& elNL = _base::mesh().container().element_2d(eNL);
-    for(const size_t qL : elL.qnodes()) {
+void stiffness_matrix<T, I, J>::integrate_loc(const size_t e, const metamath::finite_element::tensor_product_2d<T>& tensor_product,
+                                              const std::span<block_t> integrals) const {
+    const auto& mesh = _base::mesh();
+    const auto& el = mesh.container().element_2d(e);
+    thread_local std::vector<T> component;
+    component.resize(integrals.size());
+    for(const size_t row : std::ranges::iota_view{0u, 2u})
+        for(const size_t col : std::ranges::iota_view{0u, 2u}) {
+            tensor_product.stiffness([&mesh, &el, e, row, col](const size_t q) {
+                // The derivatives are B * (dN/dxi, dN/deta), see mesh::utils::derivatives_in_quad
+                const metamath::types::square_matrix<T, 2> jacobi = mesh.jacobi_matrix(e, q);
+                const metamath::types::square_matrix<T, 2> B = {std::array{jacobi[Y][Y], -jacobi[Y][X]}, std::array{-jacobi[X][Y], jacobi[X][X]}};
+                const T factor = el.weight(q) / mesh::jacobian(jacobi);
+                metamath::types::square_matrix<T, 2> coefficients = {};
+                for(const size_t k : std::ranges::iota_view{0u, 2u})
+                    for(const size_t l : std::ranges::iota_view{0u, 2u})
+                        coefficients[k][l] = factor * B[row][k] * B[col][l];
+                return coefficients;
+            }, component);
+            for(const size_t ij : std::ranges::iota_view{0u, integrals.size()})
+                integrals[ij][row][col] = component[ij];
+        }
+}
+
+template<class T, class I, class J>
+template<class Influence>
+void stiffness_matrix<T, I, J>::integrate_nonloc_pair(const hooke_matrix<T>& hooke, const Influence& influence,
+                                                      const size_t eL, const size_t eNL, std::vector<block_t>& blocks) const {
+    thread_local std::vector<block_t> integrals;
+    integrals.assign(blocks.size(), {});
+    _base::integrate_nonloc_pair(influence, eL, eNL,
+    [](const size_t ij, const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
         using namespace metamath::functions;
-        std::array<T, 2> inner_integral = {};
-        const auto influence = [&model = parameter.model, &qnodeL = _base::mesh().quad_coord(eL,  qL )](const std::array<T, 2>& qnodeNL) {
-            return model.influence(qnodeL, qnodeNL);
-        };
-        for(const size_t qNL : elNL.qnodes())
-            inner_integral += elNL.weight(qNL) * influence(_base::mesh().quad_coord(eNL, qNL)) * _base::mesh().derivatives(eNL, jNL, qNL);
-        add_to_integral(integral, elL.weight(qL) * _base::mesh().derivatives(eL, iL, qL), inner_integral);
-    }
-    return calc_block(parameter.physical, integral);
+        add_to_integral(integrals[ij], weightL * dNi, inner_integral);
+    });
+    for(const size_t ij : std::ranges::iota_view{0u, blocks.size()})
+        blocks[ij] = calc_block(hooke, integrals[ij]);
 }
 
 template<class T, class I, class J>
-void stiffness_matrix<T, I, J>::create_matrix_portrait(const std::unordered_map<std::string, theory_t> theories,
-                                                       const std::vector<bool>& is_inner, const bool is_neumann) {
+void stiffness_matrix<T, I, J>::resize_matrix(const bool is_neumann) {
     const size_t rows = 2 * _base::mesh().process_nodes().size() + (is_neumann && parallel_utils::is_last_process());
     const size_t cols = 2 * _base::mesh().container().nodes_count() + is_neumann;
     _base::matrix_inner().resize(rows, cols);
@@ -118,14 +172,34 @@ void stiffness_matrix<T, I, J>::create_matrix_portrait(const std::unordered_map<
     if (is_neumann)
         for(const size_t row : std::views::iota(0u, _base::mesh().container().nodes_count()))
             _base::matrix_inner().outerIndexPtr()[2 * row + 1] = 1;
-    _base::init_shifts(theories, is_inner, SYMMETRIC);
-    static constexpr bool SORT_INDICES = false;
-    _base::init_indices(theories, is_inner, SYMMETRIC, SORT_INDICES);
+}
+
+template<class T, class I, class J>
+void stiffness_matrix<T, I, J>::create_matrix_portrait(const std::unordered_map<std::string, theory_t> theories,
+                                                       const std::vector<bool>& is_inner, const bool is_neumann) {
+    resize_matrix(is_neumann);
+    _base::init_portrait(theories, is_inner, SYMMETRIC);
     if (is_neumann)
         for(const size_t row : std::ranges::iota_view{0u, _base::mesh().container().nodes_count()})
             _base::matrix_inner().innerIndexPtr()[_base::matrix_inner().outerIndexPtr()[2 * row + 1] - 1] = 2 * _base::mesh().container().nodes_count();
-    utils::sort_indices(_base::matrix_inner());
-    utils::sort_indices(_base::matrix_bound());
+}
+
+template<class T, class I, class J>
+assembly_plan_2d stiffness_matrix<T, I, J>::plan(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner) {
+    const std::unordered_map<std::string, theory_t> theories = theories_types(parameters);
+    static constexpr bool NEUMANN = false;
+    resize_matrix(NEUMANN);
+    _base::init_shifts(theories, is_inner, SYMMETRIC);
+    return _base::plan(theories);
+}
+
+template<class T, class I, class J>
+size_t stiffness_matrix<T, I, J>::nonzeros_count(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner) {
+    static constexpr bool NEUMANN = false;
+    resize_matrix(NEUMANN);
+    const size_t nonzeros = _base::count_nonzeros(theories_types(parameters), is_inner, SYMMETRIC);
+    _base::clear();
+    return nonzeros;
 }
 
 template<class T, class I, class J>
@@ -133,7 +207,7 @@ T stiffness_matrix<T, I, J>::integrate_basic(const size_t e, const size_t i) con
     T integral = 0;
     const auto& el = _base::mesh().container().element_2d(e);
     for(const size_t q : el.qnodes())
-        integral += el.weight(q) * el.qN(i, q) * mesh::jacobian(_base::mesh().jacobi_matrix(e, q));
+        integral += _base::mesh().weighted_jacobian(e, q) * el.qN(i, q);
     return integral;
 }
 
@@ -153,14 +227,38 @@ void stiffness_matrix<T, I, J>::compute(const parameters_2d<T>& parameters, cons
     const std::unordered_map<std::string, theory_t> theories = theories_types(parameters);
     static constexpr bool NEUMANN = false;
     create_matrix_portrait(theories, is_inner, NEUMANN);
-    _base::calc_coeffs(theories, is_inner, SYMMETRIC,
-        [this, hooke = to_hooke<theory_t::LOCAL>(parameters, plane)]
+    _base::compute_nonlocal_rules(theories, parameters);
+    // The stiffness matrix is always symmetric, so the nonlocal part is assembled by pairs of elements
+    std::unordered_set<std::string> pair_groups;
+    std::unordered_map<std::string, theory_t> coeffs_theories = theories;
+    for(auto& [group, theory] : coeffs_theories)
+        if (theory == theory_t::NONLOCAL) {
+            pair_groups.insert(group);
+            theory = theory_t::LOCAL; // local part is assembled as usual
+        }
+    const auto groups = std::views::keys(coeffs_theories);
+    tensor_product_matrices_2d<T, block_t> local_integrals;
+    local_integrals.compute(_base::mesh(), {groups.begin(), groups.end()},
+        [this](const std::string&, const size_t e, const auto& tensor_product, const std::span<block_t> integrals) {
+            integrate_loc(e, tensor_product, integrals);
+        });
+    _base::calc_coeffs(coeffs_theories, is_inner, SYMMETRIC,
+        [this, &local_integrals, hooke = to_hooke<theory_t::LOCAL>(parameters, plane)]
         (const std::string& group, const size_t e, const size_t i, const size_t j) {
-            return integrate_loc(hooke.at(group).physical, e, i, j);
+            const hooke_matrix<T>& parameter = hooke.at(group).physical;
+            return local_integrals.contains(e) ? calc_block(parameter, local_integrals(e, i, j)) : integrate_loc(parameter, e, i, j);
         },
+        [](const std::string&, const size_t, const size_t, const size_t, const size_t) -> block_t {
+            throw std::logic_error{"Nonlocal part of the stiffness matrix is assembled by pairs of elements."};
+        }
+    );
+    _base::calc_nonlocal_pairs(pair_groups, is_inner,
         [this, hooke = to_hooke<theory_t::NONLOCAL>(parameters, plane)]
-        (const std::string& group, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) {
-            return integrate_nonloc(hooke.at(group), eL, eNL, iL, jNL);
+        (const std::string& group, const size_t eL, const size_t eNL, std::vector<block_t>& blocks) {
+            const hooke_parameter& parameter = hooke.at(group);
+            parameter.model.influence.visit([&](const auto& influence) {
+                integrate_nonloc_pair(parameter.physical, influence, eL, eNL, blocks);
+            });
         }
     );
     if (NEUMANN)
@@ -41,8 +41,8 @@ class _temperature_condition final {
         return integral;
     }
 
-    std::array<T, 2> operator()(const size_t eL, const size_t eNL, const size_t iL,
-                                const std::function<T(const std::array<T, 2>&, const std::array<T, 2>&)>& influence) const {
+    template<class Influence>
+    std::array<T, 2> operator()(const size_t eL, const size_t eNL, const size_t iL, const Influence& influence) const {
         using namespace metamath::functions;
         std::array<T, 2> integral = {};
         const auto& elL = _mesh.container().element_2d(eL);
@@ -86,8 +86,10 @@ void temperature_condition(Eigen::Matrix<T, Eigen::Dynamic, 1>& f,
             const auto& parameter = parameters.materials.at(mesh.container().group(eL));
             if (theory_type(parameter.model.local_weight) == theory_t::NONLOCAL) {
                 const T nonlocal_weight = nonlocal::nonlocal_weight(parameter.model.local_weight);
-                for(const I eNL : mesh.neighbours(eL))
-                    integral += nonlocal_weight * integrator(eL, eNL, iL, parameter.model.influence);
+                parameter.model.influence.visit([&integral, &integrator, &mesh, nonlocal_weight, eL, iL](const auto& influence) {
+                    for(const I eNL : mesh.neighbours(eL))
+                        integral += nonlocal_weight * integrator(eL, eNL, iL, influence);
+                });
             }
             integral += parameter.model.local_weight * integrator(eL, iL);
         }
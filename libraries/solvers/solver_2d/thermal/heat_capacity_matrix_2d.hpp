@@ -2,6 +2,7 @@
 #define NONLOCAL_HEAT_CAPACITY_MATRIX_2D_HPP
 
 #include "finite_element_matrix_2d.hpp"
+#include "tensor_product_matrices_2d.hpp"
 
 namespace nonlocal::thermal {
 
@@ -14,14 +15,22 @@ class heat_capacity_matrix_2d : public finite_element_matrix_2d<1, T, I, Matrix_
 protected:
     T integrate_basic_pair(const size_t e, const size_t i, const size_t j) const;
 
+    static std::unordered_map<std::string, theory_t> local_theories(const mesh::mesh_container_2d<T, I>& mesh);
+
     void create_matrix_portrait(const std::unordered_map<std::string, theory_t>& theories,
                                 const std::vector<bool>& is_inner);
+    void calc_coeffs(const parameters_2d<T>& parameters, const std::unordered_map<std::string, theory_t>& theories,
+                     const std::vector<bool>& is_inner);
 
 public:
     explicit heat_capacity_matrix_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh);
     ~heat_capacity_matrix_2d() noexcept override = default;
 
     void calc_matrix(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner);
+    // The matrix is assembled into the portrait of the symmetric matrix with the same inner nodes,
+    // for example of the thermal conductivity, which contains all local entries.
+    void calc_matrix(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                     const finite_element_matrix_2d<1, T, I, Matrix_Index>& portrait);
 };
 
 template<class T, class I, class Matrix_Index>
@@ -30,13 +39,23 @@ heat_capacity_matrix_2d<T, I, Matrix_Index>::heat_capacity_matrix_2d(const std::
 
 template<class T, class I, class Matrix_Index>
 T heat_capacity_matrix_2d<T, I, Matrix_Index>::integrate_basic_pair(const size_t e, const size_t i, const size_t j) const {
+    // The exact mass matrix of the linear triangle, the Jacobian of the affine element is constant
+    if (_base::mesh().is_affine(e))
+        return mesh::jacobian(_base::mesh().jacobi_matrix(e, 0)) * (i == j ? T{2} : T{1}) / T{24};
     T integral = 0;
     const auto& el = _base::mesh().container().element_2d(e);
     for(const size_t q : std::ranges::iota_view{0u, el.qnodes_count()})
-        integral += el.weight(q) * el.qN(i, q) * el.qN(j, q) * mesh::jacobian(_base::mesh().jacobi_matrix(e, q));
+        integral += _base::mesh().weighted_jacobian(e, q) * el.qN(i, q) * el.qN(j, q);
     return integral;
 }
 
+template<class T, class I, class Matrix_Index>
+std::unordered_map<std::string, theory_t> heat_capacity_matrix_2d<T, I, Matrix_Index>::local_theories(const mesh::mesh_container_2d<T, I>& mesh) {
+    const auto theroires_setter = std::views::all(mesh.groups_2d()) |
+                                  std::views::transform([](const std::string& group) { return std::pair{group, theory_t::LOCAL}; });
+    return {theroires_setter.begin(), theroires_setter.end()};
+}
+
 template<class T, class I, class Matrix_Index>
 void heat_capacity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(const std::unordered_map<std::string, theory_t>& theories,
                                                                          const std::vector<bool>& is_inner) {
@@ -44,25 +63,42 @@ void heat_capacity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(const s
     const size_t cols = _base::mesh().container().nodes_count();
     _base::matrix_inner().resize(rows, cols);
     _base::matrix_bound().resize(rows, cols);
-    _base::init_shifts(theories, is_inner, SYMMETRIC);
-    _base::init_indices(theories, is_inner, SYMMETRIC);
+    _base::init_portrait(theories, is_inner, SYMMETRIC);
 }
 
 template<class T, class I, class Matrix_Index>
-void heat_capacity_matrix_2d<T, I, Matrix_Index>::calc_matrix(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner) {
-    const auto theroires_setter = std::views::all(_base::mesh().container().groups_2d()) |
-                                  std::views::transform([](const std::string& group) { return std::pair{group, theory_t::LOCAL}; });
-    const std::unordered_map<std::string, theory_t> theories(theroires_setter.begin(), theroires_setter.end());
-    create_matrix_portrait(theories, is_inner);
+void heat_capacity_matrix_2d<T, I, Matrix_Index>::calc_coeffs(const parameters_2d<T>& parameters,
+                                                              const std::unordered_map<std::string, theory_t>& theories,
+                                                              const std::vector<bool>& is_inner) {
+    const auto groups = std::views::keys(theories);
+    tensor_product_matrices_2d<T> local_matrices;
+    local_matrices.compute(_base::mesh(), {groups.begin(), groups.end()},
+        [this](const std::string&, const size_t e, const auto& tensor_product, const std::span<T> matrix) {
+            tensor_product.mass([this, e](const size_t q) { return _base::mesh().weighted_jacobian(e, q); }, matrix);
+        });
     _base::calc_coeffs(theories, is_inner, SYMMETRIC,
-        [this, &parameters](const std::string& group, const size_t e, const size_t i, const size_t j) {
+        [this, &parameters, &local_matrices](const std::string& group, const size_t e, const size_t i, const size_t j) {
             const auto& parameter = parameters.at(group).physical;
-            return parameter->density * parameter->capacity * integrate_basic_pair(e, i, j); 
+            return parameter->density * parameter->capacity * (local_matrices.contains(e) ? local_matrices(e, i, j) : integrate_basic_pair(e, i, j));
         },
         [](const std::string&, const size_t, const size_t, const size_t, const size_t) constexpr noexcept { return T{0}; }
     );
 }
 
+template<class T, class I, class Matrix_Index>
+void heat_capacity_matrix_2d<T, I, Matrix_Index>::calc_matrix(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner) {
+    const std::unordered_map<std::string, theory_t> theories = local_theories(_base::mesh().container());
+    create_matrix_portrait(theories, is_inner);
+    calc_coeffs(parameters, theories, is_inner);
+}
+
+template<class T, class I, class Matrix_Index>
+void heat_capacity_matrix_2d<T, I, Matrix_Index>::calc_matrix(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                                                              const finite_element_matrix_2d<1, T, I, Matrix_Index>& portrait) {
+    _base::share_portrait(portrait);
+    calc_coeffs(parameters, local_theories(_base::mesh().container()), is_inner);
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -161,28 +161,41 @@ const std::array<std::vector<T>, 2>& heat_equation_solution_2d<T, I>::calc_flux(
         if (const model_parameters<2, T>& model = _base::model(group); theory_type(model.local_weight) == theory_t::NONLOCAL) {
             const T nonlocal_weight = nonlocal::nonlocal_weight(model.local_weight);
             const auto elements = _base::mesh().container().elements(group);
-            for(size_t eL = elements.front(); eL < *elements.end(); ++eL)
-                for(const size_t qshiftL : std::ranges::iota_view{_base::mesh().quad_shift(eL), _base::mesh().quad_shift(eL + 1)}) {
-                    std::array<T, 2> nonlocal_gradient = {};
-                    const auto& qcoordL = _base::mesh().quad_coord(qshiftL);
-                    for(const size_t eNL : _base::mesh().neighbours(eL)) {
-                        size_t qshiftNL = _base::mesh().quad_shift(eNL);
-                        const auto& elNL = _base::mesh().container().element_2d(eNL);
-                        for(const size_t qNL : elNL.qnodes()) {
-                            const T influence_weight = elNL.weight(qNL) * mesh::jacobian(_base::mesh().jacobi_matrix(qshiftNL)) *
-                                                       model.influence(qcoordL, _base::mesh().quad_coord(qshiftNL));
-                            nonlocal_gradient[X] += influence_weight * _flux[X][qshiftNL];
-                            nonlocal_gradient[Y] += influence_weight * _flux[Y][qshiftNL];
-                            ++qshiftNL;
-                        }
+            model.influence.visit([&](const auto& influence) {
+                for(size_t eL = elements.front(); eL < *elements.end(); ++eL)
+                    for(const size_t qshiftL : std::ranges::iota_view{_base::mesh().quad_shift(eL), _base::mesh().quad_shift(eL + 1)}) {
+                        std::array<T, 2> nonlocal_gradient = {};
+                        const auto& qcoordL = _base::mesh().quad_coord(qshiftL);
+                        if (const auto& neighbours = _base::mesh().quadrature_neighbours(); _base::mesh().is_single_quadrature() && neighbours.contains(qshiftL)) {
+                            _base::mesh().visit_precision([&]<class U>(const std::type_identity<U>) {
+                                const auto indices = neighbours.indices(qshiftL);
+                                const auto values = neighbours.template values<U>(qshiftL);
+                                for(const size_t k : std::ranges::iota_view{0u, indices.size()}) {
+                                    const T influence_weight = values[k] * mesh::jacobian(_base::mesh().jacobi_matrix(indices[k]));
+                                    nonlocal_gradient[X] += influence_weight * _flux[X][indices[k]];
+                                    nonlocal_gradient[Y] += influence_weight * _flux[Y][indices[k]];
+                                }
+                            });
+                        } else
+                            for(const size_t eNL : _base::mesh().neighbours(eL)) {
+                                size_t qshiftNL = _base::mesh().quad_shift(eNL);
+                                const auto& elNL = _base::mesh().container().element_2d(eNL);
+                                for(const size_t qNL : elNL.qnodes()) {
+                                    const T influence_weight = elNL.weight(qNL) * mesh::jacobian(_base::mesh().jacobi_matrix(qshiftNL)) *
+                                                               influence(qcoordL, _base::mesh().quad_coord(qshiftNL));
+                                    nonlocal_gradient[X] += influence_weight * _flux[X][qshiftNL];
+                                    nonlocal_gradient[Y] += influence_weight * _flux[Y][qshiftNL];
+                                    ++qshiftNL;
+                                }
+                            }
+                        using namespace metamath::functions;
+                        nonlocal_gradient *= nonlocal_weight;
+                        _flux[X][qshiftL] *= model.local_weight;
+                        _flux[Y][qshiftL] *= model.local_weight;
+                        _flux[X][qshiftL] += nonlocal_gradient[X];
+                        _flux[Y][qshiftL] += nonlocal_gradient[Y];
                     }
-                    using namespace metamath::functions;
-                    nonlocal_gradient *= nonlocal_weight;
-                    _flux[X][qshiftL] *= model.local_weight;
-                    _flux[Y][qshiftL] *= model.local_weight;
-                    _flux[X][qshiftL] += nonlocal_gradient[X];
-                    _flux[Y][qshiftL] += nonlocal_gradient[Y];
-                }
+            });
         }
 
     _flux[X] = mesh::utils::qnodes_to_nodes(_base::mesh(), _flux[X]);
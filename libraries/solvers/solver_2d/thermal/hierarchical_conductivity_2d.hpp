@@ -0,0 +1,202 @@
+#ifndef NONLOCAL_HIERARCHICAL_CONDUCTIVITY_2D_HPP
+#define NONLOCAL_HIERARCHICAL_CONDUCTIVITY_2D_HPP
+
+#include "thermal_conductivity_matrix_2d.hpp"
+#include "hierarchical_influence_matrix_2d.hpp"
+#include "../influence_functions_2d.hpp"
+
+namespace nonlocal::thermal {
+
+// Conductivity operator, which stores only the local part as a sparse matrix.
+// The nonlocal part of each group is applied in the factorized form G^T Λ Φ G,
+// where G maps nodal values to weighted gradients in quadrature nodes
+// and Φ is the hierarchical matrix of influence function values.
+// Neither the elements neighbours nor the nonlocal matrix portrait are required.
+template<class T, class I, class Matrix_Index>
+class hierarchical_conductivity_2d final : public thermal_conductivity_matrix_2d<T, I, Matrix_Index> {
+    using _base = thermal_conductivity_matrix_2d<T, I, Matrix_Index>;
+    using vector_t = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+    struct nonlocal_group final {
+        std::ranges::iota_view<size_t, size_t> elements;
+        metamath::types::square_matrix<T, 2> conductivity; // multiplied by the nonlocal weight
+        hierarchical_influence_matrix_2d<T, I> influence;
+    };
+
+    std::vector<nonlocal_group> _groups;
+    std::vector<bool> _is_inner;
+
+    static std::optional<mesh::support_2d<T>> support(const influence::influence_2d<T>& influence);
+    static metamath::types::square_matrix<T, 2> conductivity_tensor(const parameter_2d<T, coefficients_t::CONSTANTS>& parameter);
+
+    // z += K_nonloc * x, where only inner rows are calculated and
+    // only inner (is_inner_cols == true) or boundary (is_inner_cols == false) columns are used
+    void nonlocal_product(vector_t& z, const vector_t& x, const bool is_inner_cols) const;
+
+public:
+    explicit hierarchical_conductivity_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh);
+    ~hierarchical_conductivity_2d() noexcept override = default;
+
+    void compute(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner, const hierarchical_parameters<T>& hierarchical);
+
+    size_t rows() const noexcept;
+    size_t memory() const noexcept;
+    void print_statistics(std::ostream& out) const;
+
+    // z = K_inner * x
+    void product(vector_t& z, const vector_t& x) const;
+
+    // Subtracts the nonlocal part of K_bound * x from the right part.
+    // Values of the first kind boundary conditions are taken from f,
+    // so it must be called after boundary_condition_first_kind_2d.
+    void boundary_condition_first_kind(vector_t& f) const;
+};
+
+template<class T, class I, class Matrix_Index>
+hierarchical_conductivity_2d<T, I, Matrix_Index>::hierarchical_conductivity_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh)
+    : _base{mesh} {}
+
+template<class T, class I, class Matrix_Index>
+std::optional<mesh::support_2d<T>> hierarchical_conductivity_2d<T, I, Matrix_Index>::support(const influence::influence_2d<T>& influence) {
+    if (const auto* const function = influence.template target<influence::constant_2d<T, 2>>())
+        return mesh::support_2d<T>{.radius = function->radius()};
+    if (const auto* const function = influence.template target<influence::polynomial_2d<T, 2, 1>>())
+        return mesh::support_2d<T>{.radius = function->radius()};
+    if (const auto* const function = influence.template target<influence::normal_distribution_2d<T>>(); function && function->is_truncated())
+        return mesh::support_2d<T>{.radius = function->truncation_radius()};
+    return std::nullopt;
+}
+
+template<class T, class I, class Matrix_Index>
+metamath::types::square_matrix<T, 2> hierarchical_conductivity_2d<T, I, Matrix_Index>::conductivity_tensor(
+    const parameter_2d<T, coefficients_t::CONSTANTS>& parameter) {
+    const auto& conductivity = parameter.conductivity;
+    switch (parameter.material) {
+    case material_t::ISOTROPIC:
+        return {conductivity[X][X], T{0}, T{0}, conductivity[X][X]};
+    case material_t::ORTHOTROPIC:
+        return {conductivity[X][X], T{0}, T{0}, conductivity[Y][Y]};
+    case material_t::ANISOTROPIC:
+        return conductivity;
+    }
+    throw std::domain_error{"Unknown material type: " + std::to_string(std::underlying_type_t<material_t>(parameter.material))};
+}
+
+template<class T, class I, class Matrix_Index>
+void hierarchical_conductivity_2d<T, I, Matrix_Index>::compute(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                                                              const hierarchical_parameters<T>& hierarchical) {
+    _is_inner = is_inner;
+    _groups.clear();
+    std::unordered_map<std::string, theory_t> theories = theories_types(parameters);
+    for(auto& [group, theory] : theories)
+        if (theory == theory_t::NONLOCAL) {
+            const auto& [model, physic] = parameters.at(group);
+            const auto* const parameter = parameter_cast<coefficients_t::CONSTANTS>(physic.get());
+            if (!parameter)
+                throw std::domain_error{"Hierarchical nonlocal operator supports only constant coefficients."};
+            using namespace metamath::functions;
+            _groups.push_back({
+                .elements = _base::mesh().container().elements(group),
+                .conductivity = nonlocal_weight(model.local_weight) * conductivity_tensor(*parameter),
+                .influence = model.influence.visit([this, &group, &model, &hierarchical](const auto& influence) {
+                    return hierarchical_influence_matrix_2d<T, I>{_base::mesh(), group, influence, hierarchical, support(model.influence)};
+                })
+            });
+            theory = theory_t::LOCAL; // local part of nonlocal groups is assembled as usual
+        }
+    static constexpr bool IS_SYMMETRIC = true;
+    static constexpr bool IS_NEUMANN = false;
+    _base::compute(parameters, theories, is_inner, IS_SYMMETRIC, IS_NEUMANN, std::nullopt);
+}
+
+template<class T, class I, class Matrix_Index>
+size_t hierarchical_conductivity_2d<T, I, Matrix_Index>::rows() const noexcept {
+    return _base::matrix_inner().rows();
+}
+
+template<class T, class I, class Matrix_Index>
+size_t hierarchical_conductivity_2d<T, I, Matrix_Index>::memory() const noexcept {
+    size_t memory = _base::matrix_inner().nonZeros() * (sizeof(T) + sizeof(Matrix_Index)) +
+                    _base::matrix_bound().nonZeros() * (sizeof(T) + sizeof(Matrix_Index));
+    for(const nonlocal_group& group : _groups)
+        memory += group.influence.memory();
+    return memory;
+}
+
+template<class T, class I, class Matrix_Index>
+void hierarchical_conductivity_2d<T, I, Matrix_Index>::print_statistics(std::ostream& out) const {
+    static constexpr T MiB = T{1024 * 1024};
+    for(const nonlocal_group& group : _groups) {
+        out << "Hierarchical influence matrix of size " << group.influence.size() << ":\n";
+        for(const size_t level : std::ranges::iota_view{0u, group.influence.statistics().size()}) {
+            const auto& statistics = group.influence.statistics()[level];
+            if (statistics.low_rank_blocks || statistics.near_blocks)
+                out << "  level " << level << ": low-rank blocks = " << statistics.low_rank_blocks
+                    << " (max rank " << statistics.max_rank << ", " << statistics.low_rank_memory / MiB << " MiB)"
+                    << ", near blocks = " << statistics.near_blocks << " (" << statistics.near_memory / MiB << " MiB)\n";
+        }
+    }
+    out << "Total operator memory: " << memory() / MiB << " MiB" << std::endl;
+}
+
+template<class T, class I, class Matrix_Index>
+void hierarchical_conductivity_2d<T, I, Matrix_Index>::nonlocal_product(vector_t& z, const vector_t& x, const bool is_inner_cols) const {
+    const auto& mesh = _base::mesh();
+    for(const nonlocal_group& group : _groups) {
+        const size_t shift = mesh.quad_shift(group.elements.front());
+        Eigen::Matrix<T, Eigen::Dynamic, 2> gradients = Eigen::Matrix<T, Eigen::Dynamic, 2>::Zero(group.influence.size(), 2);
+#pragma omp parallel for default(none) shared(mesh, group, gradients, x, is_inner_cols, shift)
+        for(size_t e = group.elements.front(); e < *group.elements.end(); ++e) {
+            const auto& el = mesh.container().element_2d(e);
+            for(const size_t q : el.qnodes()) {
+                const size_t qshift = mesh.quad_shift(e) + q - shift;
+                for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()})
+                    if (const size_t node = mesh.container().node_number(e, i); _is_inner[node] == is_inner_cols) {
+                        const std::array<T, 2>& derivatives = mesh.derivatives(e, i, q);
+                        const T factor = el.weight(q) * x[node];
+                        gradients(qshift, X) += factor * derivatives[X];
+                        gradients(qshift, Y) += factor * derivatives[Y];
+                    }
+            }
+        }
+
+        Eigen::Matrix<T, Eigen::Dynamic, 2> fluxes;
+        group.influence.multiply(fluxes, gradients);
+
+#pragma omp parallel for default(none) shared(mesh, group, fluxes, z, shift)
+        for(size_t e = group.elements.front(); e < *group.elements.end(); ++e) {
+            const auto& el = mesh.container().element_2d(e);
+            for(const size_t q : el.qnodes()) {
+                const size_t qshift = mesh.quad_shift(e) + q - shift;
+                const std::array<T, 2> flux = {
+                    group.conductivity[X][X] * fluxes(qshift, X) + group.conductivity[X][Y] * fluxes(qshift, Y),
+                    group.conductivity[Y][X] * fluxes(qshift, X) + group.conductivity[Y][Y] * fluxes(qshift, Y)
+                };
+                for(const size_t i : std::ranges::iota_view{0u, el.nodes_count()})
+                    if (const size_t node = mesh.container().node_number(e, i); _is_inner[node]) {
+                        const std::array<T, 2>& derivatives = mesh.derivatives(e, i, q);
+                        const T value = el.weight(q) * (derivatives[X] * flux[X] + derivatives[Y] * flux[Y]);
+#pragma omp atomic
+                        z[node] += value;
+                    }
+            }
+        }
+    }
+}
+
+template<class T, class I, class Matrix_Index>
+void hierarchical_conductivity_2d<T, I, Matrix_Index>::product(vector_t& z, const vector_t& x) const {
+    z = _base::matrix_inner().template selfadjointView<Eigen::Upper>() * x;
+    nonlocal_product(z, x, true);
+}
+
+template<class T, class I, class Matrix_Index>
+void hierarchical_conductivity_2d<T, I, Matrix_Index>::boundary_condition_first_kind(vector_t& f) const {
+    vector_t z = vector_t::Zero(f.size());
+    nonlocal_product(z, f, false);
+    f -= z;
+}
+
+}
+
+#endif
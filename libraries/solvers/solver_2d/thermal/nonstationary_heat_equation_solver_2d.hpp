@@ -70,11 +70,14 @@ void nonstationary_heat_equation_solver_2d<T, I, Matrix_Index>::compute(const pa
     const std::vector<bool> is_inner = utils::inner_nodes(_conductivity.mesh().container(), boundaries_conditions);
     _conductivity.compute(parameters, is_inner);
     convection_condition_2d(_conductivity.matrix_inner(), _conductivity.mesh(), boundaries_conditions);
-    _capacity.calc_matrix(parameters, is_inner);
+    _capacity.calc_matrix(parameters, is_inner, _conductivity);
 
     _conductivity.matrix_inner() *= time_step();
     _conductivity.matrix_bound() *= time_step();
-    _conductivity.matrix_inner() += _capacity.matrix_inner();
+    _conductivity.matrix_inner().coeffs() += _capacity.matrix_inner().coeffs();
+    // The right part product needs neither the zeros of the nonlocal portrait nor the bound part
+    _capacity.matrix_inner().prune([](const Eigen::Index, const Eigen::Index, const T value) { return value != T{0}; });
+    _capacity.matrix_bound().resize(0, 0);
     first_kind_filler(_conductivity.mesh().process_nodes(), is_inner, [&matrix = _conductivity.matrix_inner()](const size_t row) {
         matrix.valuePtr()[matrix.outerIndexPtr()[row]] = T{1};
     });
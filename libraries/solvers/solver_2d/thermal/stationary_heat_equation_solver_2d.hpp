@@ -3,6 +3,7 @@
 
 #include "solvers_utils.hpp"
 #include "thermal_conductivity_matrix_2d.hpp"
+#include "hierarchical_conductivity_2d.hpp"
 #include "thermal_boundary_conditions_2d.hpp"
 #include "boundary_condition_first_kind_2d.hpp"
 #include "boundary_condition_second_kind_2d.hpp"
@@ -11,6 +12,7 @@
 #include "heat_equation_solution_2d.hpp"
 
 #include "conjugate_gradient.hpp"
+#include "mapped_sparse_matrix.hpp"
 
 #include <chrono>
 
@@ -30,7 +32,10 @@ heat_equation_solution_2d<T, I> stationary_heat_equation_solver_2d(const std::sh
                                                                    const parameters_2d<T>& parameters,
                                                                    const thermal_boundaries_conditions_2d<T>& boundaries_conditions,
                                                                    const Right_Part& right_part,
-                                                                   const T energy = T{0}) {
+                                                                   const T energy = T{0},
+                                                                   const std::optional<hierarchical_parameters<T>>& hierarchical = std::nullopt,
+                                                                   const slae::conjugate_gradient_parameters<T>& slae_parameters = {},
+                                                                   const std::optional<slae::out_of_core_parameters>& out_of_core = std::nullopt) {
     static constexpr size_t DoF = 1;
     static constexpr auto is_second_kind = [](const auto& condition) {
         return bool(dynamic_cast<const flux_2d<T>*>(condition.get()));
@@ -52,6 +57,27 @@ heat_equation_solution_2d<T, I> stationary_heat_equation_solver_2d(const std::sh
     const bool is_nonlocal = std::any_of(theories.begin(), theories.end(), check_nonlocal);
     const bool is_symmetric = !(is_nonlinear && is_nonlocal);
 
+    if (hierarchical && is_nonlocal && is_symmetric && !is_neumann) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        hierarchical_conductivity_2d<T, I, Matrix_Index> conductivity{mesh};
+        conductivity.compute(parameters, utils::inner_nodes(mesh->container(), boundaries_conditions), *hierarchical);
+        std::chrono::duration<double> elapsed_seconds = std::chrono::high_resolution_clock::now() - start_time;
+        std::cout << "Hierarchical conductivity operator calculated time: " << elapsed_seconds.count() << 's' << std::endl;
+        conductivity.print_statistics(std::cout);
+        convection_condition_2d(conductivity.matrix_inner(), *mesh, boundaries_conditions);
+        integrate_right_part<DoF>(f, *mesh, right_part);
+        boundary_condition_first_kind_2d(f, *mesh, boundaries_conditions, conductivity.matrix_bound());
+        conductivity.boundary_condition_first_kind(f);
+
+        start_time = std::chrono::high_resolution_clock::now();
+        const slae::operator_conjugate_gradient<T, hierarchical_conductivity_2d<T, I, Matrix_Index>> solver{conductivity};
+        Eigen::Matrix<T, Eigen::Dynamic, 1> temperature = solver.solve(f);
+        std::cout << "Iterations: " << solver.iterations() << std::endl;
+        elapsed_seconds = std::chrono::high_resolution_clock::now() - start_time;
+        std::cout << "SLAE solution time: " << elapsed_seconds.count() << 's' << std::endl;
+        return heat_equation_solution_2d<T, I>{mesh, parameters, temperature};
+    }
+
     auto start_time = std::chrono::high_resolution_clock::now();
     thermal_conductivity_matrix_2d<T, I, Matrix_Index> conductivity{mesh};
     conductivity.compute(parameters, utils::inner_nodes(mesh->container(), boundaries_conditions), is_symmetric, is_neumann);
@@ -64,9 +90,21 @@ heat_equation_solution_2d<T, I> stationary_heat_equation_solver_2d(const std::sh
 
     Eigen::Matrix<T, Eigen::Dynamic, 1> temperature;
     start_time = std::chrono::high_resolution_clock::now();
-    if (is_symmetric) {
+    if (is_symmetric && out_of_core) {
+        std::cout << "symmetric problem" << std::endl;
+        conductivity.write_inner(*out_of_core);
+        const slae::mapped_sparse_matrix<T, Matrix_Index> matrix{*out_of_core};
+        std::cout << "Out-of-core matrix blocks: " << matrix.blocks_count() << std::endl;
+        const slae::operator_conjugate_gradient<T, slae::mapped_sparse_matrix<T, Matrix_Index>> solver{matrix};
+        temperature = solver.solve(f);
+        std::cout << "Iterations: " << solver.iterations() << std::endl;
+    } else if (is_symmetric) {
         std::cout << "symmetric problem" << std::endl;
-        const slae::conjugate_gradient<T, Matrix_Index> solver{conductivity.matrix_inner()};
+        const slae::conjugate_gradient<T, Matrix_Index> solver{conductivity.matrix_inner(), slae_parameters};
+        if (solver.sliced_ellpack())
+            std::cout << "Sliced ELLPACK padding: " << solver.sliced_ellpack()->padding() << std::endl;
+        if (solver.compressed_indices())
+            std::cout << "Compressed indices bytes: " << solver.compressed_indices()->bytes() << std::endl;
         temperature = solver.solve(f);
         std::cout << "Iterations: " << solver.iterations() << std::endl;
     } else {
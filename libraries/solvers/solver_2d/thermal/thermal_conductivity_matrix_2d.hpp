@@ -2,9 +2,11 @@
 #define NONLOCAL_THERMAL_CONDUCTIVITY_MATRIX_2D_HPP
 
 #include "finite_element_matrix_2d.hpp"
+#include "tensor_product_matrices_2d.hpp"
 #include "thermal_parameters_2d.hpp"
 
 #include <string>
+#include <unordered_set>
 
 namespace nonlocal::thermal {
 
@@ -19,18 +21,23 @@ protected:
 
     template<class Integrator>
     void integrate_loc(const size_t e, const size_t i, const size_t j, const Integrator& integrator) const;
+    // The integrand of the affine element is constant, so the integrator is called once
+    template<class Integrator>
+    void integrate_loc_constant(const size_t e, const size_t i, const size_t j, const Integrator& integrator) const;
     T integrate_loc(const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, 
                     const size_t e, const size_t i, const size_t j) const;
     T integrate_loc(const parameter_2d<T, coefficients_t::SPACE_DEPENDENT>& parameter,  
                     const size_t e, const size_t i, const size_t j) const;
     T integrate_loc(const parameter_2d<T, coefficients_t::SOLUTION_DEPENDENT>& parameter,  const std::vector<T>& solution,
                     const size_t e, const size_t i, const size_t j) const;
+    // The whole local matrix of the tensor product element by the sum factorized kernel, see tensor_product_2d::stiffness
+    void integrate_loc(const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const size_t e,
+                       const metamath::finite_element::tensor_product_2d<T>& tensor_product, const std::span<T> matrix) const;
     
-    template<class Integrator>
-    std::array<T, 2> inner_integral(const size_t qnodes_count, const size_t eNL, const size_t jNL, const Integrator& integrator) const;
-    template<class Inner_Integrator, class Integrator>
-    void integrate_nonloc(const size_t eL, const size_t eNL, const size_t iL, const size_t jNL,
-                          const Inner_Integrator& inner_integrator, const Integrator& integrator) const;
+    // The coefficient is a factor of the inner integrand, which depends on the quadrature shift qNL
+    template<class Influence_Function, class Coefficient, class Integrator>
+    void integrate_nonloc(const Influence_Function& influence, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL,
+                          const Coefficient& coefficient, const Integrator& integrator) const;
     template<class Influence_Function>
     T integrate_nonloc(const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const Influence_Function& influence,
                        const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) const;
@@ -42,11 +49,21 @@ protected:
                        const std::vector<T>& solution,
                        const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) const;
 
+    template<class Influence_Function>
+    void integrate_nonloc_pair(const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const Influence_Function& influence,
+                               const size_t eL, const size_t eNL, std::vector<metamath::types::square_matrix<T, 1>>& blocks) const;
+
+    // The Neumann problem entries are preset in the outer indices
+    void resize_matrix(const bool is_symmetric, const bool is_neumann);
     void create_matrix_portrait(const std::unordered_map<std::string, theory_t> theories,
                                 const std::vector<bool>& is_inner, const bool is_symmetric, const bool is_neumann);
 
     void integral_condition(const bool is_symmetric);
 
+    void compute(const parameters_2d<T>& parameters, const std::unordered_map<std::string, theory_t>& theories,
+                 const std::vector<bool>& is_inner, const bool is_symmetric, const bool is_neumann,
+                 const std::optional<std::vector<T>>& solution);
+
 public:
     explicit thermal_conductivity_matrix_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh);
     ~thermal_conductivity_matrix_2d() noexcept override = default;
@@ -54,6 +71,13 @@ public:
     void compute(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
                  const bool is_symmetric = true, const bool is_neumann = false,
                  const std::optional<std::vector<T>>& solution = std::nullopt);
+
+    // Dry run of the assembly, only the non-zero elements of the rows are counted
+    assembly_plan_2d plan(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                          const bool is_symmetric = true, const bool is_neumann = false);
+    // The non-zero elements count of the matrix, the matrix is left empty
+    size_t nonzeros_count(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                          const bool is_symmetric = true, const bool is_neumann = false);
 };
 
 template<class T, class I, class Matrix_Index>
@@ -70,17 +94,43 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_basic(const size
     T integral = 0;
     const auto& el = _base::mesh().container().element_2d(e);
     for(const size_t q : el.qnodes())
-        integral += el.weight(q) * el.qN(i, q) * mesh::jacobian(_base::mesh().jacobi_matrix(e, q));
+        integral += _base::mesh().weighted_jacobian(e, q) * el.qN(i, q);
     return integral;
 }
 
 template<class T, class I, class Matrix_Index>
 template<class Integrator>
 void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(const size_t e, const size_t i, const size_t j, const Integrator& integrator) const {
-    const auto& el = _base::mesh().container().element_2d(e);
+    const auto& mesh = _base::mesh();
+    const auto& el = mesh.container().element_2d(e);
+    if (mesh.has_physical_gradients()) {
+        mesh.visit_precision([&mesh, &el, &integrator, e, i, j]<class U>(const std::type_identity<U>) {
+            const std::span<const U> weighted_jacobians = mesh.template weighted_jacobians<U>(e);
+            const std::span<const U> dNix = mesh.template gradients<U>(e, i, X), dNiy = mesh.template gradients<U>(e, i, Y);
+            const std::span<const U> dNjx = mesh.template gradients<U>(e, j, X), dNjy = mesh.template gradients<U>(e, j, Y);
+            const size_t step = mesh.is_affine(e) ? 0 : 1;
+            for(const size_t q : el.qnodes())
+                integrator(q, T(weighted_jacobians[q]), std::array<T, 2>{dNix[q * step], dNiy[q * step]},
+                                                        std::array<T, 2>{dNjx[q * step], dNjy[q * step]});
+        });
+        return;
+    }
     for(const size_t q : el.qnodes())
-        integrator(q, el.weight(q) / mesh::jacobian(_base::mesh().jacobi_matrix(e, q)),
-                   _base::mesh().derivatives(e, i, q), _base::mesh().derivatives(e, j, q));
+        integrator(q, el.weight(q) / mesh::jacobian(mesh.jacobi_matrix(e, q)), mesh.derivatives(e, i, q), mesh.derivatives(e, j, q));
+}
+
+template<class T, class I, class Matrix_Index>
+template<class Integrator>
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc_constant(const size_t e, const size_t i, const size_t j, const Integrator& integrator) const {
+    if (!_base::mesh().is_affine(e)) {
+        integrate_loc(e, i, j, integrator);
+        return;
+    }
+    const auto& mesh = _base::mesh();
+    const auto& el = mesh.container().element_2d(e);
+    const T factor = std::reduce(el.qnodes().begin(), el.qnodes().end(), T{0},
+                                 [&mesh, e](const T sum, const size_t q) { return sum + mesh.weighted_jacobian(e, q); });
+    integrator(0, factor, mesh.gradient(e, i, 0), mesh.gradient(e, j, 0));
 }
 
 template<class T, class I, class Matrix_Index>
@@ -89,7 +139,7 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(
     switch(const auto& conductivity = parameter.conductivity; parameter.material) {
     case material_t::ISOTROPIC: {
         T integral = T{0};
-        integrate_loc(e, i, j, [&integral](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
+        integrate_loc_constant(e, i, j, [&integral](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
             integral += factor * (dNi[X] * dNj[X] + dNi[Y] * dNj[Y]);
         });
         return conductivity[X][X] * integral;
@@ -97,7 +147,7 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(
 
     case material_t::ORTHOTROPIC: {
         std::array<T, 2> integral_part = {};
-        integrate_loc(e, i, j, [&integral_part](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
+        integrate_loc_constant(e, i, j, [&integral_part](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
             integral_part[X] += factor * dNi[X] * dNj[X];
             integral_part[Y] += factor * dNi[Y] * dNj[Y];
         });
@@ -106,7 +156,7 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(
 
     case material_t::ANISOTROPIC: {
         metamath::types::square_matrix<T, 2> integral_part = {};
-        integrate_loc(e, i, j, [&integral_part](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
+        integrate_loc_constant(e, i, j, [&integral_part](const size_t, const T factor, const std::array<T, 2>& dNi, const std::array<T, 2>& dNj) {
             using namespace metamath::functions;
             const std::array<T, 2> fdNi = factor * dNi;
             for(const size_t row : std::ranges::iota_view{0u, 2u})
@@ -183,29 +233,84 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(
 }
 
 template<class T, class I, class Matrix_Index>
-template<class Integrator>
-std::array<T, 2> thermal_conductivity_matrix_2d<T, I, Matrix_Index>::inner_integral(
-    const size_t qnodes_count, const size_t eNL, const size_t jNL, const Integrator& integrator) const {
-    using namespace metamath::functions;
-    std::array<T, 2> integral = {};
-    for(const size_t qNL : std::ranges::iota_view{0u, qnodes_count})
-        integral += integrator(qNL, _base::mesh().quad_coord(eNL, qNL)) * _base::mesh().derivatives(eNL, jNL, qNL);
-    return integral;
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_loc(
+    const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const size_t e,
+    const metamath::finite_element::tensor_product_2d<T>& tensor_product, const std::span<T> matrix) const {
+    metamath::types::square_matrix<T, 2> conductivity = {};
+    switch(parameter.material) {
+    case material_t::ISOTROPIC:
+        conductivity[X][X] = conductivity[Y][Y] = parameter.conductivity[X][X];
+    break;
+
+    case material_t::ORTHOTROPIC:
+        conductivity[X][X] = parameter.conductivity[X][X];
+        conductivity[Y][Y] = parameter.conductivity[Y][Y];
+    break;
+
+    case material_t::ANISOTROPIC:
+        conductivity = parameter.conductivity;
+    break;
+
+    default:
+        unknown_material(parameter.material);
+    }
+    const auto& mesh = _base::mesh();
+    const auto& el = mesh.container().element_2d(e);
+    tensor_product.stiffness([&mesh, &el, &conductivity, e](const size_t q) {
+        // The derivatives are B * (dN/dxi, dN/deta), see mesh::utils::derivatives_in_quad
+        const metamath::types::square_matrix<T, 2> J = mesh.jacobi_matrix(e, q);
+        const metamath::types::square_matrix<T, 2> B = {std::array{J[Y][Y], -J[Y][X]}, std::array{-J[X][Y], J[X][X]}};
+        const T factor = el.weight(q) / mesh::jacobian(J);
+        metamath::types::square_matrix<T, 2> coefficients = {};
+        for(const size_t k : std::ranges::iota_view{0u, 2u})
+            for(const size_t l : std::ranges::iota_view{0u, 2u})
+                for(const size_t row : std::ranges::iota_view{0u, 2u})
+                    for(const size_t col : std::ranges::iota_view{0u, 2u})
+                        coefficients[k][l] += factor * B[row][k] * conductivity[row][col] * B[col][l];
+        return coefficients;
+    }, matrix);
 }
 
 template<class T, class I, class Matrix_Index>
-template<class Inner_Integrator, class Integrator>
+template<class Influence_Function, class Coefficient, class Integrator>
 void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
-    const size_t eL, const size_t eNL, const size_t iL, const size_t jNL,
-    const Inner_Integrator& inner_integrator, const Integrator& integrator) const {
-    const auto& elL  = _base::mesh().container().element_2d(eL );
-    const auto& elNL = _base::mesh().container().element_2d(eNL);
+    const Influence_Function& influence, const size_t eL, const size_t eNL, const size_t iL, const size_t jNL,
+    const Coefficient& coefficient, const Integrator& integrator) const {
+    using namespace metamath::functions;
+    using enum mesh::quadrature_set_t;
+    const auto& mesh = _base::mesh();
+    const auto& elL = mesh.container().element_2d(eL, NONLOCAL_OUTER);
+    const size_t qshiftL = mesh.quad_shift(eL, NONLOCAL_OUTER);
+    const size_t qshiftNL = mesh.quad_shift(eNL, NONLOCAL_INNER);
+    const size_t derivatives_shift = mesh.quad_node_shift(eNL, jNL, NONLOCAL_INNER);
+    const size_t derivatives_step = mesh.is_affine(eNL) ? 0 : 1;
+    if (const auto& quadrature_neighbours = mesh.quadrature_neighbours(); quadrature_neighbours.contains(qshiftL)) {
+        const size_t neighbour = mesh.neighbour_index(eL, eNL);
+        mesh.visit_precision([&mesh, &quadrature_neighbours, &elL, &coefficient, &integrator, eL, iL, neighbour,
+                              qshiftL, qshiftNL, derivatives_shift, derivatives_step]<class U>(const std::type_identity<U>) {
+            for(const size_t qL : elL.qnodes()) {
+                const auto indices = quadrature_neighbours.indices(qshiftL + qL, neighbour);
+                const auto values = quadrature_neighbours.template values<U>(qshiftL + qL, neighbour);
+                std::array<T, 2> inner_integral = {};
+                for(const size_t k : std::ranges::iota_view{0u, indices.size()})
+                    inner_integral += T(values[k]) * coefficient(indices[k]) * mesh.derivatives(derivatives_shift, (indices[k] - qshiftNL) * derivatives_step, NONLOCAL_INNER);
+                integrator(elL.weight(qL), mesh.derivatives(eL, iL, qL, NONLOCAL_OUTER), inner_integral);
+            }
+        });
+        return;
+    }
+    const auto& elNL = mesh.container().element_2d(eNL, NONLOCAL_INNER);
+    thread_local std::vector<std::array<T, 2>> qcoords_buffer;
+    qcoords_buffer.resize(elNL.qnodes_count());
+    const std::span<const std::array<T, 2>> qcoordsNL = mesh.quad_coords(eNL, qcoords_buffer, NONLOCAL_INNER);
+    thread_local std::vector<T> influences;
+    influences.resize(elNL.qnodes_count());
     for(const size_t qL : elL.qnodes()) {
-        const auto callback = 
-            [&inner_integrator, &elNL, &qcoordL = _base::mesh().quad_coord(eL, qL)](const size_t qNL, const std::array<T, 2>& qcoordNL) {
-                return inner_integrator(qNL, elNL.weight(qNL), qcoordL, qcoordNL);
-            };
-        integrator(elL.weight(qL), _base::mesh().derivatives(eL, iL, qL), inner_integral(elNL.qnodes_count(), eNL, jNL, callback));
+        influence::evaluate(influence, mesh.quad_coord(qshiftL + qL, NONLOCAL_OUTER), qcoordsNL, std::span<T>{influences});
+        std::array<T, 2> inner_integral = {};
+        for(const size_t qNL : elNL.qnodes())
+            inner_integral += elNL.weight(qNL) * coefficient(qshiftNL + qNL) * influences[qNL] * mesh.derivatives(derivatives_shift, qNL * derivatives_step, NONLOCAL_INNER);
+        integrator(elL.weight(qL), mesh.derivatives(eL, iL, qL, NONLOCAL_OUTER), inner_integral);
     }
 }
 
@@ -214,13 +319,34 @@ template<class Influence_Function>
 T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
     const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const Influence_Function& influence,
     const size_t eL, const size_t eNL, const size_t iL, const size_t jNL) const {
-    const auto inner_integrator = [&influence](const size_t, const T weightNL, const std::array<T, 2>& qcoordL, const std::array<T, 2>& qcoordNL) {
-        return weightNL * influence(qcoordL, qcoordNL);
+    const auto integrate = [this, &influence, eL, eNL, iL, jNL](const auto& integrator) {
+        using namespace metamath::functions;
+        const auto& rules = _base::nonlocal_rules();
+        switch (rules.rule(_base::mesh(), eL, eNL)) {
+        case nonlocal_rule_t::CENTRES:
+            integrator(T{1}, _base::mesh().gradient_integral(eL, iL),
+                       influence(rules.centre(eL), rules.centre(eNL)) * _base::mesh().gradient_integral(eNL, jNL));
+            return;
+
+        case nonlocal_rule_t::INNER_CENTRE: {
+            using enum mesh::quadrature_set_t;
+            const auto& elL = _base::mesh().container().element_2d(eL, NONLOCAL_OUTER);
+            const size_t qshiftL = _base::mesh().quad_shift(eL, NONLOCAL_OUTER);
+            for(const size_t qL : elL.qnodes())
+                integrator(elL.weight(qL), _base::mesh().derivatives(eL, iL, qL, NONLOCAL_OUTER),
+                           influence(_base::mesh().quad_coord(qshiftL + qL, NONLOCAL_OUTER), rules.centre(eNL)) * _base::mesh().gradient_integral(eNL, jNL));
+            return;
+        }
+
+        case nonlocal_rule_t::FULL:
+        break;
+        }
+        integrate_nonloc(influence, eL, eNL, iL, jNL, [](const size_t) constexpr noexcept { return T{1}; }, integrator);
     };
     switch (const auto& conductivity = parameter.conductivity; parameter.material) {
     case material_t::ISOTROPIC: {
         T integral = T{0};
-        integrate_nonloc(eL, eNL, iL, jNL, inner_integrator,
+        integrate(
         [&integral](const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
             integral += weightL * (dNi[X] * inner_integral[X] + dNi[Y] * inner_integral[Y]);
         });
@@ -229,7 +355,7 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
     
     case material_t::ORTHOTROPIC: {
         std::array<T, 2> integral_part = {};
-        integrate_nonloc(eL, eNL, iL, jNL, inner_integrator,
+        integrate(
         [&integral_part](const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
             integral_part[X] += weightL * dNi[X] * inner_integral[X];
             integral_part[Y] += weightL * dNi[Y] * inner_integral[Y];
@@ -239,7 +365,7 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
 
     case material_t::ANISOTROPIC: {
         metamath::types::square_matrix<T, 2> integral_part = {};
-        integrate_nonloc(eL, eNL, iL, jNL, inner_integrator,
+        integrate(
         [&integral_part](const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
             using namespace metamath::functions;
             const std::array<T, 2> wdNi = weightL * dNi;
@@ -262,10 +388,10 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
     T integral = T{0};
     switch (const auto& conductivity = parameter.conductivity; parameter.material) {
     case material_t::ISOTROPIC: {
-        const auto inner_integrator = [&influence, &conductivity](const size_t, const T weightNL, const std::array<T, 2>& qcoordL, const std::array<T, 2>& qcoordNL) {
-            return weightNL * conductivity[X][X](qcoordNL) * influence(qcoordL, qcoordNL);
+        const auto coefficient = [this, &conductivity](const size_t qshiftNL) {
+            return conductivity[X][X](_base::mesh().quad_coord(qshiftNL, mesh::quadrature_set_t::NONLOCAL_INNER));
         };
-        integrate_nonloc(eL, eNL, iL, jNL, inner_integrator,
+        integrate_nonloc(influence, eL, eNL, iL, jNL, coefficient,
         [&integral](const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
             integral += weightL * (dNi[X] * inner_integral[X] + dNi[Y] * inner_integral[Y]);
         }); 
@@ -286,11 +412,10 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
     T integral = T{0};
     switch (const auto& conductivity = parameter.conductivity; parameter.material) {
     case material_t::ISOTROPIC: {
-        const auto inner_integrator = [this, &influence, &conductivity, &solution, eNL](const size_t qNL, const T weightNL, const std::array<T, 2>& qcoordL, const std::array<T, 2>& qcoordNL) {
-            const size_t qshift = _base::mesh().quad_shift(eNL) + qNL;
-            return weightNL * conductivity[X][X](qcoordNL, solution[qshift]) * influence(qcoordL, qcoordNL);
+        const auto coefficient = [this, &conductivity, &solution](const size_t qshiftNL) {
+            return conductivity[X][X](_base::mesh().quad_coord(qshiftNL, mesh::quadrature_set_t::NONLOCAL_INNER), solution[qshiftNL]);
         };
-        integrate_nonloc(eL, eNL, iL, jNL, inner_integrator,
+        integrate_nonloc(influence, eL, eNL, iL, jNL, coefficient,
         [&integral](const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
             integral += weightL * (dNi[X] * inner_integral[X] + dNi[Y] * inner_integral[Y]);
         });
@@ -303,8 +428,58 @@ T thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc(
 }
 
 template<class T, class I, class Matrix_Index>
-void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(
-    const std::unordered_map<std::string, theory_t> theories, const std::vector<bool>& is_inner, const bool is_symmetric, const bool is_neumann) {
+template<class Influence_Function>
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::integrate_nonloc_pair(
+    const parameter_2d<T, coefficients_t::CONSTANTS>& parameter, const Influence_Function& influence,
+    const size_t eL, const size_t eNL, std::vector<metamath::types::square_matrix<T, 1>>& blocks) const {
+    switch (const auto& conductivity = parameter.conductivity; parameter.material) {
+    case material_t::ISOTROPIC: {
+        thread_local std::vector<T> integrals;
+        integrals.assign(blocks.size(), T{0});
+        _base::integrate_nonloc_pair(influence, eL, eNL,
+        [](const size_t ij, const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
+            integrals[ij] += weightL * (dNi[X] * inner_integral[X] + dNi[Y] * inner_integral[Y]);
+        });
+        for(const size_t ij : std::ranges::iota_view{0u, blocks.size()})
+            blocks[ij][0][0] = conductivity[X][X] * integrals[ij];
+        return;
+    }
+
+    case material_t::ORTHOTROPIC: {
+        thread_local std::vector<std::array<T, 2>> integrals;
+        integrals.assign(blocks.size(), {});
+        _base::integrate_nonloc_pair(influence, eL, eNL,
+        [](const size_t ij, const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
+            integrals[ij][X] += weightL * dNi[X] * inner_integral[X];
+            integrals[ij][Y] += weightL * dNi[Y] * inner_integral[Y];
+        });
+        for(const size_t ij : std::ranges::iota_view{0u, blocks.size()})
+            blocks[ij][0][0] = conductivity[X][X] * integrals[ij][X] + conductivity[Y][Y] * integrals[ij][Y];
+        return;
+    }
+
+    case material_t::ANISOTROPIC: {
+        thread_local std::vector<metamath::types::square_matrix<T, 2>> integrals;
+        integrals.assign(blocks.size(), {});
+        _base::integrate_nonloc_pair(influence, eL, eNL,
+        [](const size_t ij, const T weightL, const std::array<T, 2>& dNi, const std::array<T, 2>& inner_integral) {
+            using namespace metamath::functions;
+            const std::array<T, 2> wdNi = weightL * dNi;
+            for(const size_t row : std::ranges::iota_view{0u, 2u})
+                for(const size_t col : std::ranges::iota_view{0u, 2u})
+                    integrals[ij][row][col] += wdNi[row] * inner_integral[col];
+        });
+        for(const size_t ij : std::ranges::iota_view{0u, blocks.size()})
+            blocks[ij][0][0] = conductivity[X][X] * integrals[ij][X][X] + conductivity[X][Y] * integrals[ij][X][Y] +
+                               conductivity[Y][Y] * integrals[ij][Y][Y] + conductivity[Y][X] * integrals[ij][Y][X];
+        return;
+    }
+    }
+    unknown_material(parameter.material);
+}
+
+template<class T, class I, class Matrix_Index>
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::resize_matrix(const bool is_symmetric, const bool is_neumann) {
     const size_t rows = _base::mesh().process_nodes().size() + (is_neumann && parallel_utils::is_last_process());
     const size_t cols = _base::mesh().container().nodes_count() + is_neumann;
     _base::matrix_inner().resize(rows, cols);
@@ -315,9 +490,15 @@ void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(
         if (!is_symmetric && parallel_utils::is_last_process())
             _base::matrix_inner().outerIndexPtr()[rows] = cols - 1;
     }
-    _base::init_shifts(theories, is_inner, is_symmetric);
-    static constexpr bool SORT_INDICES = false;
-    _base::init_indices(theories, is_inner, is_symmetric, SORT_INDICES);
+}
+
+template<class T, class I, class Matrix_Index>
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(
+    const std::unordered_map<std::string, theory_t> theories, const std::vector<bool>& is_inner, const bool is_symmetric, const bool is_neumann) {
+    resize_matrix(is_symmetric, is_neumann);
+    _base::init_portrait(theories, is_inner, is_symmetric);
+    const size_t rows = _base::matrix_inner().rows();
+    const size_t cols = _base::matrix_inner().cols();
     if (is_neumann) {
         for(const size_t row : std::ranges::iota_view{0u, rows})
             _base::matrix_inner().innerIndexPtr()[_base::matrix_inner().outerIndexPtr()[row + 1] - 1] = _base::mesh().container().nodes_count();
@@ -325,8 +506,24 @@ void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::create_matrix_portrait(
             for(const size_t col : std::ranges::iota_view{0u, cols})
                 _base::matrix_inner().innerIndexPtr()[_base::matrix_inner().outerIndexPtr()[rows - 1] + col] = col;
     }
-    utils::sort_indices(_base::matrix_inner());
-    utils::sort_indices(_base::matrix_bound());
+}
+
+template<class T, class I, class Matrix_Index>
+assembly_plan_2d thermal_conductivity_matrix_2d<T, I, Matrix_Index>::plan(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                                                                          const bool is_symmetric, const bool is_neumann) {
+    const std::unordered_map<std::string, theory_t> theories = theories_types(parameters);
+    resize_matrix(is_symmetric, is_neumann);
+    _base::init_shifts(theories, is_inner, is_symmetric);
+    return _base::plan(theories);
+}
+
+template<class T, class I, class Matrix_Index>
+size_t thermal_conductivity_matrix_2d<T, I, Matrix_Index>::nonzeros_count(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner,
+                                                                          const bool is_symmetric, const bool is_neumann) {
+    resize_matrix(is_symmetric, is_neumann);
+    const size_t nonzeros = _base::count_nonzeros(theories_types(parameters), is_inner, is_symmetric);
+    _base::clear();
+    return nonzeros;
 }
 
 template<class T, class I, class Matrix_Index>
@@ -346,14 +543,45 @@ template<class T, class I, class Matrix_Index>
 void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::compute(const parameters_2d<T>& parameters, const std::vector<bool>& is_inner, 
                                                                  const bool is_symmetric, const bool is_neumann,
                                                                  const std::optional<std::vector<T>>& solution) {
-    const std::unordered_map<std::string, theory_t> theories = theories_types(parameters);
+    compute(parameters, theories_types(parameters), is_inner, is_symmetric, is_neumann, solution);
+}
+
+template<class T, class I, class Matrix_Index>
+void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::compute(const parameters_2d<T>& parameters, 
+                                                                 const std::unordered_map<std::string, theory_t>& theories,
+                                                                 const std::vector<bool>& is_inner, 
+                                                                 const bool is_symmetric, const bool is_neumann,
+                                                                 const std::optional<std::vector<T>>& solution) {
+    // The solution is given in the local quadrature nodes
+    if (!_base::mesh().is_same_quadratures(mesh::quadrature_set_t::LOCAL, mesh::quadrature_set_t::NONLOCAL_INNER))
+        for(const auto& [group, theory] : theories)
+            if (theory == theory_t::NONLOCAL && parameter_cast<coefficients_t::SOLUTION_DEPENDENT>(parameters.at(group).physical.get()))
+                throw std::logic_error{"The solution dependent nonlocal conductivity requires the same local and inner nonlocal quadratures."};
     create_matrix_portrait(theories, is_inner, is_symmetric, is_neumann);
-    _base::calc_coeffs(theories, is_inner, is_symmetric,
-        [this, &parameters, &solution](const std::string& group, const size_t e, const size_t i, const size_t j) {
+    _base::compute_nonlocal_rules(theories, parameters);
+    std::unordered_set<std::string> pair_groups;
+    std::unordered_map<std::string, theory_t> coeffs_theories = theories;
+    if (is_symmetric)
+        for(auto& [group, theory] : coeffs_theories)
+            if (theory == theory_t::NONLOCAL && parameter_cast<coefficients_t::CONSTANTS>(parameters.at(group).physical.get())) {
+                pair_groups.insert(group);
+                theory = theory_t::LOCAL; // local part is assembled as usual
+            }
+    std::unordered_set<std::string> constant_groups;
+    for(const auto& [group, parameter] : parameters)
+        if (parameter_cast<coefficients_t::CONSTANTS>(parameter.physical.get()))
+            constant_groups.insert(group);
+    tensor_product_matrices_2d<T> local_matrices;
+    local_matrices.compute(_base::mesh(), constant_groups,
+        [this, &parameters](const std::string& group, const size_t e, const auto& tensor_product, const std::span<T> matrix) {
+            integrate_loc(*parameter_cast<coefficients_t::CONSTANTS>(parameters.at(group).physical.get()), e, tensor_product, matrix);
+        });
+    _base::calc_coeffs(coeffs_theories, is_inner, is_symmetric,
+        [this, &parameters, &solution, &local_matrices](const std::string& group, const size_t e, const size_t i, const size_t j) {
             using enum coefficients_t;
             const auto& [model, physic] = parameters.at(group);
             if (const auto* const parameter = parameter_cast<CONSTANTS>(physic.get()); parameter)
-                return model.local_weight * integrate_loc(*parameter, e, i, j);
+                return model.local_weight * (local_matrices.contains(e) ? local_matrices(e, i, j) : integrate_loc(*parameter, e, i, j));
             if (const auto* const parameter = parameter_cast<SPACE_DEPENDENT>(physic.get()); parameter)
                 return model.local_weight * integrate_loc(*parameter, e, i, j);
             if (const auto* const parameter = parameter_cast<SOLUTION_DEPENDENT>(physic.get()); parameter)
@@ -364,13 +592,25 @@ void thermal_conductivity_matrix_2d<T, I, Matrix_Index>::compute(const parameter
             using enum coefficients_t;
             const auto& [model, physic] = parameters.at(group);
             const T nonlocal_weight = nonlocal::nonlocal_weight(model.local_weight);
-            if (const auto* const parameter = parameter_cast<CONSTANTS>(physic.get()); parameter)
-                return nonlocal_weight * integrate_nonloc(*parameter, model.influence, eL, eNL, iL, jNL);
-            if (const auto* const parameter = parameter_cast<SPACE_DEPENDENT>(physic.get()); parameter)
-                return nonlocal_weight * integrate_nonloc(*parameter, model.influence, eL, eNL, iL, jNL);
-            if (const auto* const parameter = parameter_cast<SOLUTION_DEPENDENT>(physic.get()); parameter)
-                return nonlocal_weight * integrate_nonloc(*parameter, model.influence, *solution, eL, eNL, iL, jNL);
-            return std::numeric_limits<T>::quiet_NaN();
+            return model.influence.visit([&](const auto& influence) {
+                if (const auto* const parameter = parameter_cast<CONSTANTS>(physic.get()); parameter)
+                    return nonlocal_weight * integrate_nonloc(*parameter, influence, eL, eNL, iL, jNL);
+                if (const auto* const parameter = parameter_cast<SPACE_DEPENDENT>(physic.get()); parameter)
+                    return nonlocal_weight * integrate_nonloc(*parameter, influence, eL, eNL, iL, jNL);
+                if (const auto* const parameter = parameter_cast<SOLUTION_DEPENDENT>(physic.get()); parameter)
+                    return nonlocal_weight * integrate_nonloc(*parameter, influence, *solution, eL, eNL, iL, jNL);
+                return std::numeric_limits<T>::quiet_NaN();
+            });
+        });
+    _base::calc_nonlocal_pairs(pair_groups, is_inner,
+        [this, &parameters](const std::string& group, const size_t eL, const size_t eNL, std::vector<metamath::types::square_matrix<T, 1>>& blocks) {
+            const auto& [model, physic] = parameters.at(group);
+            model.influence.visit([&](const auto& influence) {
+                integrate_nonloc_pair(*parameter_cast<coefficients_t::CONSTANTS>(physic.get()), influence, eL, eNL, blocks);
+            });
+            const T nonlocal_weight = nonlocal::nonlocal_weight(model.local_weight);
+            for(auto& block : blocks)
+                block[0][0] = nonlocal_weight * block[0][0];
         });
     if (is_neumann)
         integral_condition(is_symmetric);
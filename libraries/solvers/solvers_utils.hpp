@@ -1,28 +1,84 @@
 #ifndef NONLOCAL_SOLVERS_UTILS_HPP
 #define NONLOCAL_SOLVERS_UTILS_HPP
 
+#include "OMP_utils.hpp"
+#include "init_uniform_ranges.hpp"
+#include "init_balanced_ranges.hpp"
+
 #include <Eigen/Sparse>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 #include <ranges>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 namespace nonlocal::utils {
 
+// The rows of the matrix are distributed between the threads as in the conjugate gradient,
+// so the threads which first touch the rows are the ones that multiply them
+template<class T, class I>
+std::vector<std::ranges::iota_view<size_t, size_t>> threads_rows(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& K,
+                                                                 const size_t threads_count = parallel_utils::threads_count()) {
+    return parallel_utils::init_balanced_ranges(std::span<const I>{K.outerIndexPtr(), size_t(K.rows() + 1)},
+                                                std::clamp(threads_count, size_t{1}, std::max(size_t(K.rows()), size_t{1})));
+}
+
+// The parallel prefix sum: the sums of the threads blocks of the rows are accumulated after the sums in the blocks.
+// The index type too narrow for the non-zero elements count is reported by std::overflow_error
 template<class T, class I>
 void accumulate_shifts(Eigen::SparseMatrix<T, Eigen::RowMajor, I>& K) {
-    for(const size_t i : std::ranges::iota_view{0u, size_t(K.rows())})
-        K.outerIndexPtr()[i + 1] += K.outerIndexPtr()[i];
+    const auto ranges = parallel_utils::init_uniform_ranges(K.rows(), parallel_utils::threads_count());
+    std::vector<I> sums(ranges.size() + 1, I{0});
+    bool is_overflow = false;
+#pragma omp parallel for default(none) shared(K, ranges, sums) reduction(|| : is_overflow) schedule(static, 1)
+    for(size_t thread = 0; thread < ranges.size(); ++thread)
+        for(const size_t i : ranges[thread])
+            if (K.outerIndexPtr()[i + 1] > std::numeric_limits<I>::max() - sums[thread + 1])
+                is_overflow = true;
+            else
+                K.outerIndexPtr()[i + 1] = sums[thread + 1] += K.outerIndexPtr()[i + 1];
+    sums.front() = K.outerIndexPtr()[0];
+    for(size_t thread = 0; thread < ranges.size() && !is_overflow; ++thread)
+        if (sums[thread + 1] > std::numeric_limits<I>::max() - sums[thread])
+            is_overflow = true;
+        else
+            sums[thread + 1] += sums[thread];
+    if (is_overflow)
+        throw std::overflow_error{"The number of non-zero elements exceeds the range of the matrix index type."};
+#pragma omp parallel for default(none) shared(K, ranges, sums) schedule(static, 1)
+    for(size_t thread = 0; thread < ranges.size(); ++thread)
+        for(const size_t i : ranges[thread])
+            K.outerIndexPtr()[i + 1] += sums[thread];
 }
 
+// The pages of the indices and values are first touched by the threads which will multiply the rows
 template<class T, class I>
 void allocate_matrix(Eigen::SparseMatrix<T, Eigen::RowMajor, I>& K) {
     K.data().resize(K.outerIndexPtr()[K.rows()]);
-    for(const size_t i : std::ranges::iota_view{size_t{0}, size_t(K.nonZeros())}) {
-        K.innerIndexPtr()[i] = 0;
-        K.valuePtr()[i] = T{0};
+    const auto ranges = threads_rows(K);
+#pragma omp parallel for default(none) shared(K, ranges) schedule(static, 1)
+    for(size_t thread = 0; thread < ranges.size(); ++thread)
+        for(const size_t row : ranges[thread]) {
+            std::fill(&K.innerIndexPtr()[K.outerIndexPtr()[row]], &K.innerIndexPtr()[K.outerIndexPtr()[row + 1]], I{0});
+            std::fill(&K.valuePtr()[K.outerIndexPtr()[row]], &K.valuePtr()[K.outerIndexPtr()[row + 1]], T{0});
+        }
+}
+
+// The matrices must have the same portraits. The deviation is relative to the maximum absolute value of the reference matrix
+template<class T, class I>
+T max_relative_deviation(const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& reference, const Eigen::SparseMatrix<T, Eigen::RowMajor, I>& matrix) {
+    if (reference.nonZeros() != matrix.nonZeros())
+        throw std::logic_error{"The deviation cannot be found because the matrices have different portraits."};
+    T max_value = T{0}, max_deviation = T{0};
+    for(const size_t i : std::ranges::iota_view{size_t{0}, size_t(reference.nonZeros())}) {
+        max_value = std::max(max_value, std::abs(reference.valuePtr()[i]));
+        max_deviation = std::max(max_deviation, std::abs(reference.valuePtr()[i] - matrix.valuePtr()[i]));
     }
+    return max_value > T{0} ? max_deviation / max_value : max_deviation;
 }
 
 template<class T, class I>
@@ -5,6 +5,7 @@
 #include "thermal_problems_2d.hpp"
 #include "mechanical_problems_2d.hpp"
 
+#include <limits>
 #include <set>
 
 namespace nonlocal {
@@ -35,17 +36,71 @@ void problems_1d(const nlohmann::json& config, const config::save_data& save, co
 }
 
 template<std::floating_point T, std::signed_integral I>
-void problems_2d(const nlohmann::json& config, const config::save_data& save, const config::task_data& task) {
-    config::check_required_fields(config, {"boundaries", "materials", "mesh"});
-    config::check_optional_fields(config, {"auxiliary"});
-    auto mesh = std::make_shared<mesh::mesh_2d<T, I>>(config::mesh_data<2>{config["mesh"], "mesh"}.path);
+void find_neighbours_2d(mesh::mesh_2d<T, I>& mesh, const nlohmann::json& config, const config::task_data& task) {
     if (task.problem == nonlocal::config::problem_t::THERMAL)
-        thermal::solve_thermal_2d_problem(mesh, config, save, task.time_dependency);
+        thermal::find_thermal_2d_neighbours(mesh, config);
     else if (task.problem == nonlocal::config::problem_t::MECHANICAL)
-        mechanical::solve_mechanical_2d_problem(mesh, config, save, task.time_dependency);
+        mechanical::find_mechanical_2d_neighbours(mesh, config);
     else throw std::domain_error{"Unknown task. In the two-dimensional case, the following problems are available: \"thermal\", \"mechanical\""};
 }
 
+template<std::floating_point T, std::signed_integral I>
+size_t nonzeros_count_2d(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const nlohmann::json& config, const config::task_data& task) {
+    return task.problem == nonlocal::config::problem_t::THERMAL ? thermal::thermal_2d_nonzeros_count(mesh, config) :
+                                                                 mechanical::mechanical_2d_nonzeros_count(mesh, config);
+}
+
+template<std::floating_point T, std::signed_integral I>
+void solve_problem_2d(std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const config::mesh_data<2>& mesh_data, const nlohmann::json& config,
+                      const config::save_data& save, const config::task_data& task) {
+    if (task.problem == nonlocal::config::problem_t::THERMAL)
+        thermal::solve_thermal_2d_problem(mesh, mesh_data, config, save, task.time_dependency);
+    else
+        mechanical::solve_mechanical_2d_problem(mesh, mesh_data, config, save, task.time_dependency);
+}
+
+// The 32-bit mesh and matrix indices are chosen up front, if they can index the problem, otherwise I is used.
+// The nodes and elements of the mesh file smaller than 2^31 bytes fit into them, the quadrature tables are counted
+// after the mesh is read and the non-zero elements of the matrix are counted after the neighbours search,
+// unless the nodes count already bounds them. The widths of the mesh and matrix indices are the same.
+template<std::floating_point T, std::signed_integral I>
+void problems_2d(const nlohmann::json& config, const config::save_data& save, const config::task_data& task) {
+    config::check_required_fields(config, {"boundaries", "materials", "mesh"});
+    config::check_optional_fields(config, {"auxiliary", "solver"});
+    const config::mesh_data<2> mesh_data{config["mesh"], "mesh"};
+    const config::solver_data<T> solver{config.value("solver", nlohmann::json::object()), "solver"};
+    // The pages of the mesh and matrices are first touched after the binding, so they stay on the sockets of their threads
+    if (solver.bind_threads) {
+        if (const std::string binding = parallel_utils::bind_threads(); binding.empty())
+            logger::get().log(logger::log_level::WARNING) << "The threads binding is not supported." << std::endl;
+        else
+            std::cout << "Threads binding: " << binding << std::endl;
+    }
+    if constexpr (sizeof(I) > sizeof(int32_t)) {
+        static constexpr size_t max_index = std::numeric_limits<int32_t>::max();
+        if (std::filesystem::file_size(mesh_data.path) <= max_index) {
+            auto container = make_mesh_container_2d<T, int32_t>(mesh_data);
+            const size_t dofs = (task.problem == nonlocal::config::problem_t::MECHANICAL ? 2 : 1) * container.nodes_count() + 1;
+            const size_t tables_size = mesh::utils::quadrature_tables_size_2d(container);
+            // The near field of the hierarchical operator is bounded only by the square of the quadrature nodes count
+            const bool is_hierarchical = task.problem == nonlocal::config::problem_t::THERMAL && solver.hierarchical;
+            if (tables_size <= max_index && (!is_hierarchical || tables_size * tables_size <= max_index)) {
+                auto mesh = make_mesh_2d(std::move(container), mesh_data);
+                find_neighbours_2d(*mesh, config, task);
+                if (dofs * dofs <= max_index || nonzeros_count_2d(mesh, config, task) <= max_index) {
+                    solve_problem_2d(mesh, mesh_data, config, save, task);
+                    return;
+                }
+            }
+            logger::get().log(logger::log_level::WARNING) << "The problem does not fit into the 32-bit indices, "
+                                                             "so it is solved with the wider ones." << std::endl;
+        }
+    }
+    auto mesh = make_mesh_2d<T, I>(mesh_data);
+    find_neighbours_2d(*mesh, config, task);
+    solve_problem_2d(mesh, mesh_data, config, save, task);
+}
+
 template<std::floating_point T, std::signed_integral I>
 void determine_problem(const nlohmann::json& config) {
     const bool contains_save = config.contains("save");
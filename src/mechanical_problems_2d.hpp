@@ -14,8 +14,9 @@ mechanical_parameters_2d<T> make_parameters(const config::mechanical_materials_2
     for(const auto& [name, material] : materials.materials)
         parameters.materials[name] = {
             .model = {
-                .influence = influence::polynomial_2d<T, 2, 1>{material.model.nonlocal_radius},
-                .local_weight = material.model.local_weight
+                .influence = make_influence(material.model),
+                .local_weight = material.model.local_weight,
+                .quadrature_tolerance = material.model.quadrature_tolerance
             },
             .physical = {
                 material.physical.youngs_modulus,
@@ -78,21 +79,56 @@ void save_solution(const mechanical::mechanical_solution_2d<T, I>& solution,
     );
 }
 
+template<std::floating_point T, std::signed_integral I>
+void find_mechanical_2d_neighbours(mesh::mesh_2d<T, I>& mesh, const nlohmann::json& config) {
+    const config::mechanical_materials_2d<T> materials{config["materials"], "materials"};
+    print_truncation_estimates(mesh, materials, 2);
+    mesh.find_neighbours(get_search_radii(materials), get_influence_supports(materials));
+}
+
+template<std::floating_point T, std::signed_integral I>
+size_t mechanical_2d_nonzeros_count(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const nlohmann::json& config) {
+    const auto parameters = make_parameters(config::mechanical_materials_2d<T>{config["materials"], "materials"});
+    const auto boundaries_conditions = make_boundaries_conditions(
+        config::mechanical_boundaries_conditions_2d<T>{config["boundaries"], "boundaries"});
+    stiffness_matrix<T, I, I> stiffness{mesh};
+    return stiffness.nonzeros_count(parameters.materials, utils::inner_nodes(mesh->container(), boundaries_conditions));
+}
+
+// Must be called after find_mechanical_2d_neighbours
 template<std::floating_point T, std::signed_integral I>
 void solve_mechanical_2d_problem(
-    std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const nlohmann::json& config, 
+    std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const config::mesh_data<2u>& mesh_data, const nlohmann::json& config,
     const config::save_data& save, const bool time_dependency) {
     if (time_dependency)
         throw std::domain_error{"Mechanical problem does not support time dependence."};
 
     const config::mechanical_materials_2d<T> materials{config["materials"], "materials"};
-    mesh->find_neighbours(get_search_radii(materials));
+    const config::solver_data<T> solver{config.value("solver", nlohmann::json::object()), "solver"};
     const auto parameters = make_parameters(materials);
     const auto boundaries_conditions = make_boundaries_conditions(
         config::mechanical_boundaries_conditions_2d<T>{config["boundaries"], "boundaries"});
+    if (solver.dry_run) {
+        static constexpr assembly_costs<T> COSTS = {.evaluation = T{170}, .nonzero = T{160}};
+        static constexpr bool HAS_MATRIX_FREE = false;
+        stiffness_matrix<T, I, I> stiffness{mesh};
+        print_assembly_plan<T, I>(stiffness.plan(parameters.materials, utils::inner_nodes(mesh->container(), boundaries_conditions)),
+                                  solver, COSTS, HAS_MATRIX_FREE);
+        return;
+    }
+    if (solver.quadrature_neighbours)
+        mesh->find_quadrature_neighbours(get_influences(materials));
+    reduce_tables_precision(*mesh, mesh_data, [&mesh, &parameters, &boundaries_conditions] {
+        stiffness_matrix<T, I, I> stiffness{mesh};
+        stiffness.compute(parameters.materials, parameters.plane, utils::inner_nodes(mesh->container(), boundaries_conditions));
+        return std::array{std::move(stiffness.matrix_inner()), std::move(stiffness.matrix_bound())};
+    });
     auto solution = nonlocal::mechanical::equilibrium_equation<I>(
         mesh, parameters, boundaries_conditions,
-        [](const std::array<T, 2>&) constexpr noexcept { return std::array<T, 2>{}; }
+        [](const std::array<T, 2>&) constexpr noexcept { return std::array<T, 2>{}; },
+        solver.block_sparse,
+        get_conjugate_gradient_parameters(solver),
+        get_out_of_core_parameters(solver)
     );
     solution.calc_strain_and_stress();
     save_solution(solution, save);
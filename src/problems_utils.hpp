@@ -5,6 +5,15 @@
 
 #include "nonlocal_config.hpp"
 #include "mesh_1d.hpp"
+#include "influence_functions_1d.hpp"
+#include "influence_functions_2d.hpp"
+#include "hierarchical_influence_matrix_2d.hpp"
+#include "base/finite_element_matrix_2d.hpp"
+#include "conjugate_gradient.hpp"
+#include "mapped_sparse_matrix.hpp"
+#include "OMP_utils.hpp"
+
+#include <unistd.h>
 
 namespace nonlocal {
 
@@ -30,6 +39,147 @@ std::shared_ptr<mesh::mesh_1d<T>> make_mesh_1d(
     );
 }
 
+// Unset nonlocal outer quadrature is the local one, unset nonlocal inner quadrature is the outer one
+template<std::floating_point T, std::signed_integral I>
+mesh::mesh_container_2d<T, I> make_mesh_container_2d(const config::mesh_data<2u>& mesh_data) {
+    mesh::quadratures_2d quadratures;
+    for(const auto& [name, orders] : mesh_data.quadratures) {
+        const auto it = std::ranges::find(mesh::element_2d_names, name);
+        if (it == mesh::element_2d_names.end())
+            throw std::domain_error{"Unknown element type \"" + name + "\" in the mesh quadratures."};
+        const size_t outer = orders.nonlocal_outer ? orders.nonlocal_outer : orders.local;
+        const size_t inner = orders.nonlocal_inner ? orders.nonlocal_inner : outer;
+        quadratures[mesh::element_2d_t(std::distance(mesh::element_2d_names.begin(), it))] = {orders.local, outer, inner};
+    }
+    return mesh::mesh_container_2d<T, I>{mesh_data.path, quadratures};
+}
+
+template<std::floating_point T, std::signed_integral I>
+std::shared_ptr<mesh::mesh_2d<T, I>> make_mesh_2d(mesh::mesh_container_2d<T, I>&& container, const config::mesh_data<2u>& mesh_data) {
+    auto mesh = std::make_shared<mesh::mesh_2d<T, I>>(std::move(container));
+    if (mesh_data.physical_gradients)
+        mesh->compute_physical_gradients();
+    return mesh;
+}
+
+template<std::floating_point T, std::signed_integral I>
+std::shared_ptr<mesh::mesh_2d<T, I>> make_mesh_2d(const config::mesh_data<2u>& mesh_data) {
+    return make_mesh_2d(make_mesh_container_2d<T, I>(mesh_data), mesh_data);
+}
+
+// In the validation mode the matrix is assembled with the full and the reduced precision tables
+// and the maximum relative deviation of the values is printed. The assembly returns the inner and bound parts of the matrix.
+template<std::floating_point T, std::signed_integral I, class Assemble>
+void reduce_tables_precision(mesh::mesh_2d<T, I>& mesh, const config::mesh_data<2u>& mesh_data, const Assemble& assemble) {
+    if (!mesh_data.reduced_precision)
+        return;
+    if (!mesh_data.validate_precision) {
+        mesh.reduce_tables_precision();
+        return;
+    }
+    const auto reference = assemble();
+    mesh.reduce_tables_precision();
+    const auto reduced = assemble();
+    std::cout << "Maximum relative deviation of the matrix assembled with the reduced precision tables: "
+              << std::max(utils::max_relative_deviation(reference[0], reduced[0]),
+                          utils::max_relative_deviation(reference[1], reduced[1])) << std::endl;
+}
+
+// Nanoseconds per the kernel evaluation and per the non-zero element,
+// which were calibrated on the single-threaded assembly of the bilinear elements
+template<std::floating_point T>
+struct assembly_costs final {
+    T evaluation = T{0};
+    T nonzero = T{0};
+};
+
+// The assembly time is estimated from the costs and divided by the threads count of the process.
+// The cached quadrature neighbours are estimated by the upper bound of the kernel evaluations.
+// If the data does not fit into the physical memory of the node, the number of the MPI processes
+// and, if available, the matrix-free operator are suggested.
+template<std::floating_point T, std::signed_integral I>
+void print_assembly_plan(const assembly_plan_2d& plan, const config::solver_data<T>& solver,
+                         const assembly_costs<T>& costs, const bool has_matrix_free) {
+    static constexpr T MiB = T{1024 * 1024};
+    const size_t quadrature_neighbours_memory = solver.quadrature_neighbours ? plan.kernel_evaluations * (sizeof(I) + sizeof(T)) : 0;
+    const size_t memory = plan.matrix_memory + plan.neighbours_memory + quadrature_neighbours_memory;
+    const T evaluation_cost = solver.dry_run->evaluation_cost.value_or(costs.evaluation);
+    const T nonzero_cost = solver.dry_run->nonzero_cost.value_or(costs.nonzero);
+    const T time = (plan.kernel_evaluations * evaluation_cost + plan.nonzeros * nonzero_cost) / (T{1e9} * parallel_utils::threads_count());
+    std::cout << "Dry run of the assembly:\n"
+              << "  rows: " << plan.rows << ", non-zero elements: " << plan.nonzeros << '\n'
+              << "  local pairs of nodes: " << plan.local_pairs << ", nonlocal pairs of elements: " << plan.nonlocal_pairs << '\n'
+              << "  kernel evaluations: " << plan.kernel_evaluations << '\n'
+              << "  matrix memory: " << plan.matrix_memory / MiB << " MiB, neighbours memory: " << plan.neighbours_memory / MiB << " MiB";
+    if (solver.quadrature_neighbours)
+        std::cout << ", quadrature neighbours memory: " << quadrature_neighbours_memory / MiB << " MiB";
+    std::cout << "\n  estimated assembly time: " << time << " s" << std::endl;
+    if (const size_t physical_memory = size_t(sysconf(_SC_PHYS_PAGES)) * size_t(sysconf(_SC_PAGE_SIZE)); memory > physical_memory) {
+        std::cout << "The data does not fit into " << physical_memory / MiB << " MiB of the physical memory, at least "
+                  << (memory + physical_memory - 1) / physical_memory << " MPI processes are required";
+        if (has_matrix_free && !solver.hierarchical)
+            std::cout << " or the matrix-free operator \"hierarchical\" is recommended";
+        std::cout << '.' << std::endl;
+    }
+}
+
+template<std::floating_point T>
+std::function<T(const T, const T)> make_influence(const config::model_data<T, 1>& model) {
+    switch (model.influence) {
+    case config::influence_t::CONSTANT:
+        return influence::constant_1d<T>{model.nonlocal_radius};
+    case config::influence_t::POLYNOMIAL:
+        return influence::polynomial_1d<T, 1, 1>{model.nonlocal_radius};
+    case config::influence_t::NORMAL_DISTRIBUTION:
+        return influence::normal_distribution_1d<T>{model.nonlocal_radius};
+    default:
+        throw std::domain_error{"Unknown influence function type: " + std::to_string(uint(model.influence))};
+    }
+}
+
+template<std::floating_point T>
+influence::influence_2d<T> make_influence(const config::model_data<T, 2>& model) {
+    switch (model.influence) {
+    case config::influence_t::CONSTANT:
+        return influence::constant_2d<T>{model.nonlocal_radius};
+    case config::influence_t::POLYNOMIAL:
+        return influence::polynomial_2d<T, 2, 1>{model.nonlocal_radius};
+    case config::influence_t::NORMAL_DISTRIBUTION:
+        return influence::normal_distribution_2d<T>{model.nonlocal_radius, model.truncation_tolerance};
+    default:
+        throw std::domain_error{"Unknown influence function type: " + std::to_string(uint(model.influence))};
+    }
+}
+
+template<std::floating_point T>
+std::optional<hierarchical_parameters<T>> get_hierarchical_parameters(const config::solver_data<T>& solver) {
+    if (!solver.hierarchical)
+        return std::nullopt;
+    return hierarchical_parameters<T>{
+        .tolerance = solver.hierarchical->tolerance,
+        .admissibility = solver.hierarchical->admissibility,
+        .leaf_size = solver.hierarchical->leaf_size
+    };
+}
+
+template<std::floating_point T>
+slae::conjugate_gradient_parameters<T> get_conjugate_gradient_parameters(const config::solver_data<T>& solver) {
+    return slae::conjugate_gradient_parameters<T>{
+        .sliced_ellpack_padding = solver.sliced_ellpack_padding,
+        .compressed_indices = solver.compressed_indices
+    };
+}
+
+template<std::floating_point T>
+std::optional<slae::out_of_core_parameters> get_out_of_core_parameters(const config::solver_data<T>& solver) {
+    if (!solver.out_of_core)
+        return std::nullopt;
+    return slae::out_of_core_parameters{
+        .path = solver.out_of_core->path,
+        .block_bytes = solver.out_of_core->block_size << 20
+    };
+}
+
 template<std::floating_point T, template<class, size_t> class Physics>
 std::unordered_map<std::string, T> get_search_radii(const config::materials_data<Physics, T, 2>& materials) {
     std::unordered_map<std::string, T> result;
@@ -39,6 +189,54 @@ std::unordered_map<std::string, T> get_search_radii(const config::materials_data
     return result;
 }
 
+template<std::floating_point T, template<class, size_t> class Physics>
+std::unordered_map<std::string, influence::influence_2d<T>> get_influences(const config::materials_data<Physics, T, 2>& materials) {
+    std::unordered_map<std::string, influence::influence_2d<T>> result;
+    for(const auto& [name, material] : materials.materials)
+        if (theory_type(material.model.local_weight) == theory_t::NONLOCAL)
+            result[name] = make_influence(material.model);
+    return result;
+}
+
+// Supports of the compactly supported influence functions, which allow to skip the pairs of elements without interaction
+template<std::floating_point T, template<class, size_t> class Physics>
+std::unordered_map<std::string, mesh::support_2d<T>> get_influence_supports(const config::materials_data<Physics, T, 2>& materials) {
+    std::unordered_map<std::string, mesh::support_2d<T>> result;
+    for(const auto& [name, material] : materials.materials)
+        if (theory_type(material.model.local_weight) == theory_t::NONLOCAL) {
+            if (material.model.influence == config::influence_t::CONSTANT || material.model.influence == config::influence_t::POLYNOMIAL)
+                result[name] = mesh::support_2d<T>{.radius = material.model.nonlocal_radius};
+            else if (material.model.influence == config::influence_t::NORMAL_DISTRIBUTION && material.model.truncation_tolerance > T{0})
+                result[name] = mesh::support_2d<T>{.radius = material.model.truncation_radius()};
+        }
+    return result;
+}
+
+// The number of nonzero elements in the nonlocal rows of the truncated normal distribution groups is estimated
+// from the average nodes density before the assembly, so the accuracy/cost trade-off of the truncation tolerance is visible.
+// Both triangles of the matrix are counted. Boundary effects are neglected,
+// so the estimate is overrated if the truncation radius is comparable with the group size.
+template<std::floating_point T, std::signed_integral I, template<class, size_t> class Physics>
+void print_truncation_estimates(const mesh::mesh_2d<T, I>& mesh, const config::materials_data<Physics, T, 2>& materials,
+                                const size_t degrees_of_freedom) {
+    for(const auto& [name, material] : materials.materials) {
+        const config::model_data<T, 2>& model = material.model;
+        if (theory_type(model.local_weight) != theory_t::NONLOCAL ||
+            model.influence != config::influence_t::NORMAL_DISTRIBUTION || model.truncation_tolerance == T{0})
+            continue;
+        std::vector<bool> is_group_node(mesh.container().nodes_count(), false);
+        for(const size_t e : mesh.container().elements(name))
+            for(const size_t i : std::ranges::iota_view{0u, mesh.container().element_2d(e).nodes_count()})
+                is_group_node[mesh.container().node_number(e, i)] = true;
+        const size_t nodes_count = std::count(is_group_node.begin(), is_group_node.end(), true);
+        const std::array<T, 2> radius = model.truncation_radius();
+        const T row_nodes = std::min(T(nodes_count), nodes_count / mesh.area(name) * std::numbers::pi_v<T> * radius[X] * radius[Y]);
+        std::cout << "Group \"" << name << "\": normal distribution is truncated with the tolerance " << model.truncation_tolerance
+                  << " at the radius [" << radius[X] << ", " << radius[Y] << "], the estimated number of the nonlocal nonzero elements is "
+                  << size_t(nodes_count * row_nodes * degrees_of_freedom * degrees_of_freedom) << std::endl;
+    }
+}
+
 }
 
 #endif
\ No newline at end of file
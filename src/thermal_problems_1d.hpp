@@ -17,7 +17,7 @@ parameters_1d<T> make_thermal_parameters(
     for(const size_t i : std::ranges::iota_view{0u, parameters.size()})
         parameters[i] = {
             .model = {
-                .influence = influence::polynomial_1d<T, 1, 1>{materials[i].model.nonlocal_radius},
+                .influence = make_influence(materials[i].model),
                 .local_weight = materials[i].model.local_weight
             },
             .physical = std::make_shared<parameter_1d<T, coefficients_t::CONSTANTS>>(
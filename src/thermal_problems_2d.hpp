@@ -16,8 +16,9 @@ parameters_2d<T> make_parameters(const config::thermal_materials_2d<T>& material
     for(const auto& [name, material] : materials.materials) {
         auto& parameter = parameters[name] = {
             .model = {
-                .influence = influence::polynomial_2d<T, 2, 1>{material.model.nonlocal_radius},
-                .local_weight = material.model.local_weight
+                .influence = make_influence(material.model),
+                .local_weight = material.model.local_weight,
+                .quadrature_tolerance = material.model.quadrature_tolerance
             },
             .physical = std::make_shared<parameter_2d<T, coefficients_t::CONSTANTS>>(
                 metamath::types::make_square_matrix<T, 2u>(material.physical.conductivity),
@@ -79,27 +80,67 @@ void save_solution(heat_equation_solution_2d<T, I>&& solution,
     );
 }
 
+template<std::floating_point T, std::signed_integral I>
+void find_thermal_2d_neighbours(mesh::mesh_2d<T, I>& mesh, const nlohmann::json& config) {
+    const config::thermal_materials_2d<T> materials{config["materials"], "materials"};
+    print_truncation_estimates(mesh, materials, 1);
+    mesh.find_neighbours(get_search_radii(materials), get_influence_supports(materials));
+}
+
+// The materials of the config are constant, so the matrices of all solvers are symmetric
+// and their portraits are bounded by the one with the integral condition
+template<std::floating_point T, std::signed_integral I>
+size_t thermal_2d_nonzeros_count(const std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const nlohmann::json& config) {
+    static constexpr bool SYMMETRIC = true;
+    static constexpr bool NEUMANN = true;
+    const config::thermal_materials_2d<T> materials{config["materials"], "materials"};
+    const auto boundaries_conditions = make_boundaries_conditions(
+        config::thermal_boundaries_conditions_2d<T>{config["boundaries"], "boundaries"});
+    thermal_conductivity_matrix_2d<T, I, I> conductivity{mesh};
+    return conductivity.nonzeros_count(make_parameters(materials), utils::inner_nodes(mesh->container(), boundaries_conditions),
+                                       SYMMETRIC, NEUMANN);
+}
+
+// Must be called after find_thermal_2d_neighbours
 template<std::floating_point T, std::signed_integral I>
 void solve_thermal_2d_problem(
-    std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const nlohmann::json& config, 
+    std::shared_ptr<mesh::mesh_2d<T, I>>& mesh, const config::mesh_data<2u>& mesh_data, const nlohmann::json& config,
     const config::save_data& save, const bool time_dependency) {
     const config::thermal_materials_2d<T> materials{config["materials"], "materials"};
-    mesh->find_neighbours(get_search_radii(materials));
     const auto parameters = make_parameters(materials);
     const auto auxiliary = config::thermal_auxiliary_data<T>{config.value("auxiliary", nlohmann::json::object()), "auxiliary"};
+    const auto solver = config::solver_data<T>{config.value("solver", nlohmann::json::object()), "solver"};
     const auto boundaries_conditions = make_boundaries_conditions(
         config::thermal_boundaries_conditions_2d<T>{config["boundaries"], "boundaries"});
+    if (solver.dry_run) {
+        static constexpr assembly_costs<T> COSTS = {.evaluation = T{60}, .nonzero = T{400}};
+        static constexpr bool HAS_MATRIX_FREE = true;
+        thermal_conductivity_matrix_2d<T, I, I> conductivity{mesh};
+        print_assembly_plan<T, I>(conductivity.plan(parameters, utils::inner_nodes(mesh->container(), boundaries_conditions)),
+                                  solver, COSTS, HAS_MATRIX_FREE && !time_dependency);
+        return;
+    }
+    if (solver.quadrature_neighbours)
+        mesh->find_quadrature_neighbours(get_influences(materials));
+    reduce_tables_precision(*mesh, mesh_data, [&mesh, &parameters, &boundaries_conditions] {
+        thermal_conductivity_matrix_2d<T, I, I> conductivity{mesh};
+        conductivity.compute(parameters, utils::inner_nodes(mesh->container(), boundaries_conditions));
+        return std::array{std::move(conductivity.matrix_inner()), std::move(conductivity.matrix_bound())};
+    });
     if (!time_dependency) {
         auto solution = nonlocal::thermal::stationary_heat_equation_solver_2d<I>(
             mesh, parameters, boundaries_conditions, 
             [value = auxiliary.right_part](const std::array<T, 2>& x) constexpr noexcept { return value; },
-            auxiliary.energy
+            auxiliary.energy,
+            get_hierarchical_parameters(solver),
+            get_conjugate_gradient_parameters(solver),
+            get_out_of_core_parameters(solver)
         );
         save_solution(std::move(solution), save);
     } else {
         config::check_required_fields(config, {"time"});
         const config::time_data<T> time{config["time"], "time"};
-        nonstationary_heat_equation_solver_2d<T, I, int64_t> solver{mesh, time.time_step};
+        nonstationary_heat_equation_solver_2d<T, I, I> solver{mesh, time.time_step};
         solver.compute(parameters, boundaries_conditions,
             [init_dist = auxiliary.initial_distribution](const std::array<T, 2>& x) constexpr noexcept { return init_dist; });
         save_solution(nonlocal::thermal::heat_equation_solution_2d<T, I>{mesh, parameters, solver.temperature()}, save, 0u);
@@ -21,12 +21,16 @@ auto reverse_conversion(const nlohmann::json& config) {
 }
     
 const suite _ = [] {
-    const nlohmann::json config = nlohmann::json::parse(reverse_conversion_json_data);
+    const nlohmann::json config = nlohmann::json::parse(std::string_view{reverse_conversion_json_data, reverse_conversion_json_size});
     test("save") = reverse_conversion<save_data>(config["save"]);
     test("save_with_precision") = reverse_conversion<save_data>(config["save_with_precision"]);
     test("mesh_1d") = reverse_conversion<mesh_data<1>>(config["mesh_1d"]);
     test("mesh_2d") = reverse_conversion<mesh_data<2>>(config["mesh_2d"]);
+    test("mesh_2d_quadratures") = reverse_conversion<mesh_data<2>>(config["mesh_2d_quadratures"]);
     test("time") = reverse_conversion<time_data<double>>(config["time"]);
+    test("hierarchical") = reverse_conversion<hierarchical_data<double>>(config["hierarchical"]);
+    test("out_of_core") = reverse_conversion<out_of_core_data>(config["out_of_core"]);
+    test("solver") = reverse_conversion<solver_data<double>>(config["solver"]);
     test("boundaries_conditions_1d") = reverse_conversion<boundaries_conditions_data<mock_data, double, 1>>(config["boundaries_conditions_1d"]);
     test("boundaries_conditions_2d") = reverse_conversion<boundaries_conditions_data<mock_data, double, 2>>(config["boundaries_conditions_2d"]);
     test("model_1d") = reverse_conversion<model_data<double, 1>>(config["model_1d"]);
@@ -0,0 +1,51 @@
+#include "init_elements.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+using namespace boost::ut;
+using namespace metamath::finite_element;
+
+template<class Tables, class T>
+void check_tables(const element_2d_integrate_base<T>& element, const std::string& suffix) {
+    test("sizes" + suffix) = [&element] {
+        expect(eq(element.nodes_count(), Tables::nodes_count)) << "Unexpected nodes count.";
+        expect(eq(element.qnodes_count(), Tables::qnodes_count)) << "Unexpected qnodes count.";
+    };
+
+    test("weights" + suffix) = [&element] {
+        for(const size_t q : element.qnodes())
+            expect(eq(element.weight(q), Tables::weights[q])) << "Unexpected weight " + std::to_string(q) + '.';
+    };
+
+    test("basis" + suffix) = [&element] {
+        for(const size_t i : element.nodes())
+            for(const size_t q : element.qnodes()) {
+                const size_t index = i * Tables::qnodes_count + q;
+                const std::string message = " of function " + std::to_string(i) + " at qnode " + std::to_string(q) + '.';
+                expect(eq(element.qN(i, q), Tables::qN[index])) << "Unexpected value" + message;
+                expect(eq(element.qNxi(i, q), Tables::qNxi[index])) << "Unexpected Nxi" + message;
+                expect(eq(element.qNeta(i, q), Tables::qNeta[index])) << "Unexpected Neta" + message;
+            }
+    };
+
+    test("nearest_qnodes" + suffix) = [&element] {
+        for(const size_t i : element.nodes())
+            expect(eq(element.nearest_qnode(i), Tables::nearest_qnode[i])) << "Unexpected nearest qnode of node " + std::to_string(i) + '.';
+    };
+}
+
+const suite _ = [] {
+    test("element_2d_tables") = []<class T> {
+        const auto elements = unit_tests::init_tabulated_elements_2d<T>();
+        const std::string suffix = '_' + std::string{reflection::type_name<T>()};
+        check_tables<element_2d_tables<T, dunavant<T, 1>, triangle, 1>>(*elements[0], "_triangle_1" + suffix);
+        check_tables<element_2d_tables<T, dunavant<T, 2>, triangle, 2>>(*elements[1], "_triangle_2" + suffix);
+        check_tables<element_2d_tables<T, gauss<T, 2>, serendipity, 1>>(*elements[2], "_serendipity_1" + suffix);
+        check_tables<element_2d_tables<T, gauss<T, 3>, serendipity, 2>>(*elements[3], "_serendipity_2" + suffix);
+        check_tables<element_2d_tables<T, gauss<T, 3>, lagrangian_element_2d, 2, 2>>(*elements[4], "_lagrangian_2_2" + suffix);
+    } | std::tuple<double>{};
+};
+
+}
\ No newline at end of file
@@ -19,6 +19,11 @@ std::vector<std::unique_ptr<metamath::finite_element::element_2d_integrate_base<
 template<class T>
 std::vector<std::unique_ptr<metamath::finite_element::element_2d_integrate_base<T>>> init_lagrangian_elements_2d();
 
+// Triangles of the orders 1 and 2, serendipity elements of the orders 1 and 2 and the quadratic lagrangian element
+// with the quadratures of the tables element_2d_tables computed at compile time
+template<class T>
+std::vector<std::unique_ptr<metamath::finite_element::element_2d_integrate_base<T>>> init_tabulated_elements_2d();
+
 }
 
 #endif
\ No newline at end of file
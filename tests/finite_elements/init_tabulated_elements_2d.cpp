@@ -0,0 +1,40 @@
+#include "init_elements.hpp"
+
+namespace {
+
+using namespace metamath::finite_element;
+
+template<class T, size_t Quadrature_Order, template<class, auto...> class Element_Type, auto... Args>
+std::unique_ptr<element_2d_integrate_base<T>> make_element() {
+    return std::make_unique<element_2d_integrate<T, Element_Type, Args...>>(
+        quadrature_1d<T, gauss, Quadrature_Order>{},
+        quadrature_1d<T, gauss, Quadrature_Order>{}
+    );
+}
+
+template<class T, size_t Degree, template<class, auto...> class Element_Type, auto... Args>
+std::unique_ptr<element_2d_integrate_base<T>> make_triangle() {
+    return std::make_unique<element_2d_integrate<T, Element_Type, Args...>>(quadrature_2d<T, dunavant, Degree>{});
+}
+
+template<class T>
+std::vector<std::unique_ptr<element_2d_integrate_base<T>>> init() {
+    std::vector<std::unique_ptr<element_2d_integrate_base<T>>> result;
+    result.emplace_back(make_triangle<T, 1, triangle, 1>());
+    result.emplace_back(make_triangle<T, 2, triangle, 2>());
+    result.emplace_back(make_element<T, 2, serendipity, 1>());
+    result.emplace_back(make_element<T, 3, serendipity, 2>());
+    result.emplace_back(make_element<T, 3, lagrangian_element_2d, 2, 2>());
+    return result;
+}
+
+}
+
+namespace unit_tests {
+
+template<>
+std::vector<std::unique_ptr<element_2d_integrate_base<double>>> init_tabulated_elements_2d() {
+    return init<double>();
+}
+
+}
\ No newline at end of file
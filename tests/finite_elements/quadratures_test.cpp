@@ -21,6 +21,23 @@ std::array<std::unique_ptr<quadrature_1d_base<T>>, 5> init_quadratures() {
     };
 }
 
+template<class T>
+std::array<std::unique_ptr<quadrature_2d_base<T>>, 5> init_triangle_quadratures() {
+    return {
+        std::make_unique<quadrature_2d<T, dunavant, 1>>(),
+        std::make_unique<quadrature_2d<T, dunavant, 2>>(),
+        std::make_unique<quadrature_2d<T, dunavant, 3>>(),
+        std::make_unique<quadrature_2d<T, dunavant, 4>>(),
+        std::make_unique<quadrature_2d<T, dunavant, 5>>()
+    };
+}
+
+// The integral of x^a y^b over the reference triangle is a! b! / (a + b + 2)!
+template<class T>
+T monomial_integral(const size_t a, const size_t b) {
+    return std::tgamma(T(a + 1)) * std::tgamma(T(b + 1)) / std::tgamma(T(a + b + 3));
+}
+
 const suite _ = [] {
     test("gauss_quadratures_1d") = []<class T> {
         size_t order = 1;
@@ -50,6 +67,36 @@ const suite _ = [] {
             ++order;
         }
     } | std::tuple<double>{};
+
+    test("dunavant_quadratures_2d") = []<class T> {
+        size_t degree = 1;
+        for(const auto& quadrature : init_triangle_quadratures<T>()) {
+            const std::string suffix = "_degree_" + std::to_string(degree) + '_' + std::string{reflection::type_name<T>()};
+
+            test("nodes_inside" + suffix) = [&quadrature] {
+                for(const size_t q : quadrature->nodes()) {
+                    const auto& [x, y] = quadrature->node(q);
+                    expect(x > T{0} && y > T{0} && x + y < T{1}) << "The node " + std::to_string(q) + " is outside the triangle.";
+                }
+            };
+
+            test("exactness" + suffix) = [&quadrature, degree] {
+                static constexpr T epsilon = std::is_same_v<T, float> ? T{1e-6} : T{1e-15};
+                for(const size_t a : std::ranges::iota_view{0u, degree + 1})
+                    for(const size_t b : std::ranges::iota_view{0u, degree + 1 - a}) {
+                        T integral = T{0};
+                        for(const size_t q : quadrature->nodes()) {
+                            const auto& [x, y] = quadrature->node(q);
+                            integral += quadrature->weight(q) * std::pow(x, a) * std::pow(y, b);
+                        }
+                        expect(lt(std::abs(integral - monomial_integral<T>(a, b)), epsilon))
+                            << "Unexpected integral of x^" + std::to_string(a) + " y^" + std::to_string(b) + '.';
+                    }
+            };
+
+            ++degree;
+        }
+    } | std::tuple<double>{};
 };
 
 }
\ No newline at end of file
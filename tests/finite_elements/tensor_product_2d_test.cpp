@@ -0,0 +1,95 @@
+#include "init_elements.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+using namespace boost::ut;
+using namespace metamath::finite_element;
+
+template<class T>
+void check_interpolation(const element_2d_integrate_base<T>& element, const std::string& suffix) {
+    test("interpolation" + suffix) = [&element] {
+        const auto values = [](const size_t i) { return T(i * i) - T{0.5} * T(i) + T{1}; };
+        std::vector<T> value(element.qnodes_count()), dxi(element.qnodes_count()), deta(element.qnodes_count());
+        element.tensor_product()->interpolate(values, value, dxi, deta);
+        for(const size_t q : element.qnodes()) {
+            T expected_value = T{0}, expected_dxi = T{0}, expected_deta = T{0};
+            for(const size_t i : element.nodes()) {
+                expected_value += values(i) * element.qN(i, q);
+                expected_dxi += values(i) * element.qNxi(i, q);
+                expected_deta += values(i) * element.qNeta(i, q);
+            }
+            static constexpr T epsilon = T{1e-12};
+            const std::string message = " at qnode " + std::to_string(q) + '.';
+            expect(lt(std::abs(value[q] - expected_value), epsilon)) << "Unexpected value" + message;
+            expect(lt(std::abs(dxi[q] - expected_dxi), epsilon)) << "Unexpected xi derivative" + message;
+            expect(lt(std::abs(deta[q] - expected_deta), epsilon)) << "Unexpected eta derivative" + message;
+        }
+    };
+}
+
+template<class T>
+void check_element_matrices(const element_2d_integrate_base<T>& element, const std::string& suffix) {
+    test("element_matrices" + suffix) = [&element] {
+        const auto stiffness_coefficients = [](const size_t q) {
+            return std::array{std::array{T{1} + T(q), T{0.5}}, std::array{T{0.25}, T{2} + T{0.1} * T(q)}};
+        };
+        const auto mass_coefficients = [](const size_t q) { return T{1} + T{0.5} * T(q); };
+        const size_t nodes_count = element.nodes_count();
+        std::vector<T> stiffness(nodes_count * nodes_count), mass(nodes_count * nodes_count);
+        element.tensor_product()->stiffness(stiffness_coefficients, stiffness);
+        element.tensor_product()->mass(mass_coefficients, mass);
+        for(const size_t i : element.nodes())
+            for(const size_t j : element.nodes()) {
+                T expected_stiffness = T{0}, expected_mass = T{0};
+                for(const size_t q : element.qnodes()) {
+                    const auto G = stiffness_coefficients(q);
+                    const std::array<T, 2> dNi = {element.qNxi(i, q), element.qNeta(i, q)};
+                    const std::array<T, 2> dNj = {element.qNxi(j, q), element.qNeta(j, q)};
+                    for(const size_t k : std::ranges::iota_view{0u, 2u})
+                        for(const size_t l : std::ranges::iota_view{0u, 2u})
+                            expected_stiffness += dNi[k] * G[k][l] * dNj[l];
+                    expected_mass += mass_coefficients(q) * element.qN(i, q) * element.qN(j, q);
+                }
+                static constexpr T epsilon = T{1e-11};
+                const std::string message = " at (" + std::to_string(i) + ", " + std::to_string(j) + ").";
+                expect(lt(std::abs(stiffness[i * nodes_count + j] - expected_stiffness), epsilon)) << "Unexpected stiffness" + message;
+                expect(lt(std::abs(mass[i * nodes_count + j] - expected_mass), epsilon)) << "Unexpected mass" + message;
+            }
+    };
+}
+
+const suite _ = [] {
+    test("tensor_product_2d") = []<class T> {
+        const std::string suffix = '_' + std::string{reflection::type_name<T>()};
+        const auto lagrangian = unit_tests::init_lagrangian_elements_2d<T>();
+        for(const size_t i : std::ranges::iota_view{0u, lagrangian.size()}) {
+            expect(lagrangian[i]->tensor_product().has_value()) << "The lagrangian element " + std::to_string(i) + " is tensor product.";
+            if (lagrangian[i]->tensor_product())
+                check_interpolation(*lagrangian[i], "_lagrangian_" + std::to_string(i) + suffix);
+            if (lagrangian[i]->tensor_product())
+                check_element_matrices(*lagrangian[i], "_lagrangian_" + std::to_string(i) + suffix);
+        }
+
+        const auto serendipity = unit_tests::init_serendipity_elements_2d<T>();
+        for(const size_t order : std::ranges::iota_view{0u, serendipity.size()})
+            expect(eq(serendipity[order]->tensor_product().has_value(), order < 2))
+                << "Only the serendipity elements of the orders 0 and 1 are tensor product.";
+        check_interpolation(*serendipity[1], "_bilinear" + suffix);
+        check_element_matrices(*serendipity[1], "_bilinear" + suffix);
+
+        const auto triangles = unit_tests::init_triangle_elements_2d<T>();
+        for(const size_t order : std::ranges::iota_view{1u, triangles.size()})
+            expect(!triangles[order]->tensor_product().has_value()) << "Nonconstant triangles are not tensor product.";
+
+        const auto tabulated = unit_tests::init_tabulated_elements_2d<T>();
+        for(const size_t i : std::ranges::iota_view{0u, tabulated.size()})
+            expect(eq(tabulated[i]->tensor_product().has_value(), i == 2 || i == 4))
+                << "Only the tabulated bilinear and quadratic lagrangian elements are tensor product.";
+        check_interpolation(*tabulated[4], "_tabulated_lagrangian" + suffix);
+        check_element_matrices(*tabulated[4], "_tabulated_lagrangian" + suffix);
+    } | std::tuple<double>{};
+};
+
+}
\ No newline at end of file
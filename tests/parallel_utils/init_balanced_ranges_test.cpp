@@ -0,0 +1,51 @@
+#include "init_balanced_ranges.hpp"
+
+#include <boost/ut.hpp>
+
+#include <array>
+
+namespace {
+
+const boost::ut::suite _ = [] {
+    using namespace boost::ut;
+    using namespace parallel_utils;
+
+    static constexpr std::array<int, 7> SHIFTS = {0, 4, 5, 6, 7, 8, 12};
+    static constexpr size_t SIZE = SHIFTS.size() - 1;
+
+    "balanced_ranges_count_0"_test = [] {
+        expect(throws([] { init_balanced_ranges(std::span<const int>{SHIFTS}, 0u); })) <<
+            "When creating 0 ranges, an exception should be thrown.";
+    };
+
+    for(const size_t count : std::ranges::iota_view{1u, SIZE + 2})
+        test("balanced_ranges_cover_" + std::to_string(count)) = [count] {
+            const auto ranges = init_balanced_ranges(std::span<const int>{SHIFTS}, count);
+            expect(eq(ranges.size(), count)) << "Unexpected ranges number.";
+            size_t left_bound = 0;
+            for(const auto& range : ranges) {
+                expect(eq(*range.begin(), left_bound)) << "The ranges must follow each other.";
+                left_bound = *range.end();
+            }
+            expect(eq(left_bound, SIZE)) << "The ranges must cover all rows.";
+        };
+
+    "balanced_ranges_3"_test = [] {
+        const auto ranges = init_balanced_ranges(std::span<const int>{SHIFTS}, 3u);
+        expect(eq(*ranges[0].begin(), 0u));
+        expect(eq(*ranges[0].end(),   1u));
+        expect(eq(*ranges[1].begin(), 1u));
+        expect(eq(*ranges[1].end(),   5u));
+        expect(eq(*ranges[2].begin(), 5u));
+        expect(eq(*ranges[2].end(),   SIZE));
+    };
+
+    "balanced_ranges_empty"_test = [] {
+        static constexpr std::array<int, 4> EMPTY = {0, 0, 0, 0};
+        const auto ranges = init_balanced_ranges(std::span<const int>{EMPTY}, 2u);
+        expect(eq(*ranges[0].end(), 0u));
+        expect(eq(*ranges[1].end(), EMPTY.size() - 1));
+    };
+};
+
+}
\ No newline at end of file
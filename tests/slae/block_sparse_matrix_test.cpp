@@ -0,0 +1,73 @@
+#include "block_sparse_matrix.hpp"
+
+#include <boost/ut.hpp>
+
+#include <cmath>
+
+namespace {
+
+using T = double;
+using I = int;
+
+Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper_matrix() {
+    // The blocks are filled partially, the last block row has only the diagonal block
+    const std::vector<Eigen::Triplet<T, I>> triplets = {
+        {0, 0, 4}, {0, 1, 1}, {0, 3, 2}, {0, 6, -1},
+        {1, 1, 5}, {1, 2, 3}, {1, 7, 2},
+        {2, 2, 6}, {2, 3, -2},
+        {3, 3, 7}, {3, 5, 1},
+        {4, 4, 8},
+        {5, 5, 9}, {5, 7, 4},
+        {6, 6, 3},
+        {7, 7, 2}
+    };
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(8, 8);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+const boost::ut::suite _ = [] {
+    using namespace boost::ut;
+    using namespace nonlocal::slae;
+
+    "block_sparse_matrix_odd_size"_test = [] {
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(3, 3);
+        expect(throws([&matrix] { block_sparse_matrix<T, I, 2>{matrix}; })) <<
+            "When the size is not a multiple of the block size, an exception should be thrown.";
+    };
+
+    "block_sparse_matrix_portrait"_test = [] {
+        const block_sparse_matrix<T, I, 2> matrix{upper_matrix()};
+        expect(eq(matrix.rows(), 4u));
+        expect(eq(matrix.blocks_count(), 8u));
+        const std::array<I, 5> shifts = {0, 3, 5, 7, 8};
+        const std::array<I, 8> indices = {0, 1, 3, 1, 2, 2, 3, 3};
+        expect(std::ranges::equal(matrix.shifts(), shifts)) << "Unexpected block shifts.";
+        expect(std::ranges::equal(matrix.indices(), indices)) << "Unexpected block indices.";
+        const std::array<T, 4> diagonal = {4, 1, 1, 5};
+        expect(std::ranges::equal(matrix.block(0), diagonal)) << "The diagonal block must be stored in full.";
+    };
+
+    "block_sparse_matrix_to_sparse"_test = [] {
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> expected = upper_matrix();
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> converted = block_sparse_matrix<T, I, 2>{expected}.to_sparse();
+        expect(eq(converted.nonZeros(), 28)) << "The blocks must be converted with their zeros.";
+        expect(converted.toDense() == expected.toDense()) << "The conversion must restore the matrix.";
+    };
+
+    for(const size_t threads : std::ranges::iota_view{1u, 5u})
+        test("block_sparse_matrix_product_" + std::to_string(threads)) = [threads] {
+            const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix();
+            const block_sparse_matrix<T, I, 2> matrix{upper, threads};
+            const Eigen::Matrix<T, Eigen::Dynamic, 1> p = Eigen::Matrix<T, Eigen::Dynamic, 1>::LinSpaced(8, 1, 8);
+            const Eigen::Matrix<T, Eigen::Dynamic, 1> expected = upper.selfadjointView<Eigen::Upper>() * p;
+            Eigen::Matrix<T, Eigen::Dynamic, 1> z;
+            for(const size_t repeat : std::ranges::iota_view{0u, 2u}) {
+                matrix.product(z, p);
+                expect(eq(z.size(), expected.size()));
+                expect(lt((z - expected).template lpNorm<Eigen::Infinity>(), 1e-12)) << "Unexpected product on repeat " << repeat;
+            }
+        };
+};
+
+}
\ No newline at end of file
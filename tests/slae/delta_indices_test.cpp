@@ -0,0 +1,78 @@
+#include "delta_indices.hpp"
+#include "conjugate_gradient.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+using T = double;
+
+template<class I>
+Eigen::SparseMatrix<T, Eigen::RowMajor, I> general_matrix() {
+    // The deltas take one byte, the 16-bit escape and the full width escape, the first column of the row 2 is to the left of the diagonal
+    const std::vector<Eigen::Triplet<T, I>> triplets = {
+        {0, 0, 1}, {0, 1, 2}, {0, 2, 3}, {0, 300, 4}, {0, 70300, 5},
+        {1, 1, 6},
+        {2, 0, 7}, {2, 2, 8}, {2, 256, 9},
+        {70300, 70300, 10}
+    };
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(70301, 70301);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+template<class I>
+void check_decoding() {
+    using namespace boost::ut;
+    const Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix = general_matrix<I>();
+    const std::array ranges = {std::ranges::iota_view<size_t, size_t>{0u, size_t(matrix.rows())}};
+    const nonlocal::slae::delta_indices<I> indices{matrix, ranges};
+    expect(eq(indices.rows(), size_t(matrix.rows())));
+    expect(lt(indices.bytes(), sizeof(size_t) * (matrix.rows() + 1) + matrix.nonZeros() * sizeof(I))) << "The indices must be compressed.";
+    bool is_equal = true;
+    for(const size_t row : std::ranges::iota_view{0u, size_t(matrix.rows())})
+        if (matrix.outerIndexPtr()[row] < matrix.outerIndexPtr()[row + 1]) {
+            auto decoder = indices.row(row);
+            is_equal = is_equal && decoder.first() == matrix.innerIndexPtr()[matrix.outerIndexPtr()[row]];
+            for(I i = matrix.outerIndexPtr()[row] + 1; i < matrix.outerIndexPtr()[row + 1]; ++i)
+                is_equal = is_equal && decoder.next() == matrix.innerIndexPtr()[i];
+        }
+    expect(is_equal) << "The decoded columns must be equal to the original ones.";
+}
+
+const boost::ut::suite _ = [] {
+    using namespace boost::ut;
+    using namespace nonlocal::slae;
+
+    "delta_indices_int"_test = [] { check_decoding<int>(); };
+    "delta_indices_long"_test = [] { check_decoding<long>(); };
+
+    "delta_indices_unsorted"_test = [] {
+        Eigen::SparseMatrix<T, Eigen::RowMajor, int> matrix = general_matrix<int>();
+        std::swap(matrix.innerIndexPtr()[0], matrix.innerIndexPtr()[1]);
+        const std::array ranges = {std::ranges::iota_view<size_t, size_t>{0u, size_t(matrix.rows())}};
+        expect(throws([&matrix, &ranges] { delta_indices<int>{matrix, ranges}; })) <<
+            "When the columns are not sorted, an exception should be thrown.";
+    };
+
+    for(const int threads : std::ranges::iota_view{1, 4})
+        test("delta_indices_conjugate_gradient_" + std::to_string(threads)) = [threads] {
+            Eigen::SparseMatrix<T, Eigen::RowMajor, int> matrix(300, 300);
+            std::vector<Eigen::Triplet<T, int>> triplets;
+            for(const int row : std::ranges::iota_view{0, 300}) {
+                triplets.emplace_back(row, row, T{300});
+                for(const int col : {row + 1, row + 2, row + 299})
+                    if (col < 300)
+                        triplets.emplace_back(row, col, T{-1});
+            }
+            matrix.setFromTriplets(triplets.begin(), triplets.end());
+            const Eigen::Matrix<T, Eigen::Dynamic, 1> b = Eigen::Matrix<T, Eigen::Dynamic, 1>::LinSpaced(300, 1, 300);
+            const conjugate_gradient<T, int> csr{matrix, {.threads_count = threads, .sliced_ellpack_padding = std::nullopt}};
+            const conjugate_gradient<T, int> compressed{matrix, {.threads_count = threads, .sliced_ellpack_padding = std::nullopt,
+                                                                 .compressed_indices = true}};
+            expect(!csr.compressed_indices() && compressed.compressed_indices().has_value());
+            expect(lt((csr.solve(b) - compressed.solve(b)).template lpNorm<Eigen::Infinity>(), 1e-12)) << "The solutions must be equal.";
+        };
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "mapped_sparse_matrix.hpp"
+#include "conjugate_gradient.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+using T = double;
+using I = int;
+
+// The band is wide enough for the blocks to span several pages, so the released pages are read again
+Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper_matrix(const size_t size, const size_t band) {
+    std::vector<Eigen::Triplet<T, I>> triplets;
+    for(const size_t row : std::ranges::iota_view{0u, size})
+        for(const size_t col : std::ranges::iota_view{row, std::min(row + band, size)})
+            triplets.emplace_back(row, col, row == col ? T(2 * band) : T(1) / (1 + row + col));
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(size, size);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+const boost::ut::suite _ = [] {
+    using namespace boost::ut;
+    using namespace nonlocal::slae;
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "mapped_sparse_matrix_test.bin";
+
+    for(const size_t threads : std::ranges::iota_view{1u, 4u})
+        for(const size_t block_bytes : {size_t{1}, size_t{1} << 12, size_t{1} << 30})
+            test("mapped_sparse_matrix_product_" + std::to_string(threads) + '_' + std::to_string(block_bytes)) = [&path, threads, block_bytes] {
+                const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix(2000, 20);
+                const Eigen::SparseMatrix<T, Eigen::RowMajor, I> full = upper.selfadjointView<Eigen::Upper>();
+                const Eigen::Matrix<T, Eigen::Dynamic, 1> p = Eigen::Matrix<T, Eigen::Dynamic, 1>::LinSpaced(upper.rows(), -1, 1);
+                const Eigen::Matrix<T, Eigen::Dynamic, 1> expected = full * p;
+                const out_of_core_parameters parameters{.path = path, .block_bytes = block_bytes};
+                mapped_sparse_matrix<T, I>::write(upper, parameters);
+                const mapped_sparse_matrix<T, I> matrix{parameters, threads};
+                expect(eq(matrix.rows(), size_t(upper.rows())));
+                expect(eq(matrix.nonzeros(), size_t(upper.nonZeros())));
+                if (block_bytes == 1)
+                    expect(eq(matrix.blocks_count(), size_t(upper.rows()))) << "Each row must be in its own block.";
+                Eigen::Matrix<T, Eigen::Dynamic, 1> z;
+                for(const size_t repeat : std::ranges::iota_view{0u, 2u}) {
+                    matrix.product(z, p);
+                    expect(lt((z - expected).template lpNorm<Eigen::Infinity>(), 1e-12)) << "Unexpected product, repeat " << repeat;
+                }
+            };
+
+    "mapped_sparse_matrix_conjugate_gradient"_test = [&path] {
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix(500, 10);
+        const Eigen::Matrix<T, Eigen::Dynamic, 1> b = Eigen::Matrix<T, Eigen::Dynamic, 1>::Ones(upper.rows());
+        const out_of_core_parameters parameters{.path = path, .block_bytes = size_t{1} << 12};
+        mapped_sparse_matrix<T, I>::write(upper, parameters);
+        const mapped_sparse_matrix<T, I> matrix{parameters};
+        const conjugate_gradient<T, I> in_memory{upper};
+        const operator_conjugate_gradient<T, mapped_sparse_matrix<T, I>> out_of_core{matrix};
+        expect(lt((in_memory.solve(b) - out_of_core.solve(b)).template lpNorm<Eigen::Infinity>(), 1e-12)) << "The solutions must be equal.";
+    };
+
+    "mapped_sparse_matrix_wrong_type"_test = [&path] {
+        const out_of_core_parameters parameters{.path = path};
+        mapped_sparse_matrix<T, I>::write(upper_matrix(10, 2), parameters);
+        expect(throws([&parameters] { mapped_sparse_matrix<float, I>{parameters}; })) << "The values size must be checked.";
+        expect(throws([&parameters] { mapped_sparse_matrix<T, long>{parameters}; })) << "The indices size must be checked.";
+        std::filesystem::remove(path);
+    };
+};
+
+}
\ No newline at end of file
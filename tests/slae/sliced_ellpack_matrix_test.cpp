@@ -0,0 +1,67 @@
+#include "sliced_ellpack_matrix.hpp"
+#include "conjugate_gradient.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+using T = double;
+using I = int;
+
+Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper_matrix() {
+    // The full rows have the lengths 3, 1, 3, 2, 2, so the sorting in the window shortens the chunks
+    const std::vector<Eigen::Triplet<T, I>> triplets = {
+        {0, 0, 4}, {0, 2, 1}, {0, 3, -1},
+        {1, 1, 5},
+        {2, 2, 6}, {2, 4, 2},
+        {3, 3, 7},
+        {4, 4, 8}
+    };
+    Eigen::SparseMatrix<T, Eigen::RowMajor, I> matrix(5, 5);
+    matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return matrix;
+}
+
+const boost::ut::suite _ = [] {
+    using namespace boost::ut;
+    using namespace nonlocal::slae;
+
+    "sliced_ellpack_matrix_padding"_test = [] {
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix();
+        expect(eq(sliced_ellpack_matrix<T, I, 2>::padding(upper, true, 1), T{5} / 11)) << "Unexpected padding without sorting.";
+        expect(eq(sliced_ellpack_matrix<T, I, 2>::padding(upper, true, 5), T{1} / 11)) << "Unexpected padding with sorting.";
+        expect(eq(sliced_ellpack_matrix<T, I, 1>::padding(upper, true, 1), T{0})) << "Chunks of the single row must be without padding.";
+        const sliced_ellpack_matrix<T, I, 2> matrix{upper, true, 5};
+        expect(eq(matrix.nonzeros(), 11u));
+        expect(eq(matrix.stored(), 12u));
+        expect(eq(matrix.chunks_count(), 3u));
+        expect(eq(matrix.padding(), T{1} / 11));
+    };
+
+    for(const size_t threads : std::ranges::iota_view{1u, 4u})
+        for(const size_t sigma : {1u, 2u, 5u})
+            test("sliced_ellpack_matrix_product_" + std::to_string(threads) + '_' + std::to_string(sigma)) = [threads, sigma] {
+                const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix();
+                const Eigen::SparseMatrix<T, Eigen::RowMajor, I> full = upper.selfadjointView<Eigen::Upper>();
+                const Eigen::Matrix<T, Eigen::Dynamic, 1> p = Eigen::Matrix<T, Eigen::Dynamic, 1>::LinSpaced(5, 1, 5);
+                const Eigen::Matrix<T, Eigen::Dynamic, 1> expected = full * p;
+                Eigen::Matrix<T, Eigen::Dynamic, 1> z;
+                sliced_ellpack_matrix<T, I, 2>{upper, true, sigma, threads}.product(z, p);
+                expect(lt((z - expected).template lpNorm<Eigen::Infinity>(), 1e-12)) << "Unexpected symmetric product.";
+                sliced_ellpack_matrix<T, I, 4>{full, false, sigma, threads}.product(z, p);
+                expect(lt((z - expected).template lpNorm<Eigen::Infinity>(), 1e-12)) << "Unexpected general product.";
+            };
+
+    "sliced_ellpack_conjugate_gradient"_test = [] {
+        const Eigen::SparseMatrix<T, Eigen::RowMajor, I> upper = upper_matrix();
+        const Eigen::Matrix<T, Eigen::Dynamic, 1> b = Eigen::Matrix<T, Eigen::Dynamic, 1>::Ones(5);
+        const conjugate_gradient<T, I> csr{upper};
+        const conjugate_gradient<T, I> sliced{upper, {.sliced_ellpack_padding = T{1}}};
+        const conjugate_gradient<T, I> rejected{upper, {.sliced_ellpack_padding = T{-1}}};
+        expect(!csr.sliced_ellpack() && sliced.sliced_ellpack() && !rejected.sliced_ellpack()) <<
+            "SELL-C-sigma must be chosen only if its padding is not greater than specified.";
+        expect(lt((csr.solve(b) - sliced.solve(b)).template lpNorm<Eigen::Infinity>(), 1e-12)) << "The solutions must be equal.";
+    };
+};
+
+}
\ No newline at end of file